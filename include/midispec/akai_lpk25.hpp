@@ -4,6 +4,7 @@
 #include <vector>
 
 #include <midispec/core/capabilities.hpp>
+#include <midispec/core/decode_result.hpp>
 #include <midispec/core/integral.hpp>
 
 namespace midispec {
@@ -28,8 +29,8 @@ struct akai_lpk25 {
     /// @param encoded Vector to read the encoded message from
     /// @param channel Target channel number. In range [0, 15]
     /// @param note MIDI note. In range [0, 127]
-    /// @return true on success
-    static bool decode_note_off(
+    /// @return Success, or the reason of the rejection
+    static decode_result decode_note_off(
         const std::vector<std::uint8_t>& encoded,
         integral<std::uint8_t, 0, 15>& channel,
         integral<std::uint8_t, 0, 127>& note);
@@ -48,8 +49,8 @@ struct akai_lpk25 {
     /// @param channel Target channel number. In range [0, 15]
     /// @param note MIDI note. In range [0, 127]
     /// @param velocity MIDI velocity. In range [0, 127]
-    /// @return true on success
-    static bool decode_note_on(
+    /// @return Success, or the reason of the rejection
+    static decode_result decode_note_on(
         const std::vector<std::uint8_t>& encoded,
         integral<std::uint8_t, 0, 15>& channel,
         integral<std::uint8_t, 0, 127>& note,
@@ -74,7 +75,7 @@ struct akai_lpk25 {
 
     /// @brief Decodes a reset message
     /// @param encoded Vector to read the encoded message from
-    /// @return true on success (message is a system reset)
-    static bool decode_reset(const std::vector<std::uint8_t>& encoded);
+    /// @return Success, or the reason of the rejection
+    static decode_result decode_reset(const std::vector<std::uint8_t>& encoded);
 };
 }
@@ -4,6 +4,7 @@
 #include <vector>
 
 #include <midispec/core/capabilities.hpp>
+#include <midispec/core/decode_result.hpp>
 #include <midispec/core/integral.hpp>
 
 namespace midispec {
@@ -26,8 +27,8 @@ struct akai_mpx8 {
     /// @param encoded Vector to read the encoded message from
     /// @param note MIDI note. In range [0, 127]
     /// @param velocity MIDI velocity. In range [0, 127]
-    /// @return true on success
-    static bool decode_note_off(
+    /// @return Success, or the reason of the rejection
+    static decode_result decode_note_off(
         const std::vector<std::uint8_t>& encoded,
         integral<std::uint8_t, 0, 127>& note,
         integral<std::uint8_t, 0, 127>& velocity);
@@ -45,8 +46,8 @@ struct akai_mpx8 {
     /// @param encoded Vector to read the encoded message from
     /// @param note MIDI note. In range [0, 127]
     /// @param velocity MIDI velocity. In range [0, 127]
-    /// @return true on success
-    static bool decode_note_on(
+    /// @return Success, or the reason of the rejection
+    static decode_result decode_note_on(
         const std::vector<std::uint8_t>& encoded,
         integral<std::uint8_t, 0, 127>& note,
         integral<std::uint8_t, 0, 127>& velocity);
@@ -55,8 +56,8 @@ struct akai_mpx8 {
     /// @param encoded Vector to read the encoded message from
     /// @param note MIDI note. In range [0, 127]
     /// @param after_touch MIDI aftertouch. In range [0, 127]
-    /// @return true on success
-    static bool decode_note_aftertouch(
+    /// @return Success, or the reason of the rejection
+    static decode_result decode_note_aftertouch(
         const std::vector<std::uint8_t>& encoded,
         integral<std::uint8_t, 0, 127>& note,
         integral<std::uint8_t, 0, 127>& aftertouch);
@@ -77,8 +78,8 @@ struct akai_mpx8 {
     /// @param family MIDI hardware family info
     /// @param model MIDI hardware model info
     /// @param version MIDI hardware version info
-    /// @return true on success
-    static bool decode_universal_inquiry(
+    /// @return Success, or the reason of the rejection
+    static decode_result decode_universal_inquiry(
         const std::vector<std::uint8_t>& encoded,
         integral<std::uint8_t, 0, 127>& device,
         std::uint32_t& manufacturer,
@@ -1,7 +1,70 @@
+#pragma once
 
+#include <array>
+#include <vector>
 
-// start
-// stop
-// continue
-// song position
-// clock
\ No newline at end of file
+#include <midispec/core/capabilities.hpp>
+#include <midispec/core/decode_result.hpp>
+#include <midispec/core/integral.hpp>
+
+namespace midispec {
+
+/// @brief MIDI support for the Akai Rhythm Wolf drum machine.
+/// To follow an external clock, set the MIDI sync setting to receive clock.
+/// To drive an external clock, set the MIDI sync setting to transmit clock
+struct akai_rythmwolf {
+
+    // system common
+
+    /// @brief Encodes a clock message
+    /// @param encoded Vector to append the encoded message to
+    static void encode_clock(std::vector<std::uint8_t>& encoded);
+
+    /// @brief Decodes a clock message
+    /// @param encoded Vector to read the encoded message from
+    /// @return Success, or the reason of the rejection
+    static decode_result decode_clock(const std::vector<std::uint8_t>& encoded);
+
+    /// @brief Encodes a start message
+    /// @param encoded Vector to append the encoded message to
+    static void encode_start(std::vector<std::uint8_t>& encoded);
+
+    /// @brief Decodes a start message
+    /// @param encoded Vector to read the encoded message from
+    /// @return Success, or the reason of the rejection
+    static decode_result decode_start(const std::vector<std::uint8_t>& encoded);
+
+    /// @brief Encodes a stop message
+    /// @param encoded Vector to append the encoded message to
+    static void encode_stop(std::vector<std::uint8_t>& encoded);
+
+    /// @brief Decodes a stop message
+    /// @param encoded Vector to read the encoded message from
+    /// @return Success, or the reason of the rejection
+    static decode_result decode_stop(const std::vector<std::uint8_t>& encoded);
+
+    /// @brief Encodes a continue message
+    /// @param encoded Vector to append the encoded message to
+    static void encode_continue(std::vector<std::uint8_t>& encoded);
+
+    /// @brief Decodes a continue message
+    /// @param encoded Vector to read the encoded message from
+    /// @return Success, or the reason of the rejection
+    static decode_result decode_continue(const std::vector<std::uint8_t>& encoded);
+
+    /// @brief Encodes a song position pointer message
+    /// @param encoded Vector to append the encoded message to
+    /// @param data MIDI song position pointer in sixteenth notes. In range [0, 16383]
+    static void encode_song_position(
+        std::vector<std::uint8_t>& encoded,
+        const integral<std::uint16_t, 0, 16383> data);
+
+    /// @brief Decodes a song position pointer message
+    /// @param encoded Vector to read the encoded message from
+    /// @param data MIDI song position pointer in sixteenth notes. In range [0, 16383]
+    /// @return Success, or the reason of the rejection
+    static decode_result decode_song_position(
+        const std::vector<std::uint8_t>& encoded,
+        integral<std::uint16_t, 0, 16383>& data);
+};
+}
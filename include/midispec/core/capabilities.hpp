@@ -4,6 +4,7 @@
 #include <utility>
 #include <vector>
 
+#include <midispec/core/decode_result.hpp>
 #include <midispec/core/integral.hpp>
 
 namespace midispec {
@@ -53,25 +54,25 @@ namespace detail {
     struct has_note_off_decode_no_velocity : std::false_type {};
 
     template <typename T>
-    struct has_note_off_decode_no_velocity<T, std::void_t<decltype(T::decode_note_off(std::declval<const std::vector<std::uint8_t>&>(), std::declval<integral<std::uint8_t, 0, 15>&>(), std::declval<integral<std::uint8_t, 0, 127>&>()))>> : std::bool_constant<std::is_same<decltype(T::decode_note_off(std::declval<const std::vector<std::uint8_t>&>(), std::declval<integral<std::uint8_t, 0, 15>&>(), std::declval<integral<std::uint8_t, 0, 127>&>())), bool>::value> {};
+    struct has_note_off_decode_no_velocity<T, std::void_t<decltype(T::decode_note_off(std::declval<const std::vector<std::uint8_t>&>(), std::declval<integral<std::uint8_t, 0, 15>&>(), std::declval<integral<std::uint8_t, 0, 127>&>()))>> : std::bool_constant<std::is_same<decltype(T::decode_note_off(std::declval<const std::vector<std::uint8_t>&>(), std::declval<integral<std::uint8_t, 0, 15>&>(), std::declval<integral<std::uint8_t, 0, 127>&>())), decode_result>::value> {};
 
     template <typename T, typename = void>
     struct has_note_off_decode_no_channel : std::false_type {};
 
     template <typename T>
-    struct has_note_off_decode_no_channel<T, std::void_t<decltype(T::decode_note_off(std::declval<const std::vector<std::uint8_t>&>(), std::declval<integral<std::uint8_t, 0, 127>&>(), std::declval<integral<std::uint8_t, 0, 127>&>()))>> : std::bool_constant<std::is_same<decltype(T::decode_note_off(std::declval<const std::vector<std::uint8_t>&>(), std::declval<integral<std::uint8_t, 0, 127>&>(), std::declval<integral<std::uint8_t, 0, 127>&>())), bool>::value> {};
+    struct has_note_off_decode_no_channel<T, std::void_t<decltype(T::decode_note_off(std::declval<const std::vector<std::uint8_t>&>(), std::declval<integral<std::uint8_t, 0, 127>&>(), std::declval<integral<std::uint8_t, 0, 127>&>()))>> : std::bool_constant<std::is_same<decltype(T::decode_note_off(std::declval<const std::vector<std::uint8_t>&>(), std::declval<integral<std::uint8_t, 0, 127>&>(), std::declval<integral<std::uint8_t, 0, 127>&>())), decode_result>::value> {};
 
     template <typename T, typename = void>
     struct has_note_off_decode_no_velocity_no_channel : std::false_type {};
 
     template <typename T>
-    struct has_note_off_decode_no_velocity_no_channel<T, std::void_t<decltype(T::decode_note_off(std::declval<const std::vector<std::uint8_t>&>(), std::declval<integral<std::uint8_t, 0, 127>&>()))>> : std::bool_constant<std::is_same<decltype(T::decode_note_off(std::declval<const std::vector<std::uint8_t>&>(), std::declval<integral<std::uint8_t, 0, 127>&>())), bool>::value> {};
+    struct has_note_off_decode_no_velocity_no_channel<T, std::void_t<decltype(T::decode_note_off(std::declval<const std::vector<std::uint8_t>&>(), std::declval<integral<std::uint8_t, 0, 127>&>()))>> : std::bool_constant<std::is_same<decltype(T::decode_note_off(std::declval<const std::vector<std::uint8_t>&>(), std::declval<integral<std::uint8_t, 0, 127>&>())), decode_result>::value> {};
 
     template <typename T, typename = void>
     struct has_note_off_decode_full : std::false_type {};
 
     template <typename T>
-    struct has_note_off_decode_full<T, std::void_t<decltype(T::decode_note_off(std::declval<const std::vector<std::uint8_t>&>(), std::declval<integral<std::uint8_t, 0, 15>&>(), std::declval<integral<std::uint8_t, 0, 127>&>(), std::declval<integral<std::uint8_t, 0, 127>&>()))>> : std::bool_constant<std::is_same<decltype(T::decode_note_off(std::declval<const std::vector<std::uint8_t>&>(), std::declval<integral<std::uint8_t, 0, 15>&>(), std::declval<integral<std::uint8_t, 0, 127>&>(), std::declval<integral<std::uint8_t, 0, 127>&>())), bool>::value> {};
+    struct has_note_off_decode_full<T, std::void_t<decltype(T::decode_note_off(std::declval<const std::vector<std::uint8_t>&>(), std::declval<integral<std::uint8_t, 0, 15>&>(), std::declval<integral<std::uint8_t, 0, 127>&>(), std::declval<integral<std::uint8_t, 0, 127>&>()))>> : std::bool_constant<std::is_same<decltype(T::decode_note_off(std::declval<const std::vector<std::uint8_t>&>(), std::declval<integral<std::uint8_t, 0, 15>&>(), std::declval<integral<std::uint8_t, 0, 127>&>(), std::declval<integral<std::uint8_t, 0, 127>&>())), decode_result>::value> {};
 
     template <typename T>
     struct has_note_off_decode : std::bool_constant<has_note_off_decode_no_velocity<T>::value || has_note_off_decode_no_channel<T>::value || has_note_off_decode_no_velocity_no_channel<T>::value || has_note_off_decode_full<T>::value> {};
@@ -112,19 +113,19 @@ namespace detail {
     struct has_note_on_decode_no_velocity : std::false_type {};
 
     template <typename T>
-    struct has_note_on_decode_no_velocity<T, std::void_t<decltype(T::decode_note_on(std::declval<const std::vector<std::uint8_t>&>(), std::declval<integral<std::uint8_t, 0, 15>&>(), std::declval<integral<std::uint8_t, 0, 127>&>()))>> : std::bool_constant<std::is_same<decltype(T::decode_note_on(std::declval<const std::vector<std::uint8_t>&>(), std::declval<integral<std::uint8_t, 0, 15>&>(), std::declval<integral<std::uint8_t, 0, 127>&>())), bool>::value> {};
+    struct has_note_on_decode_no_velocity<T, std::void_t<decltype(T::decode_note_on(std::declval<const std::vector<std::uint8_t>&>(), std::declval<integral<std::uint8_t, 0, 15>&>(), std::declval<integral<std::uint8_t, 0, 127>&>()))>> : std::bool_constant<std::is_same<decltype(T::decode_note_on(std::declval<const std::vector<std::uint8_t>&>(), std::declval<integral<std::uint8_t, 0, 15>&>(), std::declval<integral<std::uint8_t, 0, 127>&>())), decode_result>::value> {};
 
     template <typename T, typename = void>
     struct has_note_on_decode_no_channel : std::false_type {};
 
     template <typename T>
-    struct has_note_on_decode_no_channel<T, std::void_t<decltype(T::decode_note_on(std::declval<const std::vector<std::uint8_t>&>(), std::declval<integral<std::uint8_t, 0, 127>&>(), std::declval<integral<std::uint8_t, 0, 127>&>()))>> : std::bool_constant<std::is_same<decltype(T::decode_note_on(std::declval<const std::vector<std::uint8_t>&>(), std::declval<integral<std::uint8_t, 0, 127>&>(), std::declval<integral<std::uint8_t, 0, 127>&>())), bool>::value> {};
+    struct has_note_on_decode_no_channel<T, std::void_t<decltype(T::decode_note_on(std::declval<const std::vector<std::uint8_t>&>(), std::declval<integral<std::uint8_t, 0, 127>&>(), std::declval<integral<std::uint8_t, 0, 127>&>()))>> : std::bool_constant<std::is_same<decltype(T::decode_note_on(std::declval<const std::vector<std::uint8_t>&>(), std::declval<integral<std::uint8_t, 0, 127>&>(), std::declval<integral<std::uint8_t, 0, 127>&>())), decode_result>::value> {};
 
     template <typename T, typename = void>
     struct has_note_on_decode_full : std::false_type {};
 
     template <typename T>
-    struct has_note_on_decode_full<T, std::void_t<decltype(T::decode_note_on(std::declval<const std::vector<std::uint8_t>&>(), std::declval<integral<std::uint8_t, 0, 15>&>(), std::declval<integral<std::uint8_t, 0, 127>&>(), std::declval<integral<std::uint8_t, 0, 127>&>()))>> : std::bool_constant<std::is_same<decltype(T::decode_note_on(std::declval<const std::vector<std::uint8_t>&>(), std::declval<integral<std::uint8_t, 0, 15>&>(), std::declval<integral<std::uint8_t, 0, 127>&>(), std::declval<integral<std::uint8_t, 0, 127>&>())), bool>::value> {};
+    struct has_note_on_decode_full<T, std::void_t<decltype(T::decode_note_on(std::declval<const std::vector<std::uint8_t>&>(), std::declval<integral<std::uint8_t, 0, 15>&>(), std::declval<integral<std::uint8_t, 0, 127>&>(), std::declval<integral<std::uint8_t, 0, 127>&>()))>> : std::bool_constant<std::is_same<decltype(T::decode_note_on(std::declval<const std::vector<std::uint8_t>&>(), std::declval<integral<std::uint8_t, 0, 15>&>(), std::declval<integral<std::uint8_t, 0, 127>&>(), std::declval<integral<std::uint8_t, 0, 127>&>())), decode_result>::value> {};
 
     template <typename T>
     struct has_note_on_decode : std::bool_constant<has_note_on_decode_no_velocity<T>::value || has_note_on_decode_no_channel<T>::value || has_note_on_decode_full<T>::value> {};
@@ -150,13 +151,13 @@ namespace detail {
     struct has_note_aftertouch_decode_no_channel : std::false_type {};
 
     template <typename T>
-    struct has_note_aftertouch_decode_no_channel<T, std::void_t<decltype(T::decode_note_aftertouch(std::declval<const std::vector<std::uint8_t>&>(), std::declval<integral<std::uint8_t, 0, 127>&>(), std::declval<integral<std::uint8_t, 0, 127>&>()))>> : std::bool_constant<std::is_same<decltype(T::decode_note_aftertouch(std::declval<const std::vector<std::uint8_t>&>(), std::declval<integral<std::uint8_t, 0, 127>&>(), std::declval<integral<std::uint8_t, 0, 127>&>())), bool>::value> {};
+    struct has_note_aftertouch_decode_no_channel<T, std::void_t<decltype(T::decode_note_aftertouch(std::declval<const std::vector<std::uint8_t>&>(), std::declval<integral<std::uint8_t, 0, 127>&>(), std::declval<integral<std::uint8_t, 0, 127>&>()))>> : std::bool_constant<std::is_same<decltype(T::decode_note_aftertouch(std::declval<const std::vector<std::uint8_t>&>(), std::declval<integral<std::uint8_t, 0, 127>&>(), std::declval<integral<std::uint8_t, 0, 127>&>())), decode_result>::value> {};
 
     template <typename T, typename = void>
     struct has_note_aftertouch_decode_full : std::false_type {};
 
     template <typename T>
-    struct has_note_aftertouch_decode_full<T, std::void_t<decltype(T::decode_note_aftertouch(std::declval<const std::vector<std::uint8_t>&>(), std::declval<integral<std::uint8_t, 0, 15>&>(), std::declval<integral<std::uint8_t, 0, 127>&>(), std::declval<integral<std::uint8_t, 0, 127>&>()))>> : std::bool_constant<std::is_same<decltype(T::decode_note_aftertouch(std::declval<const std::vector<std::uint8_t>&>(), std::declval<integral<std::uint8_t, 0, 15>&>(), std::declval<integral<std::uint8_t, 0, 127>&>(), std::declval<integral<std::uint8_t, 0, 127>&>())), bool>::value> {};
+    struct has_note_aftertouch_decode_full<T, std::void_t<decltype(T::decode_note_aftertouch(std::declval<const std::vector<std::uint8_t>&>(), std::declval<integral<std::uint8_t, 0, 15>&>(), std::declval<integral<std::uint8_t, 0, 127>&>(), std::declval<integral<std::uint8_t, 0, 127>&>()))>> : std::bool_constant<std::is_same<decltype(T::decode_note_aftertouch(std::declval<const std::vector<std::uint8_t>&>(), std::declval<integral<std::uint8_t, 0, 15>&>(), std::declval<integral<std::uint8_t, 0, 127>&>(), std::declval<integral<std::uint8_t, 0, 127>&>())), decode_result>::value> {};
 
     template <typename T>
     struct has_note_aftertouch_decode : std::bool_constant<has_note_aftertouch_decode_no_channel<T>::value || has_note_aftertouch_decode_full<T>::value> {};
@@ -188,7 +189,7 @@ namespace detail {
     struct is_program_change_decode_signature : std::false_type {};
 
     template <typename Chan, typename Prog>
-    struct is_program_change_decode_signature<bool (*)(const std::vector<std::uint8_t>&, Chan&, Prog&)> : std::bool_constant<std::is_same_v<Chan, integral<std::uint8_t, 0, 15>> && is_program_arg<Prog>::value> {};
+    struct is_program_change_decode_signature<decode_result (*)(const std::vector<std::uint8_t>&, Chan&, Prog&)> : std::bool_constant<std::is_same_v<Chan, integral<std::uint8_t, 0, 15>> && is_program_arg<Prog>::value> {};
 
     template <typename T, typename = void>
     struct has_program_change_decode : std::false_type {};
@@ -223,7 +224,7 @@ namespace detail {
     struct has_pitchbend_change_decode : std::false_type {};
 
     template <typename T>
-    struct has_pitchbend_change_decode<T, std::void_t<decltype(T::decode_pitchbend_change(std::declval<const std::vector<std::uint8_t>&>(), std::declval<integral<std::uint8_t, 0, 15>&>(), std::declval<integral<std::uint16_t, 0, 16383, 8192>&>()))>> : std::bool_constant<std::is_same_v<decltype(T::decode_pitchbend_change(std::declval<const std::vector<std::uint8_t>&>(), std::declval<integral<std::uint8_t, 0, 15>&>(), std::declval<integral<std::uint16_t, 0, 16383, 8192>&>())), bool>> {};
+    struct has_pitchbend_change_decode<T, std::void_t<decltype(T::decode_pitchbend_change(std::declval<const std::vector<std::uint8_t>&>(), std::declval<integral<std::uint8_t, 0, 15>&>(), std::declval<integral<std::uint16_t, 0, 16383, 8192>&>()))>> : std::bool_constant<std::is_same_v<decltype(T::decode_pitchbend_change(std::declval<const std::vector<std::uint8_t>&>(), std::declval<integral<std::uint8_t, 0, 15>&>(), std::declval<integral<std::uint16_t, 0, 16383, 8192>&>())), decode_result>> {};
 
     template <capability C, typename T>
     struct has_pitchbend_change_capability : std::false_type {};
@@ -246,7 +247,7 @@ namespace detail {
     struct has_clock_decode : std::false_type {};
 
     template <typename T>
-    struct has_clock_decode<T, std::void_t<decltype(T::decode_clock(std::declval<const std::vector<std::uint8_t>&>()))>> : std::bool_constant<std::is_same<decltype(T::decode_clock(std::declval<const std::vector<std::uint8_t>&>())), bool>::value> {};
+    struct has_clock_decode<T, std::void_t<decltype(T::decode_clock(std::declval<const std::vector<std::uint8_t>&>()))>> : std::bool_constant<std::is_same<decltype(T::decode_clock(std::declval<const std::vector<std::uint8_t>&>())), decode_result>::value> {};
 
     template <capability C, typename T>
     struct has_clock_capability : std::false_type {};
@@ -269,7 +270,7 @@ namespace detail {
     struct has_song_position_decode : std::false_type {};
 
     template <typename T>
-    struct has_song_position_decode<T, std::void_t<decltype(T::decode_song_position(std::declval<const std::vector<std::uint8_t>&>(), std::declval<integral<std::uint16_t, 0, 16383>&>()))>> : std::bool_constant<std::is_same<decltype(T::decode_song_position(std::declval<const std::vector<std::uint8_t>&>(), std::declval<integral<std::uint16_t, 0, 16383>&>())), bool>::value> {};
+    struct has_song_position_decode<T, std::void_t<decltype(T::decode_song_position(std::declval<const std::vector<std::uint8_t>&>(), std::declval<integral<std::uint16_t, 0, 16383>&>()))>> : std::bool_constant<std::is_same<decltype(T::decode_song_position(std::declval<const std::vector<std::uint8_t>&>(), std::declval<integral<std::uint16_t, 0, 16383>&>())), decode_result>::value> {};
 
     template <capability C, typename T>
     struct has_song_position_capability : std::false_type {};
@@ -280,6 +281,52 @@ namespace detail {
     template <typename T>
     struct has_song_position_capability<capability::transmit, T> : has_song_position_decode<T> {};
 
+    // start
+
+    template <typename T, typename = void>
+    struct has_start_encode : std::false_type {};
+
+    template <typename T>
+    struct has_start_encode<T, std::void_t<decltype(T::encode_start(std::declval<std::vector<std::uint8_t>&>()))>> : std::true_type {};
+
+    template <typename T, typename = void>
+    struct has_start_decode : std::false_type {};
+
+    template <typename T>
+    struct has_start_decode<T, std::void_t<decltype(T::decode_start(std::declval<const std::vector<std::uint8_t>&>()))>> : std::bool_constant<std::is_same<decltype(T::decode_start(std::declval<const std::vector<std::uint8_t>&>())), decode_result>::value> {};
+
+    template <capability C, typename T>
+    struct has_start_capability : std::false_type {};
+
+    template <typename T>
+    struct has_start_capability<capability::receive, T> : has_start_encode<T> {};
+
+    template <typename T>
+    struct has_start_capability<capability::transmit, T> : has_start_decode<T> {};
+
+    // stop
+
+    template <typename T, typename = void>
+    struct has_stop_encode : std::false_type {};
+
+    template <typename T>
+    struct has_stop_encode<T, std::void_t<decltype(T::encode_stop(std::declval<std::vector<std::uint8_t>&>()))>> : std::true_type {};
+
+    template <typename T, typename = void>
+    struct has_stop_decode : std::false_type {};
+
+    template <typename T>
+    struct has_stop_decode<T, std::void_t<decltype(T::decode_stop(std::declval<const std::vector<std::uint8_t>&>()))>> : std::bool_constant<std::is_same<decltype(T::decode_stop(std::declval<const std::vector<std::uint8_t>&>())), decode_result>::value> {};
+
+    template <capability C, typename T>
+    struct has_stop_capability : std::false_type {};
+
+    template <typename T>
+    struct has_stop_capability<capability::receive, T> : has_stop_encode<T> {};
+
+    template <typename T>
+    struct has_stop_capability<capability::transmit, T> : has_stop_decode<T> {};
+
     // continue
 
     template <typename T, typename = void>
@@ -292,7 +339,7 @@ namespace detail {
     struct has_continue_decode : std::false_type {};
 
     template <typename T>
-    struct has_continue_decode<T, std::void_t<decltype(T::decode_continue(std::declval<const std::vector<std::uint8_t>&>()))>> : std::bool_constant<std::is_same<decltype(T::decode_continue(std::declval<const std::vector<std::uint8_t>&>())), bool>::value> {};
+    struct has_continue_decode<T, std::void_t<decltype(T::decode_continue(std::declval<const std::vector<std::uint8_t>&>()))>> : std::bool_constant<std::is_same<decltype(T::decode_continue(std::declval<const std::vector<std::uint8_t>&>())), decode_result>::value> {};
 
     template <capability C, typename T>
     struct has_continue_capability : std::false_type {};
@@ -315,7 +362,7 @@ namespace detail {
     struct has_reset_decode : std::false_type {};
 
     template <typename T>
-    struct has_reset_decode<T, std::void_t<decltype(T::decode_reset(std::declval<const std::vector<std::uint8_t>&>()))>> : std::bool_constant<std::is_same<decltype(T::decode_reset(std::declval<const std::vector<std::uint8_t>&>())), bool>::value> {};
+    struct has_reset_decode<T, std::void_t<decltype(T::decode_reset(std::declval<const std::vector<std::uint8_t>&>()))>> : std::bool_constant<std::is_same<decltype(T::decode_reset(std::declval<const std::vector<std::uint8_t>&>())), decode_result>::value> {};
 
     template <capability C, typename T>
     struct has_reset_capability : std::false_type {};
@@ -338,7 +385,7 @@ namespace detail {
     struct has_all_notes_off_decode : std::false_type {};
 
     template <typename T>
-    struct has_all_notes_off_decode<T, std::void_t<decltype(T::decode_all_notes_off(std::declval<const std::vector<std::uint8_t>&>()))>> : std::bool_constant<std::is_same<decltype(T::decode_all_notes_off(std::declval<const std::vector<std::uint8_t>&>())), bool>::value> {};
+    struct has_all_notes_off_decode<T, std::void_t<decltype(T::decode_all_notes_off(std::declval<const std::vector<std::uint8_t>&>()))>> : std::bool_constant<std::is_same<decltype(T::decode_all_notes_off(std::declval<const std::vector<std::uint8_t>&>())), decode_result>::value> {};
 
     template <capability C, typename T>
     struct has_all_notes_off_capability : std::false_type {};
@@ -361,7 +408,7 @@ namespace detail {
     struct has_active_sens_decode : std::false_type {};
 
     template <typename T>
-    struct has_active_sens_decode<T, std::void_t<decltype(T::decode_active_sens(std::declval<const std::vector<std::uint8_t>&>()))>> : std::bool_constant<std::is_same<decltype(T::decode_active_sens(std::declval<const std::vector<std::uint8_t>&>())), bool>::value> {};
+    struct has_active_sens_decode<T, std::void_t<decltype(T::decode_active_sens(std::declval<const std::vector<std::uint8_t>&>()))>> : std::bool_constant<std::is_same<decltype(T::decode_active_sens(std::declval<const std::vector<std::uint8_t>&>())), decode_result>::value> {};
 
     template <capability C, typename T>
     struct has_active_sens_capability : std::false_type {};
@@ -384,7 +431,7 @@ namespace detail {
     struct has_universal_inquiry_decode : std::false_type {};
 
     template <typename T>
-    struct has_universal_inquiry_decode<T, std::void_t<decltype(T::decode_universal_inquiry(std::declval<const std::vector<std::uint8_t>&>(), std::declval<integral<std::uint8_t, 0, 127>&>(), std::declval<std::uint32_t&>(), std::declval<std::uint32_t&>(), std::declval<std::uint32_t&>(), std::declval<std::uint32_t&>()))>> : std::bool_constant<std::is_same<decltype(T::decode_universal_inquiry(std::declval<const std::vector<std::uint8_t>&>(), std::declval<integral<std::uint8_t, 0, 127>&>(), std::declval<std::uint32_t&>(), std::declval<std::uint32_t&>(), std::declval<std::uint32_t&>(), std::declval<std::uint32_t&>())), bool>::value> {};
+    struct has_universal_inquiry_decode<T, std::void_t<decltype(T::decode_universal_inquiry(std::declval<const std::vector<std::uint8_t>&>(), std::declval<integral<std::uint8_t, 0, 127>&>(), std::declval<std::uint32_t&>(), std::declval<std::uint32_t&>(), std::declval<std::uint32_t&>(), std::declval<std::uint32_t&>()))>> : std::bool_constant<std::is_same<decltype(T::decode_universal_inquiry(std::declval<const std::vector<std::uint8_t>&>(), std::declval<integral<std::uint8_t, 0, 127>&>(), std::declval<std::uint32_t&>(), std::declval<std::uint32_t&>(), std::declval<std::uint32_t&>(), std::declval<std::uint32_t&>())), decode_result>::value> {};
 
     template <capability C, typename T>
     struct has_universal_inquiry_capability : std::false_type {};
@@ -409,11 +456,17 @@ namespace detail {
     template <typename T>
     struct has_voice_patch_request_encode<T, std::void_t<decltype(T::encode_voice_patch_request(std::declval<std::vector<std::uint8_t>&>(), std::declval<const integral<std::uint8_t, 0, 15>&>()))>> : std::true_type {};
 
+    template <typename T, typename = void>
+    struct has_voice_patch_changes_encode : std::false_type {};
+
+    template <typename T>
+    struct has_voice_patch_changes_encode<T, std::void_t<decltype(T::encode_voice_patch_changes(std::declval<std::vector<std::uint8_t>&>(), std::declval<integral<std::uint8_t, 0, 15>>(), std::declval<const typename T::voice_patch&>(), std::declval<const typename T::voice_patch&>()))>> : std::true_type {};
+
     template <typename T, typename = void>
     struct has_voice_patch_decode : std::false_type {};
 
     template <typename T>
-    struct has_voice_patch_decode<T, std::void_t<decltype(T::decode_voice_patch(std::declval<const std::vector<std::uint8_t>&>(), std::declval<integral<std::uint8_t, 0, 15>&>(), std::declval<typename T::voice_patch&>()))>> : std::bool_constant<std::is_same<decltype(T::decode_voice_patch(std::declval<const std::vector<std::uint8_t>&>(), std::declval<integral<std::uint8_t, 0, 15>&>(), std::declval<typename T::voice_patch&>())), void>::value> {};
+    struct has_voice_patch_decode<T, std::void_t<decltype(T::decode_voice_patch(std::declval<const std::vector<std::uint8_t>&>(), std::declval<integral<std::uint8_t, 0, 15>&>(), std::declval<typename T::voice_patch&>()))>> : std::bool_constant<std::is_same<decltype(T::decode_voice_patch(std::declval<const std::vector<std::uint8_t>&>(), std::declval<integral<std::uint8_t, 0, 15>&>(), std::declval<typename T::voice_patch&>())), decode_result>::value> {};
 
     template <capability C, typename T>
     struct has_voice_patch_capability : std::false_type {};
@@ -512,6 +565,30 @@ struct has_song_position : std::bool_constant<(sizeof...(Capabilities) > 0) && (
 template <typename Hardware, capability... Capabilities>
 inline constexpr bool has_song_position_v = has_song_position<Hardware, Capabilities...>::value;
 
+/// @brief
+/// @tparam Hardware
+/// @tparam ...Capabilities
+template <typename Hardware, capability... Capabilities>
+struct has_start : std::bool_constant<(sizeof...(Capabilities) > 0) && (... && detail::has_start_capability<Capabilities, Hardware>::value)> {};
+
+/// @brief
+/// @tparam Hardware
+/// @tparam ...Capabilities
+template <typename Hardware, capability... Capabilities>
+inline constexpr bool has_start_v = has_start<Hardware, Capabilities...>::value;
+
+/// @brief
+/// @tparam Hardware
+/// @tparam ...Capabilities
+template <typename Hardware, capability... Capabilities>
+struct has_stop : std::bool_constant<(sizeof...(Capabilities) > 0) && (... && detail::has_stop_capability<Capabilities, Hardware>::value)> {};
+
+/// @brief
+/// @tparam Hardware
+/// @tparam ...Capabilities
+template <typename Hardware, capability... Capabilities>
+inline constexpr bool has_stop_v = has_stop<Hardware, Capabilities...>::value;
+
 /// @brief
 /// @tparam Hardware
 /// @tparam ...Capabilities
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <midispec/core/capabilities.hpp>
+
+namespace midispec {
+
+/// @brief Messages classified by message_of(), the ones covered by the capability traits come first in the order of their rows in a capability matrix
+enum struct message : std::uint8_t {
+    note_off,
+    note_on,
+    note_aftertouch,
+    program_change,
+    pitchbend_change,
+    clock,
+    song_position,
+    start,
+    stop,
+    continue_,
+    reset,
+    all_notes_off,
+    active_sens,
+    universal_inquiry,
+    voice_patch,
+    /// @brief Other system exclusive messages, such as manufacturer specific dumps. Not covered by the capability traits
+    system_exclusive,
+    /// @brief Count of messages, also stands for messages that are not covered
+    count
+};
+
+/// @brief Bitmask of capabilities, one bit per message and capability
+using capability_mask = std::uint64_t;
+
+/// @brief Gets the bit of a message and capability in a capability mask
+/// @param row Message
+/// @param column Capability
+/// @return Bit of the message and capability, 0 for message::system_exclusive and message::count
+constexpr capability_mask capability_bit(const message row, const capability column)
+{
+    return row < message::system_exclusive ? capability_mask(1) << (static_cast<std::uint8_t>(row) * 3 + static_cast<std::uint8_t>(column)) : 0;
+}
+
+/// @brief Gets whether a capability mask contains a message and capability
+/// @param mask Capability mask, typically capability_matrix_v of a hardware
+/// @param row Message
+/// @param column Capability
+/// @return true if the bit of the message and capability is set
+constexpr bool has_capability(const capability_mask mask, const message row, const capability column)
+{
+    return (mask & capability_bit(row, column)) != 0;
+}
+
+/// @brief Gets the name of a message as used in the capability traits
+/// @param row Message
+/// @return Name, or an empty string for message::count
+constexpr const char* message_name(const message row)
+{
+    constexpr const char* _names[] = { "note_off", "note_on", "note_aftertouch", "program_change", "pitchbend_change", "clock", "song_position", "start", "stop", "continue", "reset", "all_notes_off", "active_sens", "universal_inquiry", "voice_patch", "system_exclusive", "" };
+    return _names[static_cast<std::uint8_t>(row < message::count ? row : message::count)];
+}
+
+/// @brief Gets the message of an encoded channel or system message from its leading bytes.
+/// Hardware specific system exclusive messages are all classified as message::system_exclusive
+/// @param encoded Pointer to the first byte of the encoded message
+/// @param size Count of bytes available from encoded
+/// @return Message, or message::count if it is not covered
+inline message message_of(const std::uint8_t* encoded, const std::size_t size)
+{
+    if (size == 0) {
+        return message::count;
+    }
+    switch (encoded[0] & 0xF0) {
+    case 0x80:
+        return message::note_off;
+    case 0x90:
+        return message::note_on;
+    case 0xA0:
+        return message::note_aftertouch;
+    case 0xB0:
+        return size > 1 && encoded[1] == 0x7B ? message::all_notes_off : message::count;
+    case 0xC0:
+        return message::program_change;
+    case 0xE0:
+        return message::pitchbend_change;
+    default:
+        break;
+    }
+    switch (encoded[0]) {
+    case 0xF0:
+        // universal non realtime general information
+        return size > 4 && encoded[1] == 0x7E && encoded[3] == 0x06 ? message::universal_inquiry : message::system_exclusive;
+    case 0xF2:
+        return message::song_position;
+    case 0xF8:
+        return message::clock;
+    case 0xFA:
+        return message::start;
+    case 0xFB:
+        return message::continue_;
+    case 0xFC:
+        return message::stop;
+    case 0xFE:
+        return message::active_sens;
+    case 0xFF:
+        return message::reset;
+    default:
+        return message::count;
+    }
+}
+
+/// @brief Gets the message of an encoded channel or system message from its leading bytes.
+/// Hardware specific system exclusive messages are all classified as message::system_exclusive
+/// @param encoded Vector to read the encoded message from
+/// @return Message, or message::count if it is not covered
+inline message message_of(const std::vector<std::uint8_t>& encoded)
+{
+    return message_of(encoded.data(), encoded.size());
+}
+
+namespace detail {
+
+    template <template <typename, capability...> typename Trait, typename Hardware>
+    constexpr capability_mask capability_row(const message row)
+    {
+        return (Trait<Hardware, capability::receive>::value ? capability_bit(row, capability::receive) : 0)
+            | (Trait<Hardware, capability::request>::value ? capability_bit(row, capability::request) : 0)
+            | (Trait<Hardware, capability::transmit>::value ? capability_bit(row, capability::transmit) : 0);
+    }
+}
+
+/// @brief Capability matrix of a hardware, with the bits of the messages it can receive, request or transmit
+/// @tparam Hardware Hardware struct
+template <typename Hardware>
+inline constexpr capability_mask capability_matrix_v = detail::capability_row<has_note_off, Hardware>(message::note_off)
+    | detail::capability_row<has_note_on, Hardware>(message::note_on)
+    | detail::capability_row<has_note_aftertouch, Hardware>(message::note_aftertouch)
+    | detail::capability_row<has_program_change, Hardware>(message::program_change)
+    | detail::capability_row<has_pitchbend_change, Hardware>(message::pitchbend_change)
+    | detail::capability_row<has_clock, Hardware>(message::clock)
+    | detail::capability_row<has_song_position, Hardware>(message::song_position)
+    | detail::capability_row<has_start, Hardware>(message::start)
+    | detail::capability_row<has_stop, Hardware>(message::stop)
+    | detail::capability_row<has_continue, Hardware>(message::continue_)
+    | detail::capability_row<has_reset, Hardware>(message::reset)
+    | detail::capability_row<has_all_notes_off, Hardware>(message::all_notes_off)
+    | detail::capability_row<has_active_sens, Hardware>(message::active_sens)
+    | detail::capability_row<has_universal_inquiry, Hardware>(message::universal_inquiry)
+    | detail::capability_row<has_voice_patch, Hardware>(message::voice_patch);
+
+}
@@ -0,0 +1,218 @@
+#pragma once
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include <midispec/core/capabilities.hpp>
+#include <midispec/core/integral.hpp>
+
+namespace midispec {
+
+/// @brief Transport state of a clock follower
+enum struct clock_transport : std::uint8_t {
+    /// @brief Stopped, clock ticks only track the tempo
+    stopped,
+    /// @brief Playing, clock ticks also advance the position
+    playing
+};
+
+/// @brief Tempo tracking quality of a clock follower
+struct clock_follower_statistics {
+    /// @brief Clock ticks received
+    std::uint64_t ticks = 0;
+    /// @brief Times the loop lost lock on the incoming clock and restarted tracking
+    std::uint64_t relocks = 0;
+    /// @brief Root mean square of the incoming tick arrival error against the loop prediction
+    std::chrono::nanoseconds input_jitter_rms = std::chrono::nanoseconds(0);
+};
+
+/// @brief MIDI clock follower estimating tempo and phase from timestamped 24 PPQN clock received from hardware
+/// that can transmit clock (akai_rythmwolf).
+/// Ticks drive a second order phase-locked loop, raw tick intervals are never exposed
+/// @tparam Hardware Hardware struct exposing decode_clock()
+template <typename Hardware>
+struct clock_follower {
+
+    static_assert(has_clock_v<Hardware, capability::transmit>, "Requires hardware that can transmit clock");
+
+    /// @brief Creates a clock follower
+    /// @param phase_gain Fraction of the arrival error corrected on the phase each tick. In range ]0, 1]
+    /// @param period_gain Fraction of the arrival error corrected on the period each tick. In range ]0, 1]
+    inline explicit clock_follower(const double phase_gain = 0.1, const double period_gain = 0.005)
+        : _phase_gain(phase_gain)
+        , _period_gain(period_gain)
+    {
+    }
+
+    /// @brief Decodes a message received from the hardware and updates the tempo, phase and transport
+    /// @param encoded Vector to read the encoded message from
+    /// @param timestamp Time the message was received at, as close to the driver as possible
+    /// @return true if the message was a clock or transport message
+    inline bool receive(
+        const std::vector<std::uint8_t>& encoded,
+        const std::chrono::steady_clock::time_point timestamp)
+    {
+        std::lock_guard<std::mutex> _lock(_mutex);
+        if (Hardware::decode_clock(encoded)) {
+            tick(timestamp);
+            return true;
+        }
+        if constexpr (has_start_v<Hardware, capability::transmit>) {
+            if (Hardware::decode_start(encoded)) {
+                _position = 0;
+                hold();
+                _transport = clock_transport::playing;
+                return true;
+            }
+        }
+        if constexpr (has_stop_v<Hardware, capability::transmit>) {
+            if (Hardware::decode_stop(encoded)) {
+                // the position stays where it was when the transport stopped
+                _fraction = fraction(timestamp);
+                _interpolating = false;
+                _transport = clock_transport::stopped;
+                return true;
+            }
+        }
+        if constexpr (has_continue_v<Hardware, capability::transmit>) {
+            if (Hardware::decode_continue(encoded)) {
+                hold();
+                _transport = clock_transport::playing;
+                return true;
+            }
+        }
+        if constexpr (has_song_position_v<Hardware, capability::transmit>) {
+            integral<std::uint16_t, 0, 16383> _song_position;
+            if (Hardware::decode_song_position(encoded, _song_position)) {
+                // song position is counted in sixteenth notes, 6 ticks each
+                _position = static_cast<std::uint64_t>(_song_position.value()) * 6;
+                hold();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// @brief Gets the estimated tempo
+    /// @return Beats per minute, 0 until the loop has locked
+    inline double beats_per_minute() const
+    {
+        std::lock_guard<std::mutex> _lock(_mutex);
+        return _locked ? 60.0e9 / (_period * 24.0) : 0.0;
+    }
+
+    /// @brief Gets the transport state
+    /// @return Stopped or playing
+    inline clock_transport transport() const
+    {
+        std::lock_guard<std::mutex> _lock(_mutex);
+        return _transport;
+    }
+
+    /// @brief Gets the estimated song position at a given time, interpolated between ticks.
+    /// The position is continuous across lock, stop and ticks. It stays where it was when the transport stopped,
+    /// and waits on the tick playback resumes from after a start, continue or song position pointer
+    /// @param time Time to estimate the position at
+    /// @return Position in ticks (24 per beat) since start or the last song position pointer
+    inline double position(const std::chrono::steady_clock::time_point time) const
+    {
+        std::lock_guard<std::mutex> _lock(_mutex);
+        // the last counted tick is at _position - 1 in every state, only the fraction of the next tick differs
+        return static_cast<double>(_position) - 1.0 + fraction(time);
+    }
+
+    /// @brief Gets a snapshot of the tracking quality
+    /// @return Statistics since creation
+    inline clock_follower_statistics statistics() const
+    {
+        std::lock_guard<std::mutex> _lock(_mutex);
+        clock_follower_statistics _result = _statistics;
+        if (_error_count > 0) {
+            _result.input_jitter_rms = std::chrono::nanoseconds(std::llround(std::sqrt(_error_square_sum / _error_count)));
+        }
+        return _result;
+    }
+
+private:
+    double _phase_gain;
+    double _period_gain;
+    bool _locked = false;
+    std::uint64_t _ticks_since_lock = 0;
+    double _period = 0.0;
+    std::chrono::steady_clock::time_point _tick_time;
+    std::uint64_t _position = 0;
+    double _fraction = 1.0;
+    bool _interpolating = false;
+    clock_transport _transport = clock_transport::stopped;
+    clock_follower_statistics _statistics;
+    double _error_square_sum = 0.0;
+    std::uint64_t _error_count = 0;
+    mutable std::mutex _mutex;
+
+    /// waits on the next tick, which lands on _position
+    inline void hold()
+    {
+        _fraction = 1.0;
+        _interpolating = false;
+    }
+
+    /// fraction of the interval to the next tick elapsed at a given time
+    inline double fraction(const std::chrono::steady_clock::time_point time) const
+    {
+        if (!_interpolating) {
+            return _fraction;
+        }
+        // without lock the position advances tick by tick
+        if (!_locked) {
+            return 0.0;
+        }
+        // the loop tick time is the filtered time of the last counted tick
+        const double _elapsed = static_cast<double>((time - _tick_time).count()) / _period;
+        return _elapsed < 0.0 ? 0.0 : (_elapsed > 1.0 ? 1.0 : _elapsed);
+    }
+
+    inline void tick(const std::chrono::steady_clock::time_point timestamp)
+    {
+        ++_statistics.ticks;
+        if (_transport == clock_transport::playing) {
+            ++_position;
+            _interpolating = true;
+        }
+
+        if (_ticks_since_lock == 0) {
+            _tick_time = timestamp;
+            _ticks_since_lock = 1;
+            return;
+        }
+        if (_ticks_since_lock == 1) {
+            _period = static_cast<double>((timestamp - _tick_time).count());
+            _tick_time = timestamp;
+            _ticks_since_lock = 2;
+            _locked = _period > 0.0;
+            return;
+        }
+
+        const std::chrono::steady_clock::time_point _predicted = _tick_time + std::chrono::nanoseconds(std::llround(_period));
+        const double _error = static_cast<double>((timestamp - _predicted).count());
+
+        // a tick off by more than half a period means dropped ticks or a tempo jump, tracking restarts from it
+        if (std::abs(_error) > _period * 0.5) {
+            ++_statistics.relocks;
+            _tick_time = timestamp;
+            _ticks_since_lock = 1;
+            _locked = false;
+            return;
+        }
+
+        _error_square_sum += _error * _error;
+        ++_error_count;
+        _tick_time = _predicted + std::chrono::nanoseconds(std::llround(_phase_gain * _error));
+        _period += _period_gain * _error;
+        ++_ticks_since_lock;
+    }
+};
+
+}
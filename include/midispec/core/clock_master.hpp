@@ -0,0 +1,224 @@
+#pragma once
+
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <midispec/core/capabilities.hpp>
+#include <midispec/core/integral.hpp>
+#include <midispec/core/message_split.hpp>
+
+namespace midispec {
+
+/// @brief Timing error of the clock ticks sent by a clock master
+struct clock_statistics {
+    /// @brief Clock ticks sent
+    std::uint64_t ticks = 0;
+    /// @brief Mean delay between the tick deadline and the tick send
+    std::chrono::nanoseconds jitter_mean = std::chrono::nanoseconds(0);
+    /// @brief Root mean square of the delay between the tick deadline and the tick send
+    std::chrono::nanoseconds jitter_rms = std::chrono::nanoseconds(0);
+    /// @brief Largest delay between the tick deadline and the tick send
+    std::chrono::nanoseconds jitter_max = std::chrono::nanoseconds(0);
+};
+
+/// @brief MIDI clock master sending 24 PPQN clock and transport messages to hardware that can receive clock
+/// (akai_lpk25, akai_rythmwolf).
+/// Tick deadlines are computed from the tempo origin instead of the previous tick so that error never accumulates.
+/// Clock is sent continuously once opened and transport messages are sent right before the next tick, one message per call to the output callback
+/// @tparam Hardware Hardware struct exposing encode_clock()
+template <typename Hardware>
+struct clock_master {
+
+    static_assert(has_clock_v<Hardware, capability::receive>, "Requires hardware that can receive clock");
+
+    using output = std::function<void(const std::vector<std::uint8_t>&)>;
+
+    clock_master() = default;
+    clock_master(const clock_master&) = delete;
+    clock_master& operator=(const clock_master&) = delete;
+
+    inline ~clock_master()
+    {
+        close();
+    }
+
+    /// @brief Starts the clock thread
+    /// @param send Callback sending a single encoded message to the hardware, called from the clock thread
+    /// @param beats_per_minute Tempo. In range [1, 1000]
+    /// @param spin Duration before each deadline that is busy waited instead of slept for precision
+    inline void open(
+        output send,
+        const double beats_per_minute = 120.0,
+        const std::chrono::microseconds spin = std::chrono::microseconds(500))
+    {
+        close();
+        _send = std::move(send);
+        _spin = spin;
+        _origin = std::chrono::steady_clock::now();
+        _origin_tick = 0;
+        _tick = 0;
+        _tick_period = tick_period(beats_per_minute);
+        _transport.clear();
+        _statistics = clock_statistics {};
+        _jitter_sum = 0;
+        _jitter_square_sum = 0;
+        _stop = false;
+        _thread = std::thread(&clock_master::run, this);
+    }
+
+    /// @brief Stops the clock thread, pending transport messages are sent without waiting for the next tick
+    inline void close()
+    {
+        {
+            std::lock_guard<std::mutex> _lock(_mutex);
+            _stop = true;
+        }
+        _condition_variable.notify_all();
+        if (_thread.joinable()) {
+            _thread.join();
+        }
+    }
+
+    /// @brief Changes the tempo from the next tick
+    /// @param beats_per_minute Tempo. In range [1, 1000]
+    inline void tempo(const double beats_per_minute)
+    {
+        std::lock_guard<std::mutex> _lock(_mutex);
+        // re-anchor on the next deadline so that the tempo change does not shift past ticks
+        _origin = deadline(_tick);
+        _origin_tick = _tick;
+        _tick_period = tick_period(beats_per_minute);
+    }
+
+    /// @brief Sends a start message before the next tick.
+    /// Hardware without start receives a song position of 0 and a continue message
+    inline void start()
+    {
+        std::lock_guard<std::mutex> _lock(_mutex);
+        if constexpr (has_start_v<Hardware, capability::receive>) {
+            Hardware::encode_start(_transport);
+        } else {
+            static_assert(has_song_position_v<Hardware, capability::receive> && has_continue_v<Hardware, capability::receive>, "Requires hardware that can receive start or song position and continue");
+            Hardware::encode_song_position(_transport, 0);
+            Hardware::encode_continue(_transport);
+        }
+    }
+
+    /// @brief Sends a stop message before the next tick
+    inline void stop()
+    {
+        static_assert(has_stop_v<Hardware, capability::receive>, "Requires hardware that can receive stop");
+        std::lock_guard<std::mutex> _lock(_mutex);
+        Hardware::encode_stop(_transport);
+    }
+
+    /// @brief Sends a continue message before the next tick
+    inline void resume()
+    {
+        static_assert(has_continue_v<Hardware, capability::receive>, "Requires hardware that can receive continue");
+        std::lock_guard<std::mutex> _lock(_mutex);
+        Hardware::encode_continue(_transport);
+    }
+
+    /// @brief Sends a song position pointer message before the next tick. Hardware expects it while stopped
+    /// @param data MIDI song position pointer in sixteenth notes. In range [0, 16383]
+    inline void song_position(const integral<std::uint16_t, 0, 16383> data)
+    {
+        static_assert(has_song_position_v<Hardware, capability::receive>, "Requires hardware that can receive song position");
+        std::lock_guard<std::mutex> _lock(_mutex);
+        Hardware::encode_song_position(_transport, data);
+    }
+
+    /// @brief Gets a snapshot of the clock timing error
+    /// @return Statistics since the last open()
+    inline clock_statistics statistics() const
+    {
+        std::lock_guard<std::mutex> _lock(_mutex);
+        clock_statistics _result = _statistics;
+        if (_result.ticks > 0) {
+            const double _mean = _jitter_sum / _result.ticks;
+            _result.jitter_mean = std::chrono::nanoseconds(std::llround(_mean));
+            _result.jitter_rms = std::chrono::nanoseconds(std::llround(std::sqrt(_jitter_square_sum / _result.ticks)));
+        }
+        return _result;
+    }
+
+private:
+    output _send;
+    std::chrono::microseconds _spin;
+    std::chrono::steady_clock::time_point _origin;
+    std::uint64_t _origin_tick;
+    std::uint64_t _tick;
+    double _tick_period;
+    std::vector<std::uint8_t> _transport;
+    clock_statistics _statistics;
+    double _jitter_sum;
+    double _jitter_square_sum;
+    bool _stop = true;
+    mutable std::mutex _mutex;
+    std::condition_variable _condition_variable;
+    std::thread _thread;
+
+    inline static double tick_period(const double beats_per_minute)
+    {
+        const double _clamped = beats_per_minute < 1.0 ? 1.0 : (beats_per_minute > 1000.0 ? 1000.0 : beats_per_minute);
+        return 60.0e9 / (_clamped * 24.0);
+    }
+
+    inline std::chrono::steady_clock::time_point deadline(const std::uint64_t tick) const
+    {
+        const double _offset = static_cast<double>(tick - _origin_tick) * _tick_period;
+        return _origin + std::chrono::nanoseconds(std::llround(_offset));
+    }
+
+    inline void run()
+    {
+        std::vector<std::uint8_t> _encoded;
+        std::vector<std::uint8_t> _message;
+        std::unique_lock<std::mutex> _lock(_mutex);
+        while (!_stop) {
+            std::chrono::steady_clock::time_point _deadline = deadline(_tick);
+            if (_condition_variable.wait_until(_lock, _deadline - _spin, [this] { return _stop; })) {
+                break;
+            }
+
+            // re-anchor instead of bursting ticks when the thread has been suspended for more than a tick
+            const std::chrono::steady_clock::time_point _now = std::chrono::steady_clock::now();
+            if (static_cast<double>((_now - _deadline).count()) > _tick_period) {
+                _origin = _now;
+                _origin_tick = _tick;
+                _deadline = _now;
+            }
+
+            _encoded.clear();
+            _encoded.swap(_transport);
+            Hardware::encode_clock(_encoded);
+            _lock.unlock();
+
+            while (std::chrono::steady_clock::now() < _deadline) {
+            }
+            split_messages(_encoded, _message, _send);
+            const double _jitter = static_cast<double>((std::chrono::steady_clock::now() - _deadline).count());
+
+            _lock.lock();
+            ++_tick;
+            ++_statistics.ticks;
+            _jitter_sum += _jitter;
+            _jitter_square_sum += _jitter * _jitter;
+            if (std::chrono::nanoseconds(std::llround(_jitter)) > _statistics.jitter_max) {
+                _statistics.jitter_max = std::chrono::nanoseconds(std::llround(_jitter));
+            }
+        }
+
+        split_messages(_transport, _message, _send);
+        _transport.clear();
+    }
+};
+
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+
+namespace midispec {
+
+/// @brief Reasons for a decoder to reject a message
+enum struct decode_error : std::uint8_t {
+    /// @brief The message was decoded
+    none,
+    /// @brief The message is shorter or longer than expected
+    size,
+    /// @brief The status, manufacturer, format or length bytes do not match the message
+    header,
+    /// @brief The message is addressed to a channel the hardware does not use
+    channel,
+    /// @brief The checksum does not match the data
+    checksum,
+    /// @brief The parts of the message are addressed to different devices
+    device,
+    /// @brief A data byte has its high bit set or a value is out of range
+    range,
+    /// @brief The hardware cannot transmit the message
+    unsupported,
+    /// @brief Count of reasons
+    count
+};
+
+/// @brief Result of a decoder, converting to true on success.
+/// Holds a single byte and is returned in a register, so decoders are as cheap as when they returned bool
+struct decode_result {
+
+    /// @brief Creates a successful result
+    constexpr decode_result() noexcept = default;
+
+    /// @brief Creates a result from a reason
+    /// @param error Reason, decode_error::none for a success
+    constexpr decode_result(const decode_error error) noexcept
+        : _error(error)
+    {
+    }
+
+    /// @brief Gets whether the message was decoded
+    /// @return true on success
+    constexpr operator bool() const noexcept
+    {
+        return _error == decode_error::none;
+    }
+
+    /// @brief Gets the reason of the rejection
+    /// @return Reason, decode_error::none on success
+    constexpr decode_error error() const noexcept
+    {
+        return _error;
+    }
+
+private:
+    decode_error _error = decode_error::none;
+};
+
+/// @brief Gets the name of a reason for diagnostics
+/// @param error Reason
+/// @return Name, or an empty string for decode_error::count
+constexpr const char* decode_error_name(const decode_error error)
+{
+    constexpr const char* _names[] = { "none", "size", "header", "channel", "checksum", "device", "range", "unsupported", "" };
+    return _names[static_cast<std::uint8_t>(error < decode_error::count ? error : decode_error::count)];
+}
+
+}
@@ -0,0 +1,188 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <midispec/core/capabilities.hpp>
+#include <midispec/core/integral.hpp>
+
+namespace midispec {
+
+/// @brief Device that answered a universal inquiry
+struct discovered_device {
+    /// @brief Index of the port pair the reply was received on
+    std::size_t port = 0;
+    /// @brief Device number of the reply
+    std::uint8_t device = 0;
+    /// @brief Manufacturer ID, three byte IDs are stored as 0x00XXYY
+    std::uint32_t manufacturer = 0;
+    /// @brief Family code
+    std::uint32_t family = 0;
+    /// @brief Model code
+    std::uint32_t model = 0;
+    /// @brief Software version
+    std::uint32_t version = 0;
+    /// @brief Index of the matching hardware struct in the discovery template arguments, or the count of template arguments if unknown
+    std::size_t hardware = 0;
+};
+
+/// @brief Non interactive discovery of the devices connected to several port pairs.
+/// A universal inquiry is sent on every port concurrently and replies from all ports are collected until one shared deadline,
+/// then identified against a registry of manufacturer, family and model codes
+/// @tparam ...Hardware Hardware structs that can be identified, at least one of them must request and transmit universal inquiries
+template <typename... Hardware>
+struct device_discovery {
+
+    static_assert(sizeof...(Hardware) > 0, "Requires at least one hardware");
+    static_assert((... || has_universal_inquiry_v<Hardware, capability::request, capability::transmit>), "Requires at least one hardware that can request and transmit universal inquiries");
+
+    using output = std::function<void(const std::vector<std::uint8_t>&)>;
+
+    /// @brief Index reported for devices missing from the registry
+    static constexpr std::size_t unknown = sizeof...(Hardware);
+
+    /// @brief Gets the index of a hardware struct in the template arguments
+    /// @tparam Target Hardware struct
+    /// @return Index reported in discovered_device::hardware
+    template <typename Target>
+    inline static constexpr std::size_t index_of()
+    {
+        constexpr bool _matches[] = { std::is_same<Target, Hardware>::value... };
+        for (std::size_t _index = 0; _index < sizeof...(Hardware); ++_index) {
+            if (_matches[_index]) {
+                return _index;
+            }
+        }
+        return unknown;
+    }
+
+    /// @brief Registers the codes a hardware struct answers universal inquiries with
+    /// @tparam Target Hardware struct
+    /// @param manufacturer Manufacturer ID, three byte IDs as 0x00XXYY
+    /// @param family Family code
+    /// @param model Model code
+    template <typename Target>
+    inline void identify(const std::uint32_t manufacturer, const std::uint32_t family, const std::uint32_t model)
+    {
+        static_assert(index_of<Target>() != unknown, "Hardware is not a template argument of this discovery");
+        std::lock_guard<std::mutex> _lock(_mutex);
+        _registry[std::make_tuple(manufacturer, family, model)] = index_of<Target>();
+    }
+
+    inline ~device_discovery()
+    {
+        join();
+    }
+
+    /// @brief Sends a universal inquiry to every device of every port, one thread per port, and starts the shared deadline.
+    /// Returns without waiting for the sends, threads of a previous discovery are joined first
+    /// @param ports Callbacks sending encoded messages to each port pair, index i pairs with the inputs given to receive()
+    inline void start(const std::vector<output>& ports)
+    {
+        join();
+        {
+            std::lock_guard<std::mutex> _lock(_mutex);
+            _devices.clear();
+            _started = std::chrono::steady_clock::now();
+        }
+        std::vector<std::uint8_t> _request;
+        encode_request(_request);
+        // a port blocked by its driver only delays its own inquiry, the deadline runs from here for every port
+        _senders.reserve(ports.size());
+        for (const output& _port : ports) {
+            _senders.emplace_back([_port, _request] { _port(_request); });
+        }
+    }
+
+    /// @brief Decodes a universal inquiry reply received on a port. Call from the input callback of every port.
+    /// Hardware decoders are tried in order and the first decode found in the registry wins
+    /// @param port Index of the port pair the message was received on
+    /// @param encoded Vector to read the encoded message from
+    /// @return true if the message was a universal inquiry reply
+    inline bool receive(const std::size_t port, const std::vector<std::uint8_t>& encoded)
+    {
+        {
+            std::lock_guard<std::mutex> _lock(_mutex);
+            discovered_device _found;
+            bool _decoded = false;
+            const auto _decode = [&](auto* hardware) {
+                using _hardware_t = std::remove_pointer_t<decltype(hardware)>;
+                if constexpr (has_universal_inquiry_v<_hardware_t, capability::transmit>) {
+                    discovered_device _candidate;
+                    integral<std::uint8_t, 0, 127> _device;
+                    if ((_decoded && _found.hardware != unknown) || !_hardware_t::decode_universal_inquiry(encoded, _device, _candidate.manufacturer, _candidate.family, _candidate.model, _candidate.version)) {
+                        return;
+                    }
+                    const auto _identified = _registry.find(std::make_tuple(_candidate.manufacturer, _candidate.family, _candidate.model));
+                    _candidate.hardware = _identified != _registry.end() ? _identified->second : unknown;
+                    if (!_decoded || _candidate.hardware != unknown) {
+                        _candidate.port = port;
+                        _candidate.device = _device.value();
+                        _found = _candidate;
+                    }
+                    _decoded = true;
+                }
+            };
+            (_decode(static_cast<Hardware*>(nullptr)), ...);
+            if (!_decoded) {
+                return false;
+            }
+            _devices.push_back(_found);
+        }
+        _condition_variable.notify_all();
+        return true;
+    }
+
+    /// @brief Waits for replies until a shared deadline
+    /// @param timeout Duration to collect replies for, starting at the last call to start()
+    /// @param expected Count of replies to return early at, or 0 to wait until the deadline
+    /// @return Devices that replied, in reply order
+    inline std::vector<discovered_device> wait(const std::chrono::milliseconds timeout, const std::size_t expected = 0)
+    {
+        std::unique_lock<std::mutex> _lock(_mutex);
+        _condition_variable.wait_until(_lock, _started + timeout, [this, expected] { return expected > 0 && _devices.size() >= expected; });
+        return _devices;
+    }
+
+private:
+    std::map<std::tuple<std::uint32_t, std::uint32_t, std::uint32_t>, std::size_t> _registry;
+    std::vector<discovered_device> _devices;
+    std::chrono::steady_clock::time_point _started = std::chrono::steady_clock::now();
+    std::vector<std::thread> _senders;
+    std::mutex _mutex;
+    std::condition_variable _condition_variable;
+
+    inline void join()
+    {
+        for (std::thread& _sender : _senders) {
+            _sender.join();
+        }
+        _senders.clear();
+    }
+
+    inline static void encode_request(std::vector<std::uint8_t>& encoded)
+    {
+        bool _encoded = false;
+        const auto _encode = [&](auto* hardware) {
+            using _hardware_t = std::remove_pointer_t<decltype(hardware)>;
+            if constexpr (has_universal_inquiry_v<_hardware_t, capability::request>) {
+                if (!_encoded) {
+                    // device number 0x7F addresses every device of the port
+                    _hardware_t::encode_universal_inquiry_request(encoded, 0x7F);
+                    _encoded = true;
+                }
+            }
+        };
+        (_encode(static_cast<Hardware*>(nullptr)), ...);
+    }
+};
+
+}
@@ -0,0 +1,229 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+#include <midispec/core/capabilities.hpp>
+#include <midispec/core/decode_result.hpp>
+#include <midispec/core/integral.hpp>
+#include <midispec/core/metrics.hpp>
+#include <midispec/core/note_messages.hpp>
+
+namespace midispec {
+
+/// @brief Empty tag standing for a hardware struct inside a device variant
+/// @tparam Hardware Hardware struct
+template <typename Hardware>
+struct hardware_tag {
+    using type = Hardware;
+};
+
+/// @brief Statically dispatched handle to one hardware struct among several.
+/// Generic operations are forwarded to the held hardware when its capability traits allow it,
+/// dispatch is a single jump on the variant index without virtual calls or type erased callbacks
+/// @tparam ...Hardware Hardware structs the handle can hold
+template <typename... Hardware>
+struct device_variant {
+
+    static_assert(sizeof...(Hardware) > 0, "Requires at least one hardware");
+
+    using variant_type = std::variant<hardware_tag<Hardware>...>;
+
+    /// @brief Creates a handle holding the first hardware
+    constexpr device_variant() = default;
+
+    /// @brief Creates a handle holding a hardware
+    /// @tparam Target Hardware struct, one of the template arguments
+    template <typename Target>
+    constexpr device_variant(const hardware_tag<Target> tag)
+        : _variant(tag)
+    {
+    }
+
+    /// @brief Makes the handle hold the hardware at an index of the template arguments, as reported by device_discovery
+    /// @param index Index of the hardware
+    /// @return true on success, false if the index is out of range
+    inline bool assign(const std::size_t index)
+    {
+        bool _assigned = false;
+        std::size_t _current = 0;
+        ((_current++ == index ? (_variant = hardware_tag<Hardware> {}, _assigned = true) : false), ...);
+        return _assigned;
+    }
+
+    /// @brief Gets the index of the held hardware in the template arguments
+    /// @return Index
+    constexpr std::size_t index() const noexcept
+    {
+        return _variant.index();
+    }
+
+    /// @brief Gets whether the handle holds a hardware
+    /// @tparam Target Hardware struct
+    /// @return true if the held hardware is Target
+    template <typename Target>
+    constexpr bool holds() const noexcept
+    {
+        return std::holds_alternative<hardware_tag<Target>>(_variant);
+    }
+
+    /// @brief Calls a visitor with the hardware_tag of the held hardware
+    /// @param visitor Generic callable taking a hardware_tag, typically a lambda with an auto parameter
+    /// @return Result of the visitor
+    template <typename Visitor>
+    constexpr decltype(auto) visit(Visitor&& visitor) const
+    {
+        return std::visit(std::forward<Visitor>(visitor), _variant);
+    }
+
+    /// @brief Encodes a note on message for the held hardware.
+    /// Channel or velocity are ignored by hardware that does not take them
+    /// @param encoded Vector to append the encoded message to
+    /// @param channel Target channel number. In range [0, 15]
+    /// @param note Note number. In range [0, 127]
+    /// @param velocity Velocity. In range [0, 127]
+    /// @return true if the held hardware can receive note on messages
+    inline bool encode_note_on(
+        std::vector<std::uint8_t>& encoded,
+        const integral<std::uint8_t, 0, 15> channel,
+        const integral<std::uint8_t, 0, 127> note,
+        const integral<std::uint8_t, 0, 127> velocity) const
+    {
+        return visit([&](auto tag) {
+            using _hardware_t = typename decltype(tag)::type;
+            if constexpr (has_note_on_v<_hardware_t, capability::receive>) {
+                midispec::encode_note_on<_hardware_t>(encoded, channel, note, velocity);
+                return true;
+            } else {
+                return false;
+            }
+        });
+    }
+
+    /// @brief Encodes a note off message for the held hardware.
+    /// Channel or velocity are ignored by hardware that does not take them
+    /// @param encoded Vector to append the encoded message to
+    /// @param channel Target channel number. In range [0, 15]
+    /// @param note Note number. In range [0, 127]
+    /// @param velocity Release velocity. In range [0, 127]
+    /// @return true if the held hardware can receive note off messages
+    inline bool encode_note_off(
+        std::vector<std::uint8_t>& encoded,
+        const integral<std::uint8_t, 0, 15> channel,
+        const integral<std::uint8_t, 0, 127> note,
+        const integral<std::uint8_t, 0, 127> velocity = 0) const
+    {
+        return visit([&](auto tag) {
+            using _hardware_t = typename decltype(tag)::type;
+            if constexpr (has_note_off_v<_hardware_t, capability::receive>) {
+                midispec::encode_note_off<_hardware_t>(encoded, channel, note, velocity);
+                return true;
+            } else {
+                return false;
+            }
+        });
+    }
+
+    /// @brief Encodes a program change message for the held hardware.
+    /// Programs beyond the range of the hardware follow the integral bound policy
+    /// @param encoded Vector to append the encoded message to
+    /// @param channel Target channel number. In range [0, 15]
+    /// @param program Program number. In range [0, 127]
+    /// @return true if the held hardware can receive program change messages
+    inline bool encode_program_change(
+        std::vector<std::uint8_t>& encoded,
+        const integral<std::uint8_t, 0, 15> channel,
+        const integral<std::uint8_t, 0, 127> program) const
+    {
+        return visit([&](auto tag) {
+            using _hardware_t = typename decltype(tag)::type;
+            if constexpr (has_program_change_v<_hardware_t, capability::receive>) {
+                const std::size_t _offset = encoded.size();
+                _hardware_t::encode_program_change(encoded, channel, program.value());
+                metrics<_hardware_t>::count_encoded(encoded, _offset);
+                return true;
+            } else {
+                return false;
+            }
+        });
+    }
+
+    /// @brief Encodes a pitchbend change message for the held hardware
+    /// @param encoded Vector to append the encoded message to
+    /// @param channel Target channel number. In range [0, 15]
+    /// @param pitchbend Pitchbend value. In range [0, 16383] (Default 8192)
+    /// @return true if the held hardware can receive pitchbend change messages
+    inline bool encode_pitchbend_change(
+        std::vector<std::uint8_t>& encoded,
+        const integral<std::uint8_t, 0, 15> channel,
+        const integral<std::uint16_t, 0, 16383, 8192> pitchbend) const
+    {
+        return visit([&](auto tag) {
+            using _hardware_t = typename decltype(tag)::type;
+            if constexpr (has_pitchbend_change_v<_hardware_t, capability::receive>) {
+                const std::size_t _offset = encoded.size();
+                _hardware_t::encode_pitchbend_change(encoded, channel, pitchbend);
+                metrics<_hardware_t>::count_encoded(encoded, _offset);
+                return true;
+            } else {
+                return false;
+            }
+        });
+    }
+
+    /// @brief Encodes a universal inquiry request message for the held hardware
+    /// @param encoded Vector to append the encoded SysEx message to
+    /// @param device Target device number. In range [0, 127]
+    /// @return true if the held hardware can be requested universal inquiries
+    inline bool encode_universal_inquiry_request(
+        std::vector<std::uint8_t>& encoded,
+        const integral<std::uint8_t, 0, 127> device) const
+    {
+        return visit([&](auto tag) {
+            using _hardware_t = typename decltype(tag)::type;
+            if constexpr (has_universal_inquiry_v<_hardware_t, capability::request>) {
+                const std::size_t _offset = encoded.size();
+                _hardware_t::encode_universal_inquiry_request(encoded, device);
+                metrics<_hardware_t>::count_encoded(encoded, _offset);
+                return true;
+            } else {
+                return false;
+            }
+        });
+    }
+
+    /// @brief Decodes a universal inquiry reply with the decoder of the held hardware
+    /// @param encoded Vector to read the encoded message from
+    /// @param device Device number of the reply
+    /// @param manufacturer MIDI hardware manufacturer info
+    /// @param family MIDI hardware family info
+    /// @param model MIDI hardware model info
+    /// @param version MIDI hardware version info
+    /// @return Success, or the reason of the rejection, decode_error::unsupported if the held hardware cannot transmit universal inquiries
+    inline decode_result decode_universal_inquiry(
+        const std::vector<std::uint8_t>& encoded,
+        integral<std::uint8_t, 0, 127>& device,
+        std::uint32_t& manufacturer,
+        std::uint32_t& family,
+        std::uint32_t& model,
+        std::uint32_t& version) const
+    {
+        return visit([&](auto tag) {
+            using _hardware_t = typename decltype(tag)::type;
+            if constexpr (has_universal_inquiry_v<_hardware_t, capability::transmit>) {
+                const decode_result _decoded = _hardware_t::decode_universal_inquiry(encoded, device, manufacturer, family, model, version);
+                metrics<_hardware_t>::count_decoded(encoded, _decoded);
+                return _decoded;
+            } else {
+                return decode_result(decode_error::unsupported);
+            }
+        });
+    }
+
+private:
+    variant_type _variant;
+};
+
+}
@@ -0,0 +1,230 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <midispec/core/message_split.hpp>
+
+namespace midispec {
+
+/// @brief Counters of a dump pipeline
+struct dump_pipeline_statistics {
+    /// @brief Requests sent to the hardware
+    std::uint64_t requests_sent = 0;
+    /// @brief Received frames matched to an outstanding request
+    std::uint64_t frames_matched = 0;
+    /// @brief Received frames that matched no outstanding request
+    std::uint64_t frames_unmatched = 0;
+    /// @brief Dumps decoded successfully
+    std::uint64_t dumps_decoded = 0;
+    /// @brief Dumps whose decoder failed
+    std::uint64_t dumps_failed = 0;
+};
+
+/// @brief Pipelined bulk dump engine sending every request back to back and matching incoming dumps to outstanding requests.
+/// Matched dumps are decoded on a dedicated thread while the next dumps are still arriving,
+/// so that a full backup takes a single wire time window instead of one round trip per request
+struct dump_pipeline {
+
+    using output = std::function<void(const std::vector<std::uint8_t>&)>;
+    using matcher = std::function<bool(const std::vector<std::uint8_t>&)>;
+    using decoder = std::function<bool(const std::vector<std::uint8_t>&)>;
+
+    dump_pipeline() = default;
+    dump_pipeline(const dump_pipeline&) = delete;
+    dump_pipeline& operator=(const dump_pipeline&) = delete;
+
+    inline ~dump_pipeline()
+    {
+        stop();
+    }
+
+    /// @brief Adds a request to send on the next start()
+    /// @param request Encoded request message
+    /// @param frames Matchers of the frames answered by the hardware, in the order they are sent
+    /// @param decode Decoder called with the matched frames concatenated, from the decode thread
+    inline void add(
+        std::vector<std::uint8_t> request,
+        std::vector<matcher> frames,
+        decoder decode)
+    {
+        std::lock_guard<std::mutex> _lock(_mutex);
+        _requests.push_back(pending { std::move(request), std::move(frames), std::move(decode), {}, 0, false, false });
+    }
+
+    /// @brief Creates a matcher accepting system exclusive frames that start with a prefix
+    /// @param prefix Bytes expected at the start of the frame
+    /// @param mask Bits compared for each byte of the prefix, missing bytes are compared entirely
+    /// @return Matcher
+    inline static matcher match_prefix(
+        std::vector<std::uint8_t> prefix,
+        std::vector<std::uint8_t> mask = {})
+    {
+        return [prefix = std::move(prefix), mask = std::move(mask)](const std::vector<std::uint8_t>& encoded) {
+            if (encoded.size() < prefix.size()) {
+                return false;
+            }
+            for (std::size_t _index = 0; _index < prefix.size(); ++_index) {
+                const std::uint8_t _mask = _index < mask.size() ? mask[_index] : 0xFF;
+                if ((encoded[_index] & _mask) != (prefix[_index] & _mask)) {
+                    return false;
+                }
+            }
+            return true;
+        };
+    }
+
+    /// @brief Starts the decode thread and sends every request back to back, one message per call to the output callback
+    /// @param send Callback sending a single encoded message to the hardware, called from the calling thread
+    inline void start(output send)
+    {
+        stop();
+        std::vector<std::uint8_t> _encoded;
+        {
+            std::lock_guard<std::mutex> _lock(_mutex);
+            _statistics = dump_pipeline_statistics {};
+            _decode_queue.clear();
+            _stop = false;
+            for (pending& _request : _requests) {
+                _request.received.clear();
+                _request.matched = 0;
+                _request.decoded = false;
+                _request.succeeded = false;
+                _encoded.insert(_encoded.end(), _request.request.begin(), _request.request.end());
+            }
+            _statistics.requests_sent = _requests.size();
+        }
+        _thread = std::thread(&dump_pipeline::run, this);
+        // requests leave back to back without waiting for the answers, the hardware queues them
+        std::vector<std::uint8_t> _message;
+        split_messages(_encoded, _message, send);
+    }
+
+    /// @brief Matches a frame received from the hardware to the first outstanding request expecting it.
+    /// Call from the input callback, decoding never happens on the calling thread
+    /// @param encoded Vector to read the encoded system exclusive frame from
+    /// @return true if the frame matched an outstanding request
+    inline bool receive(const std::vector<std::uint8_t>& encoded)
+    {
+        bool _complete = false;
+        {
+            std::lock_guard<std::mutex> _lock(_mutex);
+            std::size_t _index = 0;
+            for (; _index < _requests.size(); ++_index) {
+                pending& _request = _requests[_index];
+                if (_request.matched < _request.frames.size() && _request.frames[_request.matched](encoded)) {
+                    break;
+                }
+            }
+            if (_index == _requests.size()) {
+                ++_statistics.frames_unmatched;
+                return false;
+            }
+            pending& _request = _requests[_index];
+            _request.received.insert(_request.received.end(), encoded.begin(), encoded.end());
+            ++_request.matched;
+            ++_statistics.frames_matched;
+            if (_request.matched == _request.frames.size()) {
+                _decode_queue.push_back(_index);
+                _complete = true;
+            }
+        }
+        if (_complete) {
+            _condition_variable.notify_all();
+        }
+        return true;
+    }
+
+    /// @brief Waits until every request has been answered and decoded
+    /// @param timeout Maximum duration to wait for
+    /// @return true if every dump was received and decoded successfully before the timeout
+    inline bool wait(const std::chrono::milliseconds timeout)
+    {
+        std::unique_lock<std::mutex> _lock(_mutex);
+        _condition_variable.wait_for(_lock, timeout, [this] { return decoded_count() == _requests.size(); });
+        for (const pending& _request : _requests) {
+            if (!_request.succeeded) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// @brief Stops the decode thread. Dumps already queued are decoded first
+    inline void stop()
+    {
+        {
+            std::lock_guard<std::mutex> _lock(_mutex);
+            _stop = true;
+        }
+        _condition_variable.notify_all();
+        if (_thread.joinable()) {
+            _thread.join();
+        }
+    }
+
+    /// @brief Gets a snapshot of the pipeline counters
+    /// @return Counters since the last start()
+    inline dump_pipeline_statistics statistics() const
+    {
+        std::lock_guard<std::mutex> _lock(_mutex);
+        return _statistics;
+    }
+
+private:
+    struct pending {
+        std::vector<std::uint8_t> request;
+        std::vector<matcher> frames;
+        decoder decode;
+        std::vector<std::uint8_t> received;
+        std::size_t matched;
+        bool decoded;
+        bool succeeded;
+    };
+
+    std::deque<pending> _requests;
+    std::deque<std::size_t> _decode_queue;
+    dump_pipeline_statistics _statistics;
+    bool _stop = true;
+    mutable std::mutex _mutex;
+    std::condition_variable _condition_variable;
+    std::thread _thread;
+
+    inline std::size_t decoded_count() const
+    {
+        std::size_t _count = 0;
+        for (const pending& _request : _requests) {
+            _count += _request.decoded ? 1 : 0;
+        }
+        return _count;
+    }
+
+    inline void run()
+    {
+        std::unique_lock<std::mutex> _lock(_mutex);
+        while (true) {
+            _condition_variable.wait(_lock, [this] { return _stop || !_decode_queue.empty(); });
+            if (_decode_queue.empty()) {
+                break;
+            }
+            // requests are stored in a deque so that references stay valid while add() is not called
+            pending& _request = _requests[_decode_queue.front()];
+            _decode_queue.pop_front();
+            _lock.unlock();
+            const bool _succeeded = _request.decode(_request.received);
+            _lock.lock();
+            _request.decoded = true;
+            _request.succeeded = _succeeded;
+            ++(_succeeded ? _statistics.dumps_decoded : _statistics.dumps_failed);
+            _condition_variable.notify_all();
+        }
+    }
+};
+
+}
@@ -0,0 +1,235 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <midispec/core/message_split.hpp>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace midispec {
+
+/// @brief Lateness of the events dispatched by an event scheduler
+struct event_scheduler_statistics {
+    /// @brief Events scheduled
+    std::uint64_t events_scheduled = 0;
+    /// @brief Events dispatched
+    std::uint64_t events_dispatched = 0;
+    /// @brief Wake ups of the dispatch thread, events due together are dispatched back to back in a single wake up
+    std::uint64_t batches_dispatched = 0;
+    /// @brief Mean delay between the event deadline and the event dispatch
+    std::chrono::nanoseconds lateness_mean = std::chrono::nanoseconds(0);
+    /// @brief Root mean square of the delay between the event deadline and the event dispatch
+    std::chrono::nanoseconds lateness_rms = std::chrono::nanoseconds(0);
+    /// @brief Largest delay between the event deadline and the event dispatch
+    std::chrono::nanoseconds lateness_max = std::chrono::nanoseconds(0);
+};
+
+/// @brief Event scheduler dispatching encoded messages to the hardware at their deadlines from a dedicated thread.
+/// Events are kept in a min-heap ordered by deadline then by scheduling order, so that events sharing a deadline
+/// keep the order they were scheduled in. Every event due when the thread wakes up is sent back to back, one message per call to the output callback
+struct event_scheduler {
+
+    using output = std::function<void(const std::vector<std::uint8_t>&)>;
+
+    event_scheduler() = default;
+    event_scheduler(const event_scheduler&) = delete;
+    event_scheduler& operator=(const event_scheduler&) = delete;
+
+    inline ~event_scheduler()
+    {
+        close();
+    }
+
+    /// @brief Starts the dispatch thread, raising its priority when the platform allows it
+    /// @param send Callback sending a single encoded message to the hardware, called from the dispatch thread
+    /// @param spin Duration before each deadline that is busy waited instead of slept for precision
+    inline void open(
+        output send,
+        const std::chrono::microseconds spin = std::chrono::microseconds(500))
+    {
+        close();
+        _send = std::move(send);
+        _spin = spin;
+        _events.clear();
+        _sequence = 0;
+        _statistics = event_scheduler_statistics {};
+        _lateness_sum = 0;
+        _lateness_square_sum = 0;
+        _stop = false;
+        _thread = std::thread(&event_scheduler::run, this);
+    }
+
+    /// @brief Stops the dispatch thread. Events not dispatched yet are dropped
+    inline void close()
+    {
+        {
+            std::lock_guard<std::mutex> _lock(_mutex);
+            _stop = true;
+        }
+        _condition_variable.notify_all();
+        if (_thread.joinable()) {
+            _thread.join();
+        }
+    }
+
+    /// @brief Schedules encoded messages. Events already due are dispatched as soon as possible
+    /// @param deadline Time to dispatch the messages at
+    /// @param encoded Encoded messages to dispatch
+    inline void schedule(
+        const std::chrono::steady_clock::time_point deadline,
+        std::vector<std::uint8_t> encoded)
+    {
+        bool _earliest;
+        {
+            std::lock_guard<std::mutex> _lock(_mutex);
+            _events.push_back(event { deadline, _sequence++, std::move(encoded) });
+            std::push_heap(_events.begin(), _events.end(), later);
+            _earliest = _events.front().sequence == _sequence - 1;
+            ++_statistics.events_scheduled;
+        }
+        // the dispatch thread only needs to wake up earlier when the new event is the earliest
+        if (_earliest) {
+            _condition_variable.notify_all();
+        }
+    }
+
+    /// @brief Schedules messages encoded with any hardware encoder
+    /// @param deadline Time to dispatch the messages at
+    /// @param encode Hardware encoder such as &akai_lpk25::encode_note_on
+    /// @param args Arguments forwarded to the encoder after the encoded vector
+    template <typename Encode, typename... Args>
+    inline void schedule(
+        const std::chrono::steady_clock::time_point deadline,
+        Encode&& encode,
+        Args&&... args)
+    {
+        std::vector<std::uint8_t> _encoded;
+        encode(_encoded, std::forward<Args>(args)...);
+        schedule(deadline, std::move(_encoded));
+    }
+
+    /// @brief Gets the count of events not dispatched yet
+    /// @return Pending events count
+    inline std::size_t pending() const
+    {
+        std::lock_guard<std::mutex> _lock(_mutex);
+        return _events.size();
+    }
+
+    /// @brief Gets a snapshot of the dispatch lateness
+    /// @return Statistics since the last open()
+    inline event_scheduler_statistics statistics() const
+    {
+        std::lock_guard<std::mutex> _lock(_mutex);
+        event_scheduler_statistics _result = _statistics;
+        if (_result.events_dispatched > 0) {
+            _result.lateness_mean = std::chrono::nanoseconds(std::llround(_lateness_sum / _result.events_dispatched));
+            _result.lateness_rms = std::chrono::nanoseconds(std::llround(std::sqrt(_lateness_square_sum / _result.events_dispatched)));
+        }
+        return _result;
+    }
+
+private:
+    struct event {
+        std::chrono::steady_clock::time_point deadline;
+        std::uint64_t sequence;
+        std::vector<std::uint8_t> encoded;
+    };
+
+    output _send;
+    std::chrono::microseconds _spin;
+    std::vector<event> _events;
+    std::uint64_t _sequence;
+    event_scheduler_statistics _statistics;
+    double _lateness_sum;
+    double _lateness_square_sum;
+    bool _stop;
+    mutable std::mutex _mutex;
+    std::condition_variable _condition_variable;
+    std::thread _thread;
+
+    inline static bool later(const event& first, const event& second)
+    {
+        if (first.deadline != second.deadline) {
+            return first.deadline > second.deadline;
+        }
+        return first.sequence > second.sequence;
+    }
+
+    inline static void raise_priority()
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        // realtime scheduling usually requires privileges, the thread keeps its priority on failure
+        sched_param _parameters {};
+        _parameters.sched_priority = sched_get_priority_max(SCHED_FIFO);
+        pthread_setschedparam(pthread_self(), SCHED_FIFO, &_parameters);
+#endif
+    }
+
+    inline void run()
+    {
+        raise_priority();
+        std::vector<std::uint8_t> _batch;
+        std::vector<std::uint8_t> _message;
+        std::vector<std::chrono::steady_clock::time_point> _deadlines;
+        std::unique_lock<std::mutex> _lock(_mutex);
+        while (!_stop) {
+            if (_events.empty()) {
+                _condition_variable.wait(_lock, [this] { return _stop || !_events.empty(); });
+                continue;
+            }
+            const std::chrono::steady_clock::time_point _deadline = _events.front().deadline;
+            if (std::chrono::steady_clock::now() < _deadline - _spin) {
+                // wakes up early when stopping or when an earlier event is scheduled
+                _condition_variable.wait_until(_lock, _deadline - _spin);
+                continue;
+            }
+
+            _lock.unlock();
+            while (std::chrono::steady_clock::now() < _deadline) {
+            }
+            _lock.lock();
+
+            // every event due by now goes out in the same batch
+            const std::chrono::steady_clock::time_point _now = std::chrono::steady_clock::now();
+            _batch.clear();
+            _deadlines.clear();
+            while (!_events.empty() && _events.front().deadline <= _now) {
+                std::pop_heap(_events.begin(), _events.end(), later);
+                _batch.insert(_batch.end(), _events.back().encoded.begin(), _events.back().encoded.end());
+                _deadlines.push_back(_events.back().deadline);
+                _events.pop_back();
+            }
+            _lock.unlock();
+
+            split_messages(_batch, _message, _send);
+            const std::chrono::steady_clock::time_point _sent = std::chrono::steady_clock::now();
+
+            _lock.lock();
+            ++_statistics.batches_dispatched;
+            for (const std::chrono::steady_clock::time_point& _event_deadline : _deadlines) {
+                const std::chrono::nanoseconds _lateness = _sent - _event_deadline;
+                const double _value = static_cast<double>(_lateness.count());
+                ++_statistics.events_dispatched;
+                _lateness_sum += _value;
+                _lateness_square_sum += _value * _value;
+                if (_lateness > _statistics.lateness_max) {
+                    _statistics.lateness_max = _lateness;
+                }
+            }
+        }
+    }
+};
+
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace midispec {
+
+/// @brief Read only memory mapping of a whole file
+struct file_mapping {
+
+    file_mapping() = default;
+    file_mapping(const file_mapping&) = delete;
+    file_mapping& operator=(const file_mapping&) = delete;
+
+    inline ~file_mapping()
+    {
+        close();
+    }
+
+    /// @brief Maps a file
+    /// @param path Path of the file to map
+    /// @param sequential Hints the system that the file will be read front to back
+    /// @return true on success, empty files fail to map
+    inline bool open(const std::string& path, const bool sequential = true)
+    {
+        close();
+#if defined(_WIN32)
+        (void)sequential;
+        _file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (_file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        LARGE_INTEGER _file_size;
+        if (!GetFileSizeEx(_file, &_file_size) || _file_size.QuadPart == 0) {
+            close();
+            return false;
+        }
+        _mapping = CreateFileMappingA(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (_mapping == nullptr) {
+            close();
+            return false;
+        }
+        _data = static_cast<const std::uint8_t*>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+        if (_data == nullptr) {
+            close();
+            return false;
+        }
+        _size = static_cast<std::size_t>(_file_size.QuadPart);
+#else
+        const int _descriptor = ::open(path.c_str(), O_RDONLY);
+        if (_descriptor < 0) {
+            return false;
+        }
+        struct stat _status;
+        if (fstat(_descriptor, &_status) != 0 || _status.st_size == 0) {
+            ::close(_descriptor);
+            return false;
+        }
+        void* _address = mmap(nullptr, static_cast<std::size_t>(_status.st_size), PROT_READ, MAP_PRIVATE, _descriptor, 0);
+        ::close(_descriptor);
+        if (_address == MAP_FAILED) {
+            return false;
+        }
+        if (sequential) {
+            madvise(_address, static_cast<std::size_t>(_status.st_size), MADV_SEQUENTIAL);
+        }
+        _data = static_cast<const std::uint8_t*>(_address);
+        _size = static_cast<std::size_t>(_status.st_size);
+#endif
+        return true;
+    }
+
+    /// @brief Unmaps the file, pointers into the mapping become invalid
+    inline void close()
+    {
+#if defined(_WIN32)
+        if (_data != nullptr) {
+            UnmapViewOfFile(_data);
+        }
+        if (_mapping != nullptr) {
+            CloseHandle(_mapping);
+        }
+        if (_file != INVALID_HANDLE_VALUE) {
+            CloseHandle(_file);
+        }
+        _mapping = nullptr;
+        _file = INVALID_HANDLE_VALUE;
+#else
+        if (_data != nullptr) {
+            munmap(const_cast<std::uint8_t*>(_data), _size);
+        }
+#endif
+        _data = nullptr;
+        _size = 0;
+    }
+
+    /// @brief Gets the mapped contents
+    /// @return Pointer to the first byte, nullptr when nothing is mapped
+    inline const std::uint8_t* data() const
+    {
+        return _data;
+    }
+
+    /// @brief Gets the mapped size
+    /// @return Size in bytes
+    inline std::size_t size() const
+    {
+        return _size;
+    }
+
+private:
+    const std::uint8_t* _data = nullptr;
+    std::size_t _size = 0;
+#if defined(_WIN32)
+    HANDLE _file = INVALID_HANDLE_VALUE;
+    HANDLE _mapping = nullptr;
+#endif
+};
+
+}
@@ -10,6 +10,10 @@
 #include <memory>
 #include <mutex>
 #include <random>
+#include <thread>
+
+#include <midispec/core/metrics.hpp>
+#include <midispec/core/transaction_port.hpp>
 
 namespace midispec {
 
@@ -25,7 +29,9 @@ struct gtest_hardware : public testing::Test {
         const bool clear = true,
         const std::chrono::milliseconds debounce = std::chrono::milliseconds(50))
     {
+        const std::chrono::steady_clock::time_point _start = std::chrono::steady_clock::now();
         _midi_out->sendMessage(&encoded);
+        metrics<gtest_hardware>::count_sent(encoded, std::chrono::steady_clock::now() - _start);
         if (clear) {
             encoded.clear();
         }
@@ -40,6 +46,7 @@ struct gtest_hardware : public testing::Test {
         std::vector<std::uint8_t>& encoded,
         const std::chrono::milliseconds timeout = std::chrono::milliseconds(5000))
     {
+        const std::chrono::steady_clock::time_point _start = std::chrono::steady_clock::now();
         std::unique_lock<std::mutex> _lock(_mutex);
         if (!_condition_variable.wait_for(_lock, timeout, [] { return _stop || !_queue.empty(); })) {
             return false;
@@ -50,6 +57,7 @@ struct gtest_hardware : public testing::Test {
             if (!_queue.empty() && !_queue.front().empty() && _queue.front().front() == 0xF0) {
                 encoded = std::move(_queue.front());
                 _queue.pop_front();
+                metrics<gtest_hardware>::count_received(encoded, std::chrono::steady_clock::now() - _start);
                 return true;
             }
             if (_queue.empty()) {
@@ -66,6 +74,20 @@ struct gtest_hardware : public testing::Test {
         return false;
     }
 
+    /// @brief Sends a request without waiting and registers it for its reply.
+    /// Replies are routed to the returned future instead of receive()
+    /// @param request Encoded system exclusive request
+    /// @param reply Matcher accepting the reply, an empty matcher accepts the first reply from the same manufacturer
+    /// @param timeout Duration after which the future receives an empty reply
+    /// @return Future receiving the encoded reply
+    inline static std::future<std::vector<std::uint8_t>> transact(
+        const std::vector<std::uint8_t>& request,
+        transaction_port::matcher reply = {},
+        const std::chrono::milliseconds timeout = std::chrono::milliseconds(5000))
+    {
+        return _transactions.transact(request, std::move(reply), timeout);
+    }
+
 protected:
     inline static void SetUpTestSuite()
     {
@@ -103,6 +125,11 @@ protected:
         _midi_in->ignoreTypes(false, true, true);
         _midi_in->setCallback(&gtest_hardware::midi_in_cb, nullptr);
         _midi_out->openPort(_out_index);
+        _transactions.open([](const std::vector<std::uint8_t>& encoded) {
+            const std::chrono::steady_clock::time_point _start = std::chrono::steady_clock::now();
+            _midi_out->sendMessage(&encoded);
+            metrics<gtest_hardware>::count_sent(encoded, std::chrono::steady_clock::now() - _start);
+        });
     }
 
     inline static void TearDownTestSuite()
@@ -112,6 +139,7 @@ protected:
             _stop = true;
         }
         _condition_variable.notify_all();
+        _transactions.close();
         _midi_in.reset();
         _midi_out.reset();
     }
@@ -132,6 +160,7 @@ private:
     inline static std::mutex _mutex;
     inline static std::condition_variable _condition_variable;
     inline static std::deque<std::vector<std::uint8_t>> _queue;
+    inline static transaction_port _transactions;
     inline static bool _stop;
 
     inline static void midi_in_cb(double, std::vector<std::uint8_t>* message, void*)
@@ -154,7 +183,9 @@ private:
             _accumulated.push_back(_byte);
 
             if (_byte == 0xF7) {
-                _queue.push_back(_accumulated);
+                if (!_transactions.receive(_accumulated)) {
+                    _queue.push_back(_accumulated);
+                }
                 _accumulated.clear();
             }
         }
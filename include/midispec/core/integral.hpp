@@ -60,11 +60,11 @@ struct integral {
         if constexpr (std::is_integral_v<T>) {
             static_assert(!std::is_same_v<T, bool>, "Requires not bool");
             using WideT = std::conditional_t<std::is_signed_v<T>, long long, unsigned long long>;
-            const std::uniform_int_distribution<WideT> _distribution(static_cast<WideT>(MinValue), static_cast<WideT>(MaxValue));
+            std::uniform_int_distribution<WideT> _distribution(static_cast<WideT>(MinValue), static_cast<WideT>(MaxValue));
             return integral(_clamp(static_cast<T>(_distribution(random_device))));
 
         } else if constexpr (std::is_floating_point_v<T>) {
-            const std::uniform_real_distribution<T> _distribution(MinValue, MaxValue);
+            std::uniform_real_distribution<T> _distribution(MinValue, MaxValue);
             return integral(_clamp(_distribution(random_device)));
 
         } else {
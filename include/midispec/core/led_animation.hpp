@@ -0,0 +1,172 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <midispec/core/integral.hpp>
+#include <midispec/core/message_split.hpp>
+
+namespace midispec {
+
+/// @brief Counters of a LED animation
+struct led_animation_statistics {
+    /// @brief Frames submitted by the producer
+    std::uint64_t frames_submitted = 0;
+    /// @brief Frames flipped to the hardware
+    std::uint64_t frames_flipped = 0;
+    /// @brief Frames replaced by a newer frame before being flipped
+    std::uint64_t frames_merged = 0;
+    /// @brief Ticks skipped because the previous flush exceeded the wire budget
+    std::uint64_t ticks_throttled = 0;
+    /// @brief Ticks skipped because the animation thread woke up too late
+    std::uint64_t ticks_missed = 0;
+};
+
+/// @brief Fixed frame rate LED animation for hardware exposing a double buffered led_framebuffer
+/// (novation_launchpad, novation_launchpads).
+/// Frames are submitted from any thread, rendered into the back buffer and flipped on absolute deadlines.
+/// A frame is only flushed when the wire budget allows it, pending frames are merged into the newest one
+/// @tparam Hardware Hardware struct exposing led_frame, led_framebuffer and encode_led_framebuffer()
+template <typename Hardware>
+struct led_animation {
+
+    using output = std::function<void(const std::vector<std::uint8_t>&)>;
+
+    led_animation() = default;
+    led_animation(const led_animation&) = delete;
+    led_animation& operator=(const led_animation&) = delete;
+
+    inline ~led_animation()
+    {
+        stop();
+    }
+
+    /// @brief Resets the hardware LEDs, switches it to double buffering and starts the animation thread
+    /// @param send Callback sending a single encoded message to the hardware, called from the animation thread
+    /// @param frames_per_second Target frame rate. In range [1, 1000]
+    /// @param wire_bytes_per_second Bandwidth of the link to the hardware (3125 bytes per second for DIN MIDI). At least 1
+    inline void start(
+        output send,
+        const integral<std::uint16_t, 1, 1000> frames_per_second,
+        const std::size_t wire_bytes_per_second = 3125)
+    {
+        stop();
+        _send = std::move(send);
+        _period = std::chrono::nanoseconds(std::chrono::seconds(1)) / frames_per_second.value();
+        // the budget of a tick is counted in 1/fps bytes so that bandwidths below the frame rate still pay back
+        _budget = wire_bytes_per_second > 0 ? wire_bytes_per_second : 1;
+        _frames_per_second = frames_per_second.value();
+        _framebuffer = typename Hardware::led_framebuffer {};
+        _framebuffer.double_buffered = 1;
+        _has_pending = false;
+        _stop = false;
+        _statistics = led_animation_statistics {};
+        _thread = std::thread(&led_animation::run, this);
+    }
+
+    /// @brief Stops the animation thread. The last flipped frame stays displayed
+    inline void stop()
+    {
+        {
+            std::lock_guard<std::mutex> _lock(_mutex);
+            _stop = true;
+        }
+        _condition_variable.notify_all();
+        if (_thread.joinable()) {
+            _thread.join();
+        }
+    }
+
+    /// @brief Submits a frame to be flipped on the next tick. A pending frame not flipped yet is merged into it
+    /// @param frame LED colors to display
+    inline void submit(const typename Hardware::led_frame& frame)
+    {
+        std::lock_guard<std::mutex> _lock(_mutex);
+        if (_has_pending) {
+            ++_statistics.frames_merged;
+        }
+        _pending = frame;
+        _has_pending = true;
+        ++_statistics.frames_submitted;
+    }
+
+    /// @brief Gets a snapshot of the animation counters
+    /// @return Counters since the last start()
+    inline led_animation_statistics statistics() const
+    {
+        std::lock_guard<std::mutex> _lock(_mutex);
+        return _statistics;
+    }
+
+private:
+    output _send;
+    std::chrono::nanoseconds _period;
+    std::size_t _budget;
+    std::size_t _frames_per_second;
+    typename Hardware::led_framebuffer _framebuffer;
+    typename Hardware::led_frame _pending;
+    bool _has_pending = false;
+    bool _stop = true;
+    led_animation_statistics _statistics;
+    mutable std::mutex _mutex;
+    std::condition_variable _condition_variable;
+    std::thread _thread;
+
+    inline void run()
+    {
+        std::vector<std::uint8_t> _encoded;
+        std::vector<std::uint8_t> _message;
+        Hardware::encode_reset(_encoded);
+        Hardware::encode_led_buffers_mode(_encoded, 1);
+        split_messages(_encoded, _message, _send);
+
+        // bytes sent over the budget of previous ticks in 1/fps bytes, paid back before the next flush
+        std::size_t _debt = 0;
+        std::chrono::steady_clock::time_point _deadline = std::chrono::steady_clock::now();
+
+        std::unique_lock<std::mutex> _lock(_mutex);
+        while (!_stop) {
+            _deadline += _period;
+            if (_condition_variable.wait_until(_lock, _deadline, [this] { return _stop; })) {
+                break;
+            }
+
+            // deadlines stay absolute so that wake up jitter never accumulates
+            const std::chrono::steady_clock::time_point _now = std::chrono::steady_clock::now();
+            if (_now - _deadline > _period) {
+                const std::int64_t _missed = (_now - _deadline) / _period;
+                _deadline += _missed * _period;
+                _statistics.ticks_missed += _missed;
+            }
+
+            if (_debt > 0) {
+                _debt = _debt > _budget ? _debt - _budget : 0;
+                ++_statistics.ticks_throttled;
+                continue;
+            }
+            if (!_has_pending) {
+                continue;
+            }
+
+            _framebuffer.back = _pending;
+            _has_pending = false;
+            ++_statistics.frames_flipped;
+            _lock.unlock();
+
+            _encoded.clear();
+            Hardware::encode_led_framebuffer(_encoded, _framebuffer);
+            split_messages(_encoded, _message, _send);
+            const std::size_t _cost = _encoded.size() * _frames_per_second;
+            _debt = _cost > _budget ? _cost - _budget : 0;
+
+            _lock.lock();
+        }
+    }
+};
+
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace midispec {
+
+/// @brief Gets the size of a message from its status byte
+/// @param status Status byte of the message
+/// @return Size of the message including the status byte, or 0 for system exclusive messages that end at 0xF7
+constexpr std::size_t status_size(const std::uint8_t status)
+{
+    if (status == 0xF0) {
+        return 0;
+    } else if (status == 0xF1 || status == 0xF3 || (status & 0xE0) == 0xC0) {
+        return 2;
+    } else if (status == 0xF2 || status < 0xF0) {
+        return 3;
+    }
+    return 1;
+}
+
+/// @brief Gets the size of the encoded message starting at a status byte
+/// @param encoded Pointer to the status byte of the message
+/// @param size Count of bytes available from encoded
+/// @return Size of the message, or 0 if it is truncated or does not start with a status byte
+inline std::size_t message_size(const std::uint8_t* encoded, const std::size_t size)
+{
+    if (size == 0 || !(encoded[0] & 0x80)) {
+        return 0;
+    }
+    if (encoded[0] == 0xF0) {
+        std::size_t _size = 1;
+        while (_size < size && encoded[_size] != 0xF7) {
+            ++_size;
+        }
+        return _size < size ? _size + 1 : 0;
+    }
+    const std::size_t _size = status_size(encoded[0]);
+    return _size <= size ? _size : 0;
+}
+
+/// @brief Calls a callback once per message of concatenated encoded messages, as appended by the hardware encoders.
+/// Some backends such as WinMM reject writes holding more than one short message, so writers hand them over one at a time.
+/// Data bytes following a channel message are sent with its status byte repeated, truncated messages are dropped
+/// @param encoded Encoded messages
+/// @param message Vector receiving each message, keeping its allocation across calls
+/// @param send Callback called with message
+/// @return Count of messages sent
+template <typename Send>
+inline std::size_t split_messages(
+    const std::vector<std::uint8_t>& encoded,
+    std::vector<std::uint8_t>& message,
+    Send&& send)
+{
+    std::size_t _count = 0;
+    std::size_t _offset = 0;
+    std::uint8_t _running_status = 0;
+    while (_offset < encoded.size()) {
+        message.clear();
+        std::size_t _size = message_size(encoded.data() + _offset, encoded.size() - _offset);
+        if (_size != 0) {
+            message.assign(encoded.begin() + _offset, encoded.begin() + _offset + _size);
+            if (encoded[_offset] < 0xF0) {
+                _running_status = encoded[_offset];
+            } else if (encoded[_offset] < 0xF8) {
+                // system common messages cancel running status, realtime messages leave it untouched
+                _running_status = 0;
+            }
+        } else if (!(encoded[_offset] & 0x80) && _running_status != 0) {
+            message.push_back(_running_status);
+            _size = status_size(_running_status) - 1;
+            if (_offset + _size > encoded.size()) {
+                break;
+            }
+            message.insert(message.end(), encoded.begin() + _offset, encoded.begin() + _offset + _size);
+        } else {
+            // stray data bytes and truncated messages are skipped up to the next status byte
+            ++_offset;
+            while (_offset < encoded.size() && !(encoded[_offset] & 0x80)) {
+                ++_offset;
+            }
+            continue;
+        }
+        _offset += _size;
+        send(message);
+        ++_count;
+    }
+    return _count;
+}
+
+}
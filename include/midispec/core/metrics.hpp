@@ -0,0 +1,327 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <midispec/core/capability_matrix.hpp>
+#include <midispec/core/decode_result.hpp>
+
+#if defined(MIDISPEC_METRICS)
+#include <atomic>
+#include <mutex>
+#endif
+
+namespace midispec {
+
+/// @brief Whether metrics are compiled in, enabled by defining MIDISPEC_METRICS (CMake option MIDISPEC_METRICS)
+#if defined(MIDISPEC_METRICS)
+inline constexpr bool metrics_enabled = true;
+#else
+inline constexpr bool metrics_enabled = false;
+#endif
+
+/// @brief Log linear latency histogram in nanoseconds, every bucket covers 1/8 of a power of two
+struct metrics_histogram {
+
+    /// @brief Count of buckets
+    static constexpr std::size_t size = 496;
+
+    /// @brief Samples per bucket
+    std::array<std::uint64_t, size> buckets = {};
+    /// @brief Count of samples
+    std::uint64_t count = 0;
+    /// @brief Sum of the samples in nanoseconds
+    std::uint64_t total = 0;
+
+    /// @brief Gets the bucket of a sample
+    /// @param nanoseconds Sample
+    /// @return Bucket index
+    inline static constexpr std::size_t bucket(const std::uint64_t nanoseconds)
+    {
+        if (nanoseconds < 8) {
+            return static_cast<std::size_t>(nanoseconds);
+        }
+        std::size_t _msb = 3;
+        while (_msb < 63 && (nanoseconds >> (_msb + 1)) != 0) {
+            ++_msb;
+        }
+        return (_msb - 2) * 8 + static_cast<std::size_t>((nanoseconds >> (_msb - 3)) & 7);
+    }
+
+    /// @brief Gets the largest sample a bucket can hold
+    /// @param index Bucket index
+    /// @return Sample in nanoseconds
+    inline static constexpr std::uint64_t highest(const std::size_t index)
+    {
+        if (index < 8) {
+            return index;
+        }
+        const std::size_t _shift = index / 8 - 1;
+        return ((static_cast<std::uint64_t>(8 + index % 8) + 1) << _shift) - 1;
+    }
+
+    /// @brief Gets a percentile of the samples, within 1/8 of its value
+    /// @param fraction Fraction of the samples below the result, in range [0, 1]
+    /// @return Sample in nanoseconds, 0 if the histogram is empty
+    inline std::uint64_t percentile(const double fraction) const
+    {
+        const std::uint64_t _rank = static_cast<std::uint64_t>(fraction * static_cast<double>(count));
+        std::uint64_t _seen = 0;
+        for (std::size_t _index = 0; _index < size; ++_index) {
+            _seen += buckets[_index];
+            if (_seen > _rank || (_seen == count && _seen > 0)) {
+                return highest(_index);
+            }
+        }
+        return 0;
+    }
+};
+
+/// @brief Counters of a hardware aggregated over every thread, indexed by message with message::count standing for other messages
+struct metrics_snapshot {
+    /// @brief Messages encoded
+    std::array<std::uint64_t, static_cast<std::size_t>(message::count) + 1> encoded = {};
+    /// @brief Bytes encoded
+    std::array<std::uint64_t, static_cast<std::size_t>(message::count) + 1> bytes_encoded = {};
+    /// @brief Messages decoded successfully
+    std::array<std::uint64_t, static_cast<std::size_t>(message::count) + 1> decoded = {};
+    /// @brief Messages rejected by a decoder
+    std::array<std::uint64_t, static_cast<std::size_t>(message::count) + 1> rejected = {};
+    /// @brief Messages rejected by a decoder, indexed by decode_error
+    std::array<std::uint64_t, static_cast<std::size_t>(decode_error::count)> rejections = {};
+    /// @brief Writes to the transport, classified by their first message
+    std::array<std::uint64_t, static_cast<std::size_t>(message::count) + 1> sent = {};
+    /// @brief Bytes written to the transport
+    std::array<std::uint64_t, static_cast<std::size_t>(message::count) + 1> bytes_sent = {};
+    /// @brief Messages read from the transport
+    std::array<std::uint64_t, static_cast<std::size_t>(message::count) + 1> received = {};
+    /// @brief Bytes read from the transport
+    std::array<std::uint64_t, static_cast<std::size_t>(message::count) + 1> bytes_received = {};
+    /// @brief Duration of the writes to the transport
+    metrics_histogram send_latency;
+    /// @brief Duration waited for messages read from the transport
+    metrics_histogram receive_latency;
+};
+
+#if defined(MIDISPEC_METRICS)
+namespace detail {
+
+    /// counters are written by their owning thread only, relaxed atomics let snapshots read them without tearing
+    struct metrics_block {
+        static constexpr std::size_t rows = static_cast<std::size_t>(message::count) + 1;
+
+        std::array<std::atomic<std::uint64_t>, rows> encoded = {};
+        std::array<std::atomic<std::uint64_t>, rows> bytes_encoded = {};
+        std::array<std::atomic<std::uint64_t>, rows> decoded = {};
+        std::array<std::atomic<std::uint64_t>, rows> rejected = {};
+        std::array<std::atomic<std::uint64_t>, static_cast<std::size_t>(decode_error::count)> rejections = {};
+        std::array<std::atomic<std::uint64_t>, rows> sent = {};
+        std::array<std::atomic<std::uint64_t>, rows> bytes_sent = {};
+        std::array<std::atomic<std::uint64_t>, rows> received = {};
+        std::array<std::atomic<std::uint64_t>, rows> bytes_received = {};
+        std::array<std::atomic<std::uint64_t>, metrics_histogram::size> send_latency = {};
+        std::array<std::atomic<std::uint64_t>, metrics_histogram::size> receive_latency = {};
+        std::atomic<std::uint64_t> send_total = {};
+        std::atomic<std::uint64_t> receive_total = {};
+
+        inline static void add(std::atomic<std::uint64_t>& counter, const std::uint64_t value)
+        {
+            counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        }
+
+        template <std::size_t Size>
+        inline static void collect(const std::array<std::atomic<std::uint64_t>, Size>& counters, std::array<std::uint64_t, Size>& snapshot)
+        {
+            for (std::size_t _index = 0; _index < Size; ++_index) {
+                snapshot[_index] += counters[_index].load(std::memory_order_relaxed);
+            }
+        }
+
+        inline static void collect(const std::array<std::atomic<std::uint64_t>, metrics_histogram::size>& counters, const std::atomic<std::uint64_t>& total, metrics_histogram& snapshot)
+        {
+            for (std::size_t _index = 0; _index < metrics_histogram::size; ++_index) {
+                const std::uint64_t _count = counters[_index].load(std::memory_order_relaxed);
+                snapshot.buckets[_index] += _count;
+                snapshot.count += _count;
+            }
+            snapshot.total += total.load(std::memory_order_relaxed);
+        }
+
+        inline void collect(metrics_snapshot& snapshot) const
+        {
+            collect(encoded, snapshot.encoded);
+            collect(bytes_encoded, snapshot.bytes_encoded);
+            collect(decoded, snapshot.decoded);
+            collect(rejected, snapshot.rejected);
+            collect(rejections, snapshot.rejections);
+            collect(sent, snapshot.sent);
+            collect(bytes_sent, snapshot.bytes_sent);
+            collect(received, snapshot.received);
+            collect(bytes_received, snapshot.bytes_received);
+            collect(send_latency, send_total, snapshot.send_latency);
+            collect(receive_latency, receive_total, snapshot.receive_latency);
+        }
+    };
+
+    /// every thread owns one block per hardware, blocks of exited threads are folded into a retired snapshot
+    template <typename Hardware>
+    struct metrics_registry {
+        inline static std::mutex mutex;
+        inline static std::vector<const metrics_block*> live;
+        inline static metrics_snapshot retired;
+    };
+
+    template <typename Hardware>
+    struct metrics_local {
+        metrics_block block;
+
+        inline metrics_local()
+        {
+            std::lock_guard<std::mutex> _lock(metrics_registry<Hardware>::mutex);
+            metrics_registry<Hardware>::live.push_back(&block);
+        }
+
+        inline ~metrics_local()
+        {
+            std::lock_guard<std::mutex> _lock(metrics_registry<Hardware>::mutex);
+            block.collect(metrics_registry<Hardware>::retired);
+            std::vector<const metrics_block*>& _live = metrics_registry<Hardware>::live;
+            for (auto _iterator = _live.begin(); _iterator != _live.end(); ++_iterator) {
+                if (*_iterator == &block) {
+                    _live.erase(_iterator);
+                    break;
+                }
+            }
+        }
+
+        inline static metrics_block& get()
+        {
+            thread_local metrics_local _local;
+            return _local.block;
+        }
+    };
+}
+#endif
+
+/// @brief Per hardware counters of encoded, decoded, sent and received messages with latency histograms.
+/// Every thread counts into its own thread local block without locking, snapshot() aggregates them on demand.
+/// Without MIDISPEC_METRICS every function is empty and compiles to nothing
+/// @tparam Hardware Hardware struct or transport the counters belong to
+template <typename Hardware>
+struct metrics {
+
+    /// @brief Counts the messages appended to a vector by an encoder
+    /// @param encoded Vector the encoder appended to
+    /// @param offset Size of the vector before encoding
+    inline static void count_encoded(const std::vector<std::uint8_t>& encoded, const std::size_t offset)
+    {
+#if defined(MIDISPEC_METRICS)
+        if (encoded.size() <= offset) {
+            return;
+        }
+        detail::metrics_block& _block = detail::metrics_local<Hardware>::get();
+        const std::size_t _row = static_cast<std::size_t>(message_of(encoded.data() + offset, encoded.size() - offset));
+        detail::metrics_block::add(_block.encoded[_row], 1);
+        detail::metrics_block::add(_block.bytes_encoded[_row], encoded.size() - offset);
+#else
+        (void)encoded;
+        (void)offset;
+#endif
+    }
+
+    /// @brief Counts a message passed to a decoder, and the reason when it was rejected
+    /// @param encoded Vector the decoder read from
+    /// @param result Result of the decoder
+    inline static void count_decoded(const std::vector<std::uint8_t>& encoded, const decode_result result)
+    {
+#if defined(MIDISPEC_METRICS)
+        detail::metrics_block& _block = detail::metrics_local<Hardware>::get();
+        if (result) {
+            detail::metrics_block::add(_block.decoded[row(encoded)], 1);
+            return;
+        }
+        detail::metrics_block::add(_block.rejected[row(encoded)], 1);
+        detail::metrics_block::add(_block.rejections[static_cast<std::size_t>(result.error())], 1);
+#else
+        (void)encoded;
+        (void)result;
+#endif
+    }
+
+    /// @brief Counts a write to the transport
+    /// @param encoded Encoded messages written
+    /// @param latency Duration of the write
+    inline static void count_sent(const std::vector<std::uint8_t>& encoded, const std::chrono::nanoseconds latency)
+    {
+#if defined(MIDISPEC_METRICS)
+        detail::metrics_block& _block = detail::metrics_local<Hardware>::get();
+        const std::size_t _row = row(encoded);
+        detail::metrics_block::add(_block.sent[_row], 1);
+        detail::metrics_block::add(_block.bytes_sent[_row], encoded.size());
+        detail::metrics_block::add(_block.send_latency[metrics_histogram::bucket(static_cast<std::uint64_t>(latency.count()))], 1);
+        detail::metrics_block::add(_block.send_total, static_cast<std::uint64_t>(latency.count()));
+#else
+        (void)encoded;
+        (void)latency;
+#endif
+    }
+
+    /// @brief Counts a message read from the transport
+    /// @param encoded Encoded message read
+    /// @param latency Duration waited for the message
+    inline static void count_received(const std::vector<std::uint8_t>& encoded, const std::chrono::nanoseconds latency)
+    {
+#if defined(MIDISPEC_METRICS)
+        detail::metrics_block& _block = detail::metrics_local<Hardware>::get();
+        const std::size_t _row = row(encoded);
+        detail::metrics_block::add(_block.received[_row], 1);
+        detail::metrics_block::add(_block.bytes_received[_row], encoded.size());
+        detail::metrics_block::add(_block.receive_latency[metrics_histogram::bucket(static_cast<std::uint64_t>(latency.count()))], 1);
+        detail::metrics_block::add(_block.receive_total, static_cast<std::uint64_t>(latency.count()));
+#else
+        (void)encoded;
+        (void)latency;
+#endif
+    }
+
+    /// @brief Aggregates the counters of every thread, including threads that exited
+    /// @return Counters since the start of the program, zero without MIDISPEC_METRICS
+    inline static metrics_snapshot snapshot()
+    {
+        metrics_snapshot _snapshot;
+#if defined(MIDISPEC_METRICS)
+        std::lock_guard<std::mutex> _lock(detail::metrics_registry<Hardware>::mutex);
+        _snapshot = detail::metrics_registry<Hardware>::retired;
+        for (const detail::metrics_block* _block : detail::metrics_registry<Hardware>::live) {
+            _block->collect(_snapshot);
+        }
+#endif
+        return _snapshot;
+    }
+
+private:
+    inline static std::size_t row(const std::vector<std::uint8_t>& encoded)
+    {
+        return static_cast<std::size_t>(message_of(encoded));
+    }
+};
+
+/// @brief Calls a decoder of a hardware and counts the message passed to it, for decoders called directly by the application
+/// such as bulk dump decoders. Example: decode_counted<yamaha_dx7>(&yamaha_dx7::decode_voice_patch_bank, encoded, device, bank)
+/// @tparam Hardware Hardware struct the counters belong to
+/// @param decode Decoder taking the encoded vector followed by its outputs
+/// @param encoded Vector to decode the message from
+/// @param outputs Outputs of the decoder
+/// @return Result of the decoder
+template <typename Hardware, typename Decode, typename... Outputs>
+inline decode_result decode_counted(Decode&& decode, const std::vector<std::uint8_t>& encoded, Outputs&&... outputs)
+{
+    const decode_result _decoded = decode(encoded, std::forward<Outputs>(outputs)...);
+    metrics<Hardware>::count_decoded(encoded, _decoded);
+    return _decoded;
+}
+
+}
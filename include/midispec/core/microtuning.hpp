@@ -0,0 +1,196 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <midispec/core/integral.hpp>
+#include <midispec/yamaha_tx81z.hpp>
+
+namespace midispec {
+
+/// @brief Tuning engine converting scales into yamaha_tx81z full keyboard microtune tables.
+/// Tables are prepared ahead of time together with their encoded SysEx dump, so that retuning live between pieces
+/// only appends precomputed bytes, and nothing at all when the hardware already holds the requested table.
+/// The TX81Z has no per key microtune parameter change, a full keyboard dump is 274 bytes or about 88 ms at MIDI rate
+struct microtuning {
+
+    using table = yamaha_tx81z::microtune_patch;
+
+    /// @brief Count of fine steps per semitone of the TX81Z
+    static constexpr int fine_steps = 64;
+
+    /// @brief Index reported when no prepared table is known to be held by the hardware
+    static constexpr std::size_t none = static_cast<std::size_t>(-1);
+
+    /// @brief Largest count of pitches accepted from a Scala file
+    static constexpr std::size_t max_degrees = 1024;
+
+    /// @brief Parses the pitches of a Scala scale file. Lines starting with ! are comments, the first other line is the description,
+    /// the second the count of pitches, then one pitch per line as cents when it contains a dot or as a ratio or integer otherwise.
+    /// Files declaring more than max_degrees pitches are rejected before anything is allocated for them
+    /// @param text Contents of the .scl file
+    /// @param degrees Output pitches in cents above the first degree, the last one being the period of the scale
+    /// @return true on success
+    inline static bool parse_scala(const std::string& text, std::vector<double>& degrees)
+    {
+        std::istringstream _stream(text);
+        std::string _line;
+        std::size_t _count = 0;
+        std::size_t _read = 0;
+        std::vector<double> _degrees;
+        while (std::getline(_stream, _line)) {
+            if (!_line.empty() && _line[0] == '!') {
+                continue;
+            }
+            if (_read++ == 0) {
+                continue;
+            }
+            std::istringstream _fields(_line);
+            std::string _pitch;
+            if (!(_fields >> _pitch)) {
+                return false;
+            }
+            if (_read == 2) {
+                _count = std::strtoul(_pitch.c_str(), nullptr, 10);
+                if (_count > max_degrees) {
+                    return false;
+                }
+                _degrees.reserve(_count);
+                continue;
+            }
+            double _cents = 0;
+            if (_pitch.find('.') != std::string::npos) {
+                _cents = std::strtod(_pitch.c_str(), nullptr);
+            } else {
+                const std::size_t _slash = _pitch.find('/');
+                const double _numerator = std::strtod(_pitch.c_str(), nullptr);
+                const double _denominator = _slash != std::string::npos ? std::strtod(_pitch.c_str() + _slash + 1, nullptr) : 1;
+                if (_numerator <= 0 || _denominator <= 0) {
+                    return false;
+                }
+                _cents = 1200 * std::log2(_numerator / _denominator);
+            }
+            _degrees.push_back(_cents);
+            if (_degrees.size() == _count) {
+                break;
+            }
+        }
+        if (_count == 0 || _degrees.size() != _count) {
+            return false;
+        }
+        degrees = std::move(_degrees);
+        return true;
+    }
+
+    /// @brief Converts a scale into a full keyboard microtune table
+    /// @param degrees Pitches in cents above the first degree, the last one being the period of the scale
+    /// @param reference_key Key sounding the first degree of the scale. In range [0, 127] (Default 60)
+    /// @param reference_frequency Frequency of the reference key in Hz (Default 261.6256, middle C in equal temperament)
+    /// @return Table, keys beyond the range of the hardware are clamped to its lowest or highest pitch
+    inline static table tune(
+        const std::vector<double>& degrees,
+        const integral<std::uint8_t, 0, 127> reference_key = 60,
+        const double reference_frequency = 261.6255653)
+    {
+        table _table;
+        if (degrees.empty()) {
+            return _table;
+        }
+        const long _size = static_cast<long>(degrees.size());
+        const double _period = degrees.back();
+        const double _reference_steps = (69 + 12 * std::log2(reference_frequency / 440)) * fine_steps;
+        for (long _key = 0; _key < 128; ++_key) {
+            const long _offset = _key - reference_key.value();
+            const long _octave = (_offset >= 0 ? _offset : _offset - _size + 1) / _size;
+            const long _degree = _offset - _octave * _size;
+            const double _cents = _octave * _period + (_degree > 0 ? degrees[_degree - 1] : 0);
+            set(_table, static_cast<std::size_t>(_key), std::lround(_reference_steps + _cents * fine_steps / 100));
+        }
+        return _table;
+    }
+
+    /// @brief Creates the equal temperament table, with every key sounding its own note
+    /// @return Table
+    inline static table equal_temperament()
+    {
+        table _table;
+        for (std::size_t _key = 0; _key < 128; ++_key) {
+            set(_table, _key, static_cast<long>(_key) * fine_steps);
+        }
+        return _table;
+    }
+
+    /// @brief Precomputes a table and its encoded dump for a later retune()
+    /// @param device Target device number. In range [0, 15]
+    /// @param data Table to prepare
+    /// @return Index to pass to retune()
+    inline std::size_t prepare(const integral<std::uint8_t, 0, 15> device, const table& data)
+    {
+        std::vector<std::uint8_t> _encoded;
+        yamaha_tx81z::encode_microtune_patch(_encoded, device, data);
+        _prepared_tables.push_back(std::move(_encoded));
+        return _prepared_tables.size() - 1;
+    }
+
+    /// @brief Appends the dump of a prepared table, unless the hardware already holds an identical table
+    /// @param encoded Vector to append the encoded SysEx message to
+    /// @param index Index returned by prepare()
+    /// @return true if a dump was appended
+    inline bool retune(std::vector<std::uint8_t>& encoded, const std::size_t index)
+    {
+        if (index >= _prepared_tables.size() || index == _current) {
+            return false;
+        }
+        const std::vector<std::uint8_t>& _prepared = _prepared_tables[index];
+        if (_current != none && _prepared == _prepared_tables[_current]) {
+            _current = index;
+            return false;
+        }
+        encoded.insert(encoded.end(), _prepared.begin(), _prepared.end());
+        _current = index;
+        return true;
+    }
+
+    /// @brief Records the table held by the hardware after a dump that did not go through retune(), such as a decoded reply
+    /// @param index Index returned by prepare(), or none if the table held by the hardware is unknown
+    inline void assume(const std::size_t index)
+    {
+        _current = index < _prepared_tables.size() ? index : none;
+    }
+
+    /// @brief Gets the prepared table the hardware holds
+    /// @return Index returned by prepare(), or none if unknown
+    inline std::size_t current() const
+    {
+        return _current;
+    }
+
+    /// @brief Gets the frequency a table makes a key sound
+    /// @param data Table
+    /// @param key Key. In range [0, 127]
+    /// @return Frequency in Hz
+    inline static double frequency(const table& data, const integral<std::uint8_t, 0, 127> key)
+    {
+        const double _note = data.key_note[key.value()].value() + data.key_fine[key.value()].value() / static_cast<double>(fine_steps);
+        return 440 * std::exp2((_note - 69) / 12);
+    }
+
+private:
+    std::vector<std::vector<std::uint8_t>> _prepared_tables;
+    std::size_t _current = none;
+
+    inline static void set(table& data, const std::size_t key, const long steps)
+    {
+        constexpr long _lowest = 13 * fine_steps;
+        constexpr long _highest = 108 * fine_steps + fine_steps - 1;
+        const long _steps = steps < _lowest ? _lowest : (steps > _highest ? _highest : steps);
+        data.key_note[key] = static_cast<std::uint8_t>(_steps / fine_steps);
+        data.key_fine[key] = static_cast<std::uint8_t>(_steps % fine_steps);
+    }
+};
+
+}
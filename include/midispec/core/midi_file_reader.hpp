@@ -0,0 +1,351 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <midispec/core/file_mapping.hpp>
+#include <midispec/core/integral.hpp>
+
+namespace midispec {
+
+/// @brief Event read from a Standard MIDI File. Data points into the file mapping and stays valid until the reader is closed
+struct midi_file_event {
+    /// @brief Absolute time in ticks since the start of the file
+    std::uint64_t tick = 0;
+    /// @brief Absolute time since the start of the file, following the tempo changes read so far
+    std::chrono::microseconds time = std::chrono::microseconds(0);
+    /// @brief Index of the track chunk the event was read from
+    std::uint16_t track = 0;
+    /// @brief Status byte, resolved from running status. 0x80 to 0xEF for channel messages,
+    /// 0xF0 and 0xF7 for system exclusive, 0xFF for meta events
+    std::uint8_t status = 0;
+    /// @brief Meta event type when status is 0xFF
+    std::uint8_t meta_type = 0;
+    /// @brief Data bytes following the status byte, or the length field for system exclusive and meta events
+    const std::uint8_t* data = nullptr;
+    /// @brief Count of data bytes
+    std::size_t size = 0;
+
+    /// @brief Gets the channel of a channel message
+    /// @return MIDI channel
+    inline integral<std::uint8_t, 0, 15> channel() const
+    {
+        return status & 0x0F;
+    }
+
+    /// @brief Encodes the event as it is sent over the wire. Meta events encode nothing
+    /// @param encoded Vector to append the encoded message to
+    inline void encode(std::vector<std::uint8_t>& encoded) const
+    {
+        if (status == 0xFF) {
+            return;
+        }
+        // escaped system exclusive packets are sent as is, without the 0xF7 prefix
+        if (status != 0xF7) {
+            encoded.push_back(status);
+        }
+        encoded.insert(encoded.end(), data, data + size);
+    }
+};
+
+/// @brief Streaming Standard MIDI File reader (format 0 and 1) over a read only memory mapping.
+/// Tracks are parsed lazily, only the next event of each track is decoded, and merged in time order
+/// through a min-heap so that memory stays proportional to the track count whatever the file size
+struct midi_file_reader {
+
+    midi_file_reader() = default;
+    midi_file_reader(const midi_file_reader&) = delete;
+    midi_file_reader& operator=(const midi_file_reader&) = delete;
+
+    inline ~midi_file_reader()
+    {
+        close();
+    }
+
+    /// @brief Maps a Standard MIDI File and reads its header and track chunk locations
+    /// @param path Path of the file to map
+    /// @return true on success
+    inline bool open(const std::string& path)
+    {
+        close();
+        if (!_mapping.open(path)) {
+            return false;
+        }
+        if (!open(_mapping.data(), _mapping.size())) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    /// @brief Reads the header and track chunk locations of a Standard MIDI File already in memory.
+    /// The buffer must outlive the reader
+    /// @param data Pointer to the file contents
+    /// @param size Size of the file contents
+    /// @return true on success
+    inline bool open(const std::uint8_t* data, const std::size_t size)
+    {
+        _data = data;
+        _size = size;
+        _tracks.clear();
+        _heap.clear();
+        if (size < 14 || !chunk_is(data, "MThd") || read_32(data + 4) < 6) {
+            return false;
+        }
+        _format = read_16(data + 8);
+        const std::uint16_t _declared_tracks = read_16(data + 10);
+        _division = read_16(data + 12);
+        if (_format > 1) {
+            return false;
+        }
+
+        std::size_t _offset = 8 + read_32(data + 4);
+        while (_offset + 8 <= size && _tracks.size() < _declared_tracks) {
+            const std::size_t _length = read_32(data + _offset + 4);
+            const std::size_t _begin = _offset + 8;
+            const std::size_t _end = std::min(_begin + _length, size);
+            // unknown chunks are skipped as the specification requires
+            if (chunk_is(data + _offset, "MTrk")) {
+                track _track;
+                _track.begin = _begin;
+                _track.end = _end;
+                _tracks.push_back(_track);
+            }
+            _offset = _begin + _length;
+        }
+        rewind();
+        return true;
+    }
+
+    /// @brief Unmaps the file
+    inline void close()
+    {
+        _mapping.close();
+        _data = nullptr;
+        _size = 0;
+        _tracks.clear();
+        _heap.clear();
+    }
+
+    /// @brief Gets the file format
+    /// @return 0 for a single track, 1 for simultaneous tracks
+    inline std::uint16_t format() const
+    {
+        return _format;
+    }
+
+    /// @brief Gets the count of track chunks
+    /// @return Track count
+    inline std::size_t tracks() const
+    {
+        return _tracks.size();
+    }
+
+    /// @brief Gets the time division from the header
+    /// @return Ticks per quarter note, or SMPTE format and ticks per frame when the high bit is set
+    inline std::uint16_t division() const
+    {
+        return _division;
+    }
+
+    /// @brief Restarts reading from the beginning of every track
+    inline void rewind()
+    {
+        _heap.clear();
+        for (std::size_t _index = 0; _index < _tracks.size(); ++_index) {
+            track& _track = _tracks[_index];
+            _track.position = _track.begin;
+            _track.tick = 0;
+            _track.running_status = 0;
+            if (advance(_track)) {
+                _heap.push_back(static_cast<std::uint16_t>(_index));
+            }
+        }
+        std::make_heap(_heap.begin(), _heap.end(), later_track { this });
+        _tempo = 500000;
+        _last_tick = 0;
+        _elapsed = 0;
+        _remainder = 0;
+    }
+
+    /// @brief Reads the next event in time order across all tracks. Events sharing a tick come in track order
+    /// @param event Event to read into
+    /// @return true until the end of every track
+    inline bool next(midi_file_event& event)
+    {
+        while (!_heap.empty()) {
+            std::pop_heap(_heap.begin(), _heap.end(), later_track { this });
+            const std::uint16_t _index = _heap.back();
+            track& _track = _tracks[_index];
+            if (!parse(_track, event)) {
+                // truncated or malformed tracks end at the first event that cannot be read
+                _heap.pop_back();
+                continue;
+            }
+            event.track = _index;
+            event.time = time_at(event.tick);
+            if (event.status == 0xFF && event.meta_type == 0x51 && event.size == 3) {
+                _tempo = (static_cast<std::uint32_t>(event.data[0]) << 16) | (static_cast<std::uint32_t>(event.data[1]) << 8) | event.data[2];
+            }
+            if (event.status == 0xFF && event.meta_type == 0x2F) {
+                _heap.pop_back();
+            } else if (advance(_track)) {
+                std::push_heap(_heap.begin(), _heap.end(), later_track { this });
+            } else {
+                _heap.pop_back();
+            }
+            return true;
+        }
+        return false;
+    }
+
+private:
+    struct track {
+        std::size_t begin;
+        std::size_t end;
+        std::size_t position;
+        std::uint64_t tick;
+        std::uint8_t running_status;
+    };
+
+    file_mapping _mapping;
+    const std::uint8_t* _data = nullptr;
+    std::size_t _size = 0;
+    std::uint16_t _format = 0;
+    std::uint16_t _division = 0;
+    std::vector<track> _tracks;
+    std::vector<std::uint16_t> _heap;
+    std::uint32_t _tempo = 500000;
+    std::uint64_t _last_tick = 0;
+    std::uint64_t _elapsed = 0;
+    std::uint64_t _remainder = 0;
+
+    /// orders the heap by next event tick, then by track index so that simultaneous events keep the file order
+    struct later_track {
+        const midi_file_reader* reader;
+
+        inline bool operator()(const std::uint16_t first, const std::uint16_t second) const
+        {
+            if (reader->_tracks[first].tick != reader->_tracks[second].tick) {
+                return reader->_tracks[first].tick > reader->_tracks[second].tick;
+            }
+            return first > second;
+        }
+    };
+
+    inline static bool chunk_is(const std::uint8_t* data, const char* name)
+    {
+        return data[0] == name[0] && data[1] == name[1] && data[2] == name[2] && data[3] == name[3];
+    }
+
+    inline static std::uint16_t read_16(const std::uint8_t* data)
+    {
+        return static_cast<std::uint16_t>((data[0] << 8) | data[1]);
+    }
+
+    inline static std::uint32_t read_32(const std::uint8_t* data)
+    {
+        return (static_cast<std::uint32_t>(data[0]) << 24) | (static_cast<std::uint32_t>(data[1]) << 16) | (static_cast<std::uint32_t>(data[2]) << 8) | data[3];
+    }
+
+    inline bool read_variable_length(track& target, std::uint32_t& value) const
+    {
+        value = 0;
+        for (std::size_t _count = 0; _count < 4; ++_count) {
+            if (target.position >= target.end) {
+                return false;
+            }
+            const std::uint8_t _byte = _data[target.position++];
+            value = (value << 7) | (_byte & 0x7F);
+            if (!(_byte & 0x80)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// reads the delta time of the next event so that the track can be ordered in the heap
+    inline bool advance(track& target) const
+    {
+        std::uint32_t _delta;
+        if (!read_variable_length(target, _delta)) {
+            return false;
+        }
+        target.tick += _delta;
+        return true;
+    }
+
+    inline bool parse(track& target, midi_file_event& event) const
+    {
+        if (target.position >= target.end) {
+            return false;
+        }
+        event.tick = target.tick;
+        event.meta_type = 0;
+        std::uint8_t _status = _data[target.position];
+        if (_status & 0x80) {
+            ++target.position;
+        } else if (target.running_status != 0) {
+            _status = target.running_status;
+        } else {
+            return false;
+        }
+        event.status = _status;
+
+        if (_status == 0xFF) {
+            if (target.position >= target.end) {
+                return false;
+            }
+            event.meta_type = _data[target.position++];
+        }
+        if (_status >= 0xF0) {
+            // system exclusive and meta events cancel running status
+            target.running_status = 0;
+            std::uint32_t _length;
+            if ((_status != 0xF0 && _status != 0xF7 && _status != 0xFF) || !read_variable_length(target, _length) || target.position + _length > target.end) {
+                return false;
+            }
+            event.data = _data + target.position;
+            event.size = _length;
+            target.position += _length;
+            return true;
+        }
+
+        target.running_status = _status;
+        const std::size_t _length = (_status & 0xE0) == 0xC0 ? 1 : 2;
+        if (target.position + _length > target.end) {
+            return false;
+        }
+        event.data = _data + target.position;
+        event.size = _length;
+        target.position += _length;
+        return true;
+    }
+
+    inline std::chrono::microseconds time_at(const std::uint64_t tick)
+    {
+        const std::uint64_t _ticks = tick - _last_tick;
+        _last_tick = tick;
+        if (_division & 0x8000) {
+            // smpte division, frames per second is stored negated and 29 stands for 29.97 drop frame
+            const std::uint64_t _frames = static_cast<std::uint64_t>(-static_cast<std::int8_t>(_division >> 8));
+            const std::uint64_t _per_frame = _division & 0xFF;
+            const std::uint64_t _numerator = _frames == 29 ? 100000000ULL : 1000000ULL;
+            const std::uint64_t _denominator = (_frames == 29 ? 2997ULL : _frames) * _per_frame;
+            const std::uint64_t _total = _ticks * _numerator + _remainder;
+            _elapsed += _denominator == 0 ? 0 : _total / _denominator;
+            _remainder = _denominator == 0 ? 0 : _total % _denominator;
+        } else {
+            // remainders are carried so that rounding never accumulates across tempo changes
+            const std::uint64_t _total = _ticks * _tempo + _remainder;
+            _elapsed += _division == 0 ? 0 : _total / _division;
+            _remainder = _division == 0 ? 0 : _total % _division;
+        }
+        return std::chrono::microseconds(_elapsed);
+    }
+};
+
+}
@@ -0,0 +1,246 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace midispec {
+
+/// @brief Counters of a Standard MIDI File recorder
+struct midi_file_recorder_statistics {
+    /// @brief Messages written to the track
+    std::uint64_t events_recorded = 0;
+    /// @brief Realtime and system common messages that cannot be stored in a Standard MIDI File
+    std::uint64_t events_skipped = 0;
+    /// @brief Messages dropped because the capture chunk was full while the writer thread was behind
+    std::uint64_t events_dropped = 0;
+    /// @brief Bytes written to the file
+    std::uint64_t bytes_written = 0;
+    /// @brief Writes that failed, the file is incomplete when non zero
+    std::uint64_t write_errors = 0;
+};
+
+/// @brief Standard MIDI File recorder writing timestamped messages received from the hardware as a single format 0 track.
+/// Messages are serialized with running status on the capture thread into a preallocated chunk that is swapped with
+/// the writer thread, so that the capture thread never waits on disk and memory stays bounded whatever the session length.
+/// Messages that do not fit in the capture chunk while the writer is behind are dropped and counted, the time they
+/// would have taken is carried by the next recorded message. The track length is fixed up on close
+struct midi_file_recorder {
+
+    midi_file_recorder() = default;
+    midi_file_recorder(const midi_file_recorder&) = delete;
+    midi_file_recorder& operator=(const midi_file_recorder&) = delete;
+
+    inline ~midi_file_recorder()
+    {
+        close();
+    }
+
+    /// @brief Creates the file, writes the header and tempo and starts the writer thread
+    /// @param path Path of the file to create
+    /// @param origin Time that maps to the start of the file
+    /// @param ticks_per_quarter Time division. In range [1, 32767]
+    /// @param tempo Microseconds per quarter note written as the file tempo
+    /// @param chunk_size Bytes preallocated for each of the two swapped chunks, messages that would grow the capture chunk beyond it are dropped
+    /// @return true on success
+    inline bool open(
+        const std::string& path,
+        const std::chrono::steady_clock::time_point origin,
+        const std::uint16_t ticks_per_quarter = 480,
+        const std::uint32_t tempo = 500000,
+        const std::size_t chunk_size = 65536)
+    {
+        close();
+        _file = std::fopen(path.c_str(), "wb");
+        if (_file == nullptr) {
+            return false;
+        }
+        _origin = origin;
+        _ticks_per_quarter = ticks_per_quarter == 0 ? 1 : (ticks_per_quarter > 0x7FFF ? 0x7FFF : ticks_per_quarter);
+        _tempo = tempo == 0 ? 500000 : tempo;
+        _last_tick = 0;
+        _running_status = 0;
+        _track_size = 0;
+        _statistics = midi_file_recorder_statistics {};
+        _capture.clear();
+        _capture.reserve(chunk_size);
+        _writing.clear();
+        _writing.reserve(chunk_size);
+        _chunk_size = chunk_size;
+
+        const std::uint8_t _header[22] = {
+            'M', 'T', 'h', 'd', 0x00, 0x00, 0x00, 0x06,
+            0x00, 0x00, 0x00, 0x01,
+            static_cast<std::uint8_t>(_ticks_per_quarter >> 8), static_cast<std::uint8_t>(_ticks_per_quarter & 0xFF),
+            'M', 'T', 'r', 'k', 0x00, 0x00, 0x00, 0x00
+        };
+        write(_header, sizeof(_header));
+        const std::uint8_t _tempo_event[7] = {
+            0x00, 0xFF, 0x51, 0x03,
+            static_cast<std::uint8_t>((_tempo >> 16) & 0xFF), static_cast<std::uint8_t>((_tempo >> 8) & 0xFF), static_cast<std::uint8_t>(_tempo & 0xFF)
+        };
+        write(_tempo_event, sizeof(_tempo_event));
+        _track_size += sizeof(_tempo_event);
+
+        _stop = false;
+        _thread = std::thread(&midi_file_recorder::run, this);
+        return true;
+    }
+
+    /// @brief Writes pending messages and the end of track, fixes up the track length and closes the file
+    inline void close()
+    {
+        {
+            std::lock_guard<std::mutex> _lock(_mutex);
+            _stop = true;
+        }
+        _condition_variable.notify_all();
+        if (_thread.joinable()) {
+            _thread.join();
+        }
+        if (_file == nullptr) {
+            return;
+        }
+
+        const std::uint8_t _end_of_track[4] = { 0x00, 0xFF, 0x2F, 0x00 };
+        write(_end_of_track, sizeof(_end_of_track));
+        _track_size += sizeof(_end_of_track);
+        const std::uint8_t _length[4] = {
+            static_cast<std::uint8_t>((_track_size >> 24) & 0xFF), static_cast<std::uint8_t>((_track_size >> 16) & 0xFF),
+            static_cast<std::uint8_t>((_track_size >> 8) & 0xFF), static_cast<std::uint8_t>(_track_size & 0xFF)
+        };
+        if (std::fseek(_file, 18, SEEK_SET) != 0 || std::fwrite(_length, 1, sizeof(_length), _file) != sizeof(_length)) {
+            ++_statistics.write_errors;
+        }
+        std::fclose(_file);
+        _file = nullptr;
+    }
+
+    /// @brief Records a message received from the hardware. Never waits on disk
+    /// @param encoded Vector to read the encoded message from, holding a single channel or system exclusive message
+    /// @param timestamp Time the message was received at
+    inline void record(
+        const std::vector<std::uint8_t>& encoded,
+        const std::chrono::steady_clock::time_point timestamp)
+    {
+        std::unique_lock<std::mutex> _lock(_mutex);
+        if (_file == nullptr || _stop) {
+            return;
+        }
+        if (encoded.empty() || encoded[0] < 0x80 || (encoded[0] >= 0xF1)) {
+            ++_statistics.events_skipped;
+            return;
+        }
+
+        // messages from several capture threads may arrive slightly out of order, time never goes backwards
+        const std::int64_t _elapsed = std::chrono::duration_cast<std::chrono::microseconds>(timestamp - _origin).count();
+        const std::uint64_t _tick = _elapsed <= 0 ? 0 : (static_cast<std::uint64_t>(_elapsed) * _ticks_per_quarter + _tempo / 2) / _tempo;
+        const std::uint64_t _delta = _tick > _last_tick ? _tick - _last_tick : 0;
+        // worst case of a 4 byte delta time, a status byte and a 4 byte system exclusive length
+        if (_capture.size() + 9 + encoded.size() > _chunk_size) {
+            ++_statistics.events_dropped;
+            return;
+        }
+        _last_tick += _delta;
+        const std::size_t _size_before = _capture.size();
+        write_variable_length(_capture, static_cast<std::uint32_t>(_delta > 0x0FFFFFFF ? 0x0FFFFFFF : _delta));
+
+        if (encoded[0] == 0xF0) {
+            _running_status = 0;
+            _capture.push_back(0xF0);
+            write_variable_length(_capture, static_cast<std::uint32_t>(encoded.size() - 1));
+            _capture.insert(_capture.end(), encoded.begin() + 1, encoded.end());
+        } else {
+            if (encoded[0] != _running_status) {
+                _capture.push_back(encoded[0]);
+                _running_status = encoded[0];
+            }
+            _capture.insert(_capture.end(), encoded.begin() + 1, encoded.end());
+        }
+        _track_size += _capture.size() - _size_before;
+        ++_statistics.events_recorded;
+
+        if (_capture.size() >= _chunk_size / 2) {
+            _lock.unlock();
+            _condition_variable.notify_all();
+        }
+    }
+
+    /// @brief Gets a snapshot of the recorder counters
+    /// @return Counters since the last open()
+    inline midi_file_recorder_statistics statistics() const
+    {
+        std::lock_guard<std::mutex> _lock(_mutex);
+        return _statistics;
+    }
+
+private:
+    std::FILE* _file = nullptr;
+    std::chrono::steady_clock::time_point _origin;
+    std::uint16_t _ticks_per_quarter = 480;
+    std::uint32_t _tempo = 500000;
+    std::uint64_t _last_tick = 0;
+    std::uint8_t _running_status = 0;
+    std::uint64_t _track_size = 0;
+    std::size_t _chunk_size = 0;
+    std::vector<std::uint8_t> _capture;
+    std::vector<std::uint8_t> _writing;
+    midi_file_recorder_statistics _statistics;
+    bool _stop = true;
+    mutable std::mutex _mutex;
+    std::condition_variable _condition_variable;
+    std::thread _thread;
+
+    inline static void write_variable_length(std::vector<std::uint8_t>& encoded, std::uint32_t value)
+    {
+        std::uint8_t _bytes[4];
+        std::size_t _count = 0;
+        do {
+            _bytes[_count++] = value & 0x7F;
+            value >>= 7;
+        } while (value != 0);
+        while (_count > 1) {
+            encoded.push_back(_bytes[--_count] | 0x80);
+        }
+        encoded.push_back(_bytes[0]);
+    }
+
+    /// only called from the writer thread or once the writer thread has joined
+    inline void write(const std::uint8_t* data, const std::size_t size)
+    {
+        const std::size_t _written = std::fwrite(data, 1, size, _file);
+        std::lock_guard<std::mutex> _lock(_mutex);
+        _statistics.bytes_written += _written;
+        if (_written != size) {
+            ++_statistics.write_errors;
+        }
+    }
+
+    inline void run()
+    {
+        std::unique_lock<std::mutex> _lock(_mutex);
+        while (true) {
+            // wakes up when half a chunk is filled, or periodically so that a crash loses little
+            _condition_variable.wait_for(_lock, std::chrono::milliseconds(250), [this] { return _stop || _capture.size() >= _chunk_size / 2; });
+            const bool _stopping = _stop;
+            // swapping keeps both capacities so that the capture thread does not allocate in steady state
+            _writing.swap(_capture);
+            _lock.unlock();
+            if (!_writing.empty()) {
+                write(_writing.data(), _writing.size());
+                _writing.clear();
+            }
+            _lock.lock();
+            if (_stopping) {
+                break;
+            }
+        }
+    }
+};
+
+}
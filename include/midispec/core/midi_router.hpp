@@ -0,0 +1,238 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <midispec/core/capability_matrix.hpp>
+#include <midispec/core/message_split.hpp>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace midispec {
+
+/// @brief Output port of a MIDI router
+struct midi_router_port {
+    /// @brief Callback sending a single encoded message to the port, called from the writer thread of the port only
+    std::function<void(const std::vector<std::uint8_t>&)> send;
+    /// @brief Maximum count of messages waiting in the queue of the port
+    std::size_t capacity = 256;
+    /// @brief CPU the writer thread is pinned to, or -1 to let the system schedule it
+    int cpu = -1;
+    /// @brief Capabilities of the hardware behind the port, typically capability_matrix_v of its hardware struct
+    capability_mask capabilities = ~capability_mask(0);
+};
+
+/// @brief Counters of a MIDI router port
+struct midi_router_statistics {
+    /// @brief Messages waiting in the queue
+    std::size_t depth = 0;
+    /// @brief Largest count of messages that waited in the queue at the same time
+    std::size_t depth_max = 0;
+    /// @brief Messages sent to the port, one per call to its callback
+    std::uint64_t sent = 0;
+    /// @brief Bytes sent to the port
+    std::uint64_t bytes_sent = 0;
+    /// @brief Messages dropped because the queue was full
+    std::uint64_t dropped = 0;
+    /// @brief Messages rejected because the hardware behind the port cannot receive them
+    std::uint64_t rejected = 0;
+};
+
+/// @brief Router fanning encoded messages out to several MIDI output ports.
+/// Every port owns a bounded queue drained by its own writer thread, so that a slow or disconnected port never stalls the others.
+/// Routing never blocks, messages routed to a full queue are dropped and counted
+struct midi_router {
+
+    midi_router() = default;
+    midi_router(const midi_router&) = delete;
+    midi_router& operator=(const midi_router&) = delete;
+
+    inline ~midi_router()
+    {
+        close();
+    }
+
+    /// @brief Starts one writer thread per port
+    /// @param ports Output ports, routed to by their index in this vector
+    inline void open(const std::vector<midi_router_port>& ports)
+    {
+        close();
+        _ports.reserve(ports.size());
+        for (const midi_router_port& _description : ports) {
+            std::unique_ptr<port> _port = std::make_unique<port>();
+            _port->send = _description.send;
+            _port->cpu = _description.cpu;
+            _port->capabilities = _description.capabilities;
+            _port->slots.resize(_description.capacity > 0 ? _description.capacity : 1);
+            _ports.push_back(std::move(_port));
+        }
+        for (std::unique_ptr<port>& _port : _ports) {
+            _port->thread = std::thread(&midi_router::run, _port.get());
+        }
+    }
+
+    /// @brief Stops the writer threads once they sent the message they are busy with. Messages still queued are dropped
+    inline void close()
+    {
+        for (std::unique_ptr<port>& _port : _ports) {
+            {
+                std::lock_guard<std::mutex> _lock(_port->mutex);
+                _port->stop = true;
+            }
+            _port->condition_variable.notify_all();
+        }
+        for (std::unique_ptr<port>& _port : _ports) {
+            if (_port->thread.joinable()) {
+                _port->thread.join();
+            }
+        }
+        _ports.clear();
+    }
+
+    /// @brief Queues encoded messages for a port. Queue slots keep their allocation, so routing stops allocating once every slot fits the largest message
+    /// @param destination Index of the port
+    /// @param encoded Encoded messages, written to the port one message at a time
+    /// @return true if the messages were queued, false if the port does not exist or its queue is full
+    inline bool route(const std::size_t destination, const std::vector<std::uint8_t>& encoded)
+    {
+        if (destination >= _ports.size()) {
+            return false;
+        }
+        port& _port = *_ports[destination];
+        {
+            std::lock_guard<std::mutex> _lock(_port.mutex);
+            if (_port.stop || _port.size == _port.slots.size()) {
+                ++_port.statistics.dropped;
+                return false;
+            }
+            _port.slots[(_port.head + _port.size) % _port.slots.size()].assign(encoded.begin(), encoded.end());
+            ++_port.size;
+            _port.statistics.depth_max = _port.size > _port.statistics.depth_max ? _port.size : _port.statistics.depth_max;
+        }
+        _port.condition_variable.notify_one();
+        return true;
+    }
+
+    /// @brief Queues encoded messages for a port if the hardware behind it has the required capabilities
+    /// @param destination Index of the port
+    /// @param encoded Encoded messages, written to the port one message at a time
+    /// @param required Capabilities the messages need, typically capability_bit(message_of(encoded), capability::receive)
+    /// @return true if the messages were queued, false if the port does not exist, lacks a required capability or its queue is full
+    inline bool route(const std::size_t destination, const std::vector<std::uint8_t>& encoded, const capability_mask required)
+    {
+        if (destination >= _ports.size()) {
+            return false;
+        }
+        port& _port = *_ports[destination];
+        if ((required & ~_port.capabilities) != 0) {
+            std::lock_guard<std::mutex> _lock(_port.mutex);
+            ++_port.statistics.rejected;
+            return false;
+        }
+        return route(destination, encoded);
+    }
+
+    /// @brief Queues encoded messages for every port
+    /// @param encoded Encoded messages, written to the port one message at a time
+    /// @return Count of ports the messages were queued for
+    inline std::size_t broadcast(const std::vector<std::uint8_t>& encoded)
+    {
+        std::size_t _count = 0;
+        for (std::size_t _destination = 0; _destination < _ports.size(); ++_destination) {
+            _count += route(_destination, encoded) ? 1 : 0;
+        }
+        return _count;
+    }
+
+    /// @brief Gets the count of ports
+    /// @return Ports count
+    inline std::size_t ports() const
+    {
+        return _ports.size();
+    }
+
+    /// @brief Gets a snapshot of the counters of a port
+    /// @param destination Index of the port
+    /// @return Counters since open(), zero for a port that does not exist
+    inline midi_router_statistics statistics(const std::size_t destination) const
+    {
+        if (destination >= _ports.size()) {
+            return midi_router_statistics {};
+        }
+        const port& _port = *_ports[destination];
+        std::lock_guard<std::mutex> _lock(_port.mutex);
+        midi_router_statistics _statistics = _port.statistics;
+        _statistics.depth = _port.size;
+        return _statistics;
+    }
+
+private:
+    struct port {
+        std::function<void(const std::vector<std::uint8_t>&)> send;
+        int cpu = -1;
+        capability_mask capabilities = ~capability_mask(0);
+        std::vector<std::vector<std::uint8_t>> slots;
+        std::size_t head = 0;
+        std::size_t size = 0;
+        midi_router_statistics statistics;
+        bool stop = false;
+        mutable std::mutex mutex;
+        std::condition_variable condition_variable;
+        std::thread thread;
+    };
+
+    std::vector<std::unique_ptr<port>> _ports;
+
+    inline static void pin(const int cpu)
+    {
+        if (cpu < 0) {
+            return;
+        }
+#if defined(_WIN32)
+        SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << cpu);
+#elif defined(__linux__)
+        cpu_set_t _set;
+        CPU_ZERO(&_set);
+        CPU_SET(cpu, &_set);
+        pthread_setaffinity_np(pthread_self(), sizeof(_set), &_set);
+#endif
+    }
+
+    inline static void run(port* target)
+    {
+        pin(target->cpu);
+        std::vector<std::uint8_t> _message;
+        std::vector<std::uint8_t> _single;
+        std::unique_lock<std::mutex> _lock(target->mutex);
+        while (true) {
+            target->condition_variable.wait(_lock, [target] { return target->stop || target->size > 0; });
+            if (target->stop) {
+                break;
+            }
+            // swapping hands the previous message buffer back to the slot for reuse
+            _message.swap(target->slots[target->head]);
+            target->head = (target->head + 1) % target->slots.size();
+            --target->size;
+            _lock.unlock();
+            const std::size_t _sent = split_messages(_message, _single, target->send);
+            _lock.lock();
+            target->statistics.sent += _sent;
+            target->statistics.bytes_sent += _message.size();
+        }
+    }
+};
+
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <midispec/core/capabilities.hpp>
+#include <midispec/core/decode_result.hpp>
+#include <midispec/core/integral.hpp>
+#include <midispec/core/metrics.hpp>
+
+namespace midispec {
+
+/// @brief Encodes a note on message with the encode_note_on() overload of a hardware.
+/// Channel or velocity are dropped for hardware that does not take them, the overload is selected at compile time
+/// @tparam Hardware Hardware struct that can receive note on messages
+/// @param encoded Vector to append the encoded message to
+/// @param channel Target channel number. In range [0, 15]
+/// @param note Note number. In range [0, 127]
+/// @param velocity Velocity. In range [0, 127]
+template <typename Hardware>
+inline void encode_note_on(
+    std::vector<std::uint8_t>& encoded,
+    const integral<std::uint8_t, 0, 15> channel,
+    const integral<std::uint8_t, 0, 127> note,
+    const integral<std::uint8_t, 0, 127> velocity)
+{
+    static_assert(has_note_on_v<Hardware, capability::receive>, "Requires hardware that can receive note on messages");
+    const std::size_t _offset = encoded.size();
+    if constexpr (detail::has_note_on_encode_full<Hardware>::value) {
+        Hardware::encode_note_on(encoded, channel, note, velocity);
+    } else if constexpr (detail::has_note_on_encode_no_velocity<Hardware>::value) {
+        Hardware::encode_note_on(encoded, channel, note);
+    } else {
+        Hardware::encode_note_on(encoded, note, velocity);
+    }
+    metrics<Hardware>::count_encoded(encoded, _offset);
+}
+
+/// @brief Encodes a note off message with the encode_note_off() overload of a hardware.
+/// Channel or velocity are dropped for hardware that does not take them, the overload is selected at compile time
+/// @tparam Hardware Hardware struct that can receive note off messages
+/// @param encoded Vector to append the encoded message to
+/// @param channel Target channel number. In range [0, 15]
+/// @param note Note number. In range [0, 127]
+/// @param velocity Release velocity. In range [0, 127]
+template <typename Hardware>
+inline void encode_note_off(
+    std::vector<std::uint8_t>& encoded,
+    const integral<std::uint8_t, 0, 15> channel,
+    const integral<std::uint8_t, 0, 127> note,
+    const integral<std::uint8_t, 0, 127> velocity = 0)
+{
+    static_assert(has_note_off_v<Hardware, capability::receive>, "Requires hardware that can receive note off messages");
+    const std::size_t _offset = encoded.size();
+    if constexpr (detail::has_note_off_encode_full<Hardware>::value) {
+        Hardware::encode_note_off(encoded, channel, note, velocity);
+    } else if constexpr (detail::has_note_off_encode_no_velocity<Hardware>::value) {
+        Hardware::encode_note_off(encoded, channel, note);
+    } else if constexpr (detail::has_note_off_encode_no_channel<Hardware>::value) {
+        Hardware::encode_note_off(encoded, note, velocity);
+    } else {
+        Hardware::encode_note_off(encoded, note);
+    }
+    metrics<Hardware>::count_encoded(encoded, _offset);
+}
+
+/// @brief Decodes a note on message with the decode_note_on() overload of a hardware.
+/// Channel and velocity not decoded by the hardware are read from the status and data bytes the hardware accepted
+/// @tparam Hardware Hardware struct that can transmit note on messages
+/// @param encoded Vector to read the encoded message from
+/// @param channel Channel number. In range [0, 15]
+/// @param note Note number. In range [0, 127]
+/// @param velocity Velocity. In range [0, 127]
+/// @return Success, or the reason of the rejection
+template <typename Hardware>
+inline decode_result decode_note_on(
+    const std::vector<std::uint8_t>& encoded,
+    integral<std::uint8_t, 0, 15>& channel,
+    integral<std::uint8_t, 0, 127>& note,
+    integral<std::uint8_t, 0, 127>& velocity)
+{
+    static_assert(has_note_on_v<Hardware, capability::transmit>, "Requires hardware that can transmit note on messages");
+    // hardware decoders only accept complete three byte messages, so the status and data bytes can be read on success
+    decode_result _decoded;
+    if constexpr (detail::has_note_on_decode_full<Hardware>::value) {
+        _decoded = Hardware::decode_note_on(encoded, channel, note, velocity);
+    } else if constexpr (detail::has_note_on_decode_no_velocity<Hardware>::value) {
+        _decoded = Hardware::decode_note_on(encoded, channel, note);
+        if (_decoded) {
+            velocity = encoded[2] & 0x7F;
+        }
+    } else {
+        _decoded = Hardware::decode_note_on(encoded, note, velocity);
+        if (_decoded) {
+            channel = encoded[0] & 0x0F;
+        }
+    }
+    metrics<Hardware>::count_decoded(encoded, _decoded);
+    return _decoded;
+}
+
+/// @brief Decodes a note off message with the decode_note_off() overload of a hardware.
+/// Channel and velocity not decoded by the hardware are read from the status and data bytes the hardware accepted
+/// @tparam Hardware Hardware struct that can transmit note off messages
+/// @param encoded Vector to read the encoded message from
+/// @param channel Channel number. In range [0, 15]
+/// @param note Note number. In range [0, 127]
+/// @param velocity Release velocity. In range [0, 127]
+/// @return Success, or the reason of the rejection
+template <typename Hardware>
+inline decode_result decode_note_off(
+    const std::vector<std::uint8_t>& encoded,
+    integral<std::uint8_t, 0, 15>& channel,
+    integral<std::uint8_t, 0, 127>& note,
+    integral<std::uint8_t, 0, 127>& velocity)
+{
+    static_assert(has_note_off_v<Hardware, capability::transmit>, "Requires hardware that can transmit note off messages");
+    // hardware decoders only accept complete three byte messages, so the status and data bytes can be read on success
+    decode_result _decoded;
+    if constexpr (detail::has_note_off_decode_full<Hardware>::value) {
+        _decoded = Hardware::decode_note_off(encoded, channel, note, velocity);
+    } else if constexpr (detail::has_note_off_decode_no_velocity<Hardware>::value) {
+        _decoded = Hardware::decode_note_off(encoded, channel, note);
+        if (_decoded) {
+            velocity = encoded[2] & 0x7F;
+        }
+    } else if constexpr (detail::has_note_off_decode_no_channel<Hardware>::value) {
+        _decoded = Hardware::decode_note_off(encoded, note, velocity);
+        if (_decoded) {
+            channel = encoded[0] & 0x0F;
+        }
+    } else {
+        _decoded = Hardware::decode_note_off(encoded, note);
+        if (_decoded) {
+            channel = encoded[0] & 0x0F;
+            velocity = encoded[2] & 0x7F;
+        }
+    }
+    metrics<Hardware>::count_decoded(encoded, _decoded);
+    return _decoded;
+}
+
+}
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include <midispec/core/capabilities.hpp>
+#include <midispec/core/integral.hpp>
+#include <midispec/core/message_split.hpp>
+#include <midispec/core/metrics.hpp>
+
+namespace midispec {
+
+/// @brief Counters of a state mirror
+struct state_mirror_statistics {
+    /// @brief Calls to sync() that sent at least one message
+    std::uint64_t syncs = 0;
+    /// @brief Parameter change messages sent
+    std::uint64_t parameter_changes = 0;
+    /// @brief Full voice dumps sent because they were cheaper than the parameter changes
+    std::uint64_t full_dumps = 0;
+    /// @brief Bytes sent to the hardware
+    std::uint64_t bytes_sent = 0;
+    /// @brief Voice dumps received from the hardware
+    std::uint64_t dumps_received = 0;
+};
+
+/// @brief Host side mirror of the voice edit buffer of every device number of hardware that can receive voice patches (yamaha_dx7, yamaha_tx81z).
+/// Edits mark the device dirty and sync() sends only the parameters that differ from the last state known to the hardware,
+/// or a single voice dump when that takes fewer bytes on the wire
+/// @tparam Hardware Hardware struct exposing encode_voice_patch() and encode_voice_patch_changes()
+template <typename Hardware>
+struct state_mirror {
+
+    static_assert(has_voice_patch_v<Hardware, capability::receive>, "Requires hardware that can receive voice patches");
+    static_assert(detail::has_voice_patch_changes_encode<Hardware>::value, "Requires hardware that can encode voice parameter changes");
+
+    using patch = typename Hardware::voice_patch;
+    using output = std::function<void(const std::vector<std::uint8_t>&)>;
+
+    /// @brief Gets the voice edit buffer of a device as last edited by the application
+    /// @param device Device number. In range [0, 15]
+    /// @return Copy of the patch
+    inline patch get(const integral<std::uint8_t, 0, 15> device) const
+    {
+        std::lock_guard<std::mutex> _lock(_mutex);
+        return _devices[device.value()].current;
+    }
+
+    /// @brief Edits the voice edit buffer of a device and marks it dirty
+    /// @param device Device number. In range [0, 15]
+    /// @param edit Callable receiving a patch reference, called with the mirror locked
+    template <typename Edit>
+    inline void edit(const integral<std::uint8_t, 0, 15> device, Edit&& edit)
+    {
+        std::lock_guard<std::mutex> _lock(_mutex);
+        entry& _entry = _devices[device.value()];
+        edit(_entry.current);
+        _entry.dirty = true;
+    }
+
+    /// @brief Sets the state known to be loaded by the hardware, for example from a decoded bank dump.
+    /// Pending edits are kept and sent on the next sync()
+    /// @param device Device number. In range [0, 15]
+    /// @param data Patch loaded by the hardware
+    inline void assume(const integral<std::uint8_t, 0, 15> device, const patch& data)
+    {
+        std::lock_guard<std::mutex> _lock(_mutex);
+        load(_devices[device.value()], data);
+    }
+
+    /// @brief Updates the state known to be loaded by the hardware from a voice dump it transmitted.
+    /// Pending edits are kept and sent on the next sync()
+    /// @param encoded Vector to decode the SysEx messages from
+    /// @return true if the message was a voice dump
+    inline bool receive(const std::vector<std::uint8_t>& encoded)
+    {
+        if constexpr (has_voice_patch_v<Hardware, capability::transmit>) {
+            std::lock_guard<std::mutex> _lock(_mutex);
+            integral<std::uint8_t, 0, 15> _device;
+            if (!decode_counted<Hardware>(&Hardware::decode_voice_patch, encoded, _device, _patch)) {
+                return false;
+            }
+            // partial dumps leave the parameters they do not carry untouched, so decode again over the known state of the device
+            entry& _entry = _devices[_device.value()];
+            _patch = _entry.synced;
+            Hardware::decode_voice_patch(encoded, _device, _patch);
+            load(_entry, _patch);
+            ++_statistics.dumps_received;
+            return true;
+        } else {
+            (void)encoded;
+            return false;
+        }
+    }
+
+    /// @brief Sends the pending edits of every dirty device back to back, one message per call to the output callback.
+    /// Devices whose hardware state is unknown receive a full voice dump
+    /// @param send Callback sending a single encoded message to the hardware, called from the calling thread
+    /// @return Count of bytes sent
+    inline std::size_t sync(const output& send)
+    {
+        std::lock_guard<std::mutex> _send_lock(_send_mutex);
+        {
+            std::lock_guard<std::mutex> _lock(_mutex);
+            _encoded.clear();
+            for (std::size_t _index = 0; _index < _devices.size(); ++_index) {
+                entry& _entry = _devices[_index];
+                if (!_entry.dirty) {
+                    continue;
+                }
+                const integral<std::uint8_t, 0, 15> _device = static_cast<std::uint8_t>(_index);
+                _dump.clear();
+                Hardware::encode_voice_patch(_dump, _device, _entry.current);
+                _changes.clear();
+                if (_entry.known) {
+                    Hardware::encode_voice_patch_changes(_changes, _device, _entry.synced, _entry.current);
+                }
+                if (_entry.known && _changes.size() <= _dump.size()) {
+                    _encoded.insert(_encoded.end(), _changes.begin(), _changes.end());
+                    _statistics.parameter_changes += count_messages(_changes);
+                } else {
+                    _encoded.insert(_encoded.end(), _dump.begin(), _dump.end());
+                    ++_statistics.full_dumps;
+                }
+                _entry.synced = _entry.current;
+                _entry.known = true;
+                _entry.dirty = false;
+            }
+            if (_encoded.empty()) {
+                return 0;
+            }
+            ++_statistics.syncs;
+            _statistics.bytes_sent += _encoded.size();
+        }
+        split_messages(_encoded, _message, send);
+        return _encoded.size();
+    }
+
+    /// @brief Gets whether a device has edits not sent yet
+    /// @param device Device number. In range [0, 15]
+    /// @return true if the next sync() sends messages for this device
+    inline bool dirty(const integral<std::uint8_t, 0, 15> device) const
+    {
+        std::lock_guard<std::mutex> _lock(_mutex);
+        return _devices[device.value()].dirty;
+    }
+
+    /// @brief Gets a snapshot of the mirror counters
+    /// @return Counters since construction
+    inline state_mirror_statistics statistics() const
+    {
+        std::lock_guard<std::mutex> _lock(_mutex);
+        return _statistics;
+    }
+
+private:
+    struct entry {
+        patch current = {};
+        patch synced = {};
+        bool known = false;
+        bool dirty = false;
+    };
+
+    std::array<entry, 16> _devices = {};
+    patch _patch = {};
+    std::vector<std::uint8_t> _encoded;
+    std::vector<std::uint8_t> _message;
+    std::vector<std::uint8_t> _dump;
+    std::vector<std::uint8_t> _changes;
+    state_mirror_statistics _statistics;
+    mutable std::mutex _mutex;
+    /// serializes sync() so that the send buffers are used without the mirror lock, and edits reach the hardware in order
+    std::mutex _send_mutex;
+
+    inline static void load(entry& target, const patch& data)
+    {
+        target.synced = data;
+        target.known = true;
+        if (!target.dirty) {
+            target.current = data;
+        }
+    }
+
+    inline static std::size_t count_messages(const std::vector<std::uint8_t>& encoded)
+    {
+        std::size_t _count = 0;
+        for (const std::uint8_t _byte : encoded) {
+            _count += _byte == 0xF7 ? 1 : 0;
+        }
+        return _count;
+    }
+};
+
+}
@@ -0,0 +1,266 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+#include <midispec/core/file_mapping.hpp>
+
+namespace midispec {
+
+/// @brief System exclusive message indexed in a .syx archive. Data points into the archive buffer and stays valid until the archive is closed
+struct sysex_frame {
+    /// @brief Offset of the 0xF0 byte in the archive
+    std::size_t offset = 0;
+    /// @brief Size of the message from 0xF0 to 0xF7 included
+    std::size_t size = 0;
+    /// @brief Manufacturer ID, three byte IDs are stored as 0x00XXYY
+    std::uint32_t manufacturer = 0;
+    /// @brief Byte following the manufacturer ID. Holds the substatus and device number on Yamaha hardware
+    std::uint8_t device = 0;
+    /// @brief Byte following the device byte. Holds the format number of Yamaha bulk dumps
+    std::uint8_t format = 0;
+    /// @brief Pointer to the 0xF0 byte
+    const std::uint8_t* data = nullptr;
+    /// @brief Whether realtime bytes (0xF8 to 0xFF) are interleaved between 0xF0 and 0xF7.
+    /// The view from data then holds them and must go through copy() before decoding
+    bool interleaved = false;
+
+    /// @brief Copies the message into a vector that can be passed to the hardware decode functions.
+    /// Interleaved realtime bytes are left out. Reusing the same vector avoids allocating once its capacity fits the largest message
+    /// @param encoded Vector to replace the contents of
+    inline void copy(std::vector<std::uint8_t>& encoded) const
+    {
+        if (!interleaved) {
+            encoded.assign(data, data + size);
+            return;
+        }
+        encoded.clear();
+        for (std::size_t _index = 0; _index < size; ++_index) {
+            if (data[_index] < 0xF8) {
+                encoded.push_back(data[_index]);
+            }
+        }
+    }
+};
+
+/// @brief Archive of concatenated system exclusive messages as found in .syx files.
+/// The buffer or file mapping is scanned once to index every message, frames are handed out as views into it
+struct sysex_archive {
+
+    sysex_archive() = default;
+    sysex_archive(const sysex_archive&) = delete;
+    sysex_archive& operator=(const sysex_archive&) = delete;
+
+    /// @brief Maps a .syx file and indexes its messages
+    /// @param path Path of the file to map
+    /// @return true on success
+    inline bool open(const std::string& path)
+    {
+        close();
+        if (!_mapping.open(path)) {
+            return false;
+        }
+        open(_mapping.data(), _mapping.size());
+        return true;
+    }
+
+    /// @brief Indexes the messages of a buffer already in memory. The buffer must outlive the archive
+    /// @param data Pointer to the archive contents
+    /// @param size Size of the archive contents
+    inline void open(const std::uint8_t* data, const std::size_t size)
+    {
+        _frames.clear();
+        _skipped = 0;
+        std::size_t _begin = size;
+        bool _interleaved = false;
+        for (std::size_t _index = 0; _index < size; ++_index) {
+            const std::uint8_t _byte = data[_index];
+            if (_byte < 0x80) {
+                continue;
+            }
+            if (_byte >= 0xF8) {
+                // realtime bytes may be interleaved anywhere in a capture and do not end a message
+                _interleaved = _interleaved || _begin < size;
+                continue;
+            }
+            if (_byte == 0xF7 && _begin < size) {
+                index(data, _begin, _index + 1 - _begin, _interleaved);
+                _begin = size;
+                _interleaved = false;
+                continue;
+            }
+            if (_begin < size) {
+                ++_skipped;
+            }
+            _begin = _byte == 0xF0 ? _index : size;
+            _interleaved = false;
+        }
+        if (_begin < size) {
+            ++_skipped;
+        }
+    }
+
+    /// @brief Unmaps the file and clears the index
+    inline void close()
+    {
+        _mapping.close();
+        _frames.clear();
+        _skipped = 0;
+    }
+
+    /// @brief Gets the indexed messages in archive order
+    /// @return Frames
+    inline const std::vector<sysex_frame>& frames() const
+    {
+        return _frames;
+    }
+
+    /// @brief Gets the count of messages that were interrupted by another status byte or by the end of the archive
+    /// @return Skipped messages count
+    inline std::size_t skipped() const
+    {
+        return _skipped;
+    }
+
+    /// @brief Writes frames to a .syx file with a single gather write where the platform allows it.
+    /// Frames are written as they are in the archive, interleaved realtime bytes included
+    /// @param path Path of the file to create
+    /// @param frames Frames to write in order
+    /// @return true on success
+    inline static bool write(const std::string& path, const std::vector<sysex_frame>& frames)
+    {
+        std::vector<std::pair<const std::uint8_t*, std::size_t>> _buffers;
+        _buffers.reserve(frames.size());
+        for (const sysex_frame& _frame : frames) {
+            _buffers.emplace_back(_frame.data, _frame.size);
+        }
+        return write_buffers(path, _buffers);
+    }
+
+    /// @brief Writes encoded messages to a .syx file with a single gather write where the platform allows it
+    /// @param path Path of the file to create
+    /// @param messages Encoded messages to write in order
+    /// @return true on success
+    inline static bool write(const std::string& path, const std::vector<std::vector<std::uint8_t>>& messages)
+    {
+        std::vector<std::pair<const std::uint8_t*, std::size_t>> _buffers;
+        _buffers.reserve(messages.size());
+        for (const std::vector<std::uint8_t>& _message : messages) {
+            _buffers.emplace_back(_message.data(), _message.size());
+        }
+        return write_buffers(path, _buffers);
+    }
+
+private:
+    file_mapping _mapping;
+    std::vector<sysex_frame> _frames;
+    std::size_t _skipped = 0;
+
+    inline void index(const std::uint8_t* data, const std::size_t offset, const std::size_t size, const bool interleaved)
+    {
+        sysex_frame _frame;
+        _frame.offset = offset;
+        _frame.size = size;
+        _frame.data = data + offset;
+        _frame.interleaved = interleaved;
+
+        // header fields are read from the leading bytes once realtime bytes are left out
+        std::uint8_t _header[6] = {};
+        std::size_t _length = 0;
+        for (std::size_t _index = 0; _index < size && _length < 6; ++_index) {
+            if (_frame.data[_index] < 0xF8) {
+                _header[_length++] = _frame.data[_index];
+            }
+        }
+        const std::size_t _stripped = interleaved ? size - count_realtime(_frame.data, size) : size;
+        std::size_t _next = 1;
+        if (_stripped > 2) {
+            if (_header[1] == 0x00 && _stripped > 4) {
+                _frame.manufacturer = (static_cast<std::uint32_t>(_header[2]) << 8) | _header[3];
+                _next = 4;
+            } else {
+                _frame.manufacturer = _header[1];
+                _next = 2;
+            }
+        }
+        // the closing 0xF7 is never reported as a device or format byte
+        if (_next + 1 < _stripped) {
+            _frame.device = _header[_next];
+        }
+        if (_next + 2 < _stripped) {
+            _frame.format = _header[_next + 1];
+        }
+        _frames.push_back(_frame);
+    }
+
+    inline static std::size_t count_realtime(const std::uint8_t* data, const std::size_t size)
+    {
+        std::size_t _count = 0;
+        for (std::size_t _index = 0; _index < size; ++_index) {
+            _count += data[_index] >= 0xF8 ? 1 : 0;
+        }
+        return _count;
+    }
+
+    inline static bool write_buffers(const std::string& path, const std::vector<std::pair<const std::uint8_t*, std::size_t>>& buffers)
+    {
+#if defined(_WIN32)
+        std::FILE* _file = std::fopen(path.c_str(), "wb");
+        if (_file == nullptr) {
+            return false;
+        }
+        bool _success = true;
+        for (const std::pair<const std::uint8_t*, std::size_t>& _buffer : buffers) {
+            _success = _success && std::fwrite(_buffer.first, 1, _buffer.second, _file) == _buffer.second;
+        }
+        return std::fclose(_file) == 0 && _success;
+#else
+        const int _descriptor = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (_descriptor < 0) {
+            return false;
+        }
+        // writev accepts a limited count of buffers per call, 1024 is the smallest limit among supported systems
+        constexpr std::size_t _batch_size = 1024;
+        std::vector<iovec> _vectors;
+        _vectors.reserve(buffers.size() < _batch_size ? buffers.size() : _batch_size);
+        bool _success = true;
+        for (std::size_t _first = 0; _success && _first < buffers.size(); _first += _batch_size) {
+            const std::size_t _last = _first + _batch_size < buffers.size() ? _first + _batch_size : buffers.size();
+            _vectors.clear();
+            for (std::size_t _index = _first; _index < _last; ++_index) {
+                _vectors.push_back(iovec { const_cast<std::uint8_t*>(buffers[_index].first), buffers[_index].second });
+            }
+            // partial writes resume from the first buffer not written entirely
+            std::size_t _vector = 0;
+            while (_success && _vector < _vectors.size()) {
+                const ssize_t _written = ::writev(_descriptor, _vectors.data() + _vector, static_cast<int>(_vectors.size() - _vector));
+                if (_written < 0) {
+                    _success = false;
+                    break;
+                }
+                std::size_t _remaining = static_cast<std::size_t>(_written);
+                while (_vector < _vectors.size() && _remaining >= _vectors[_vector].iov_len) {
+                    _remaining -= _vectors[_vector].iov_len;
+                    ++_vector;
+                }
+                if (_vector < _vectors.size()) {
+                    _vectors[_vector].iov_base = static_cast<std::uint8_t*>(_vectors[_vector].iov_base) + _remaining;
+                    _vectors[_vector].iov_len -= _remaining;
+                }
+            }
+        }
+        return ::close(_descriptor) == 0 && _success;
+#endif
+    }
+};
+
+}
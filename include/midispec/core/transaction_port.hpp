@@ -0,0 +1,213 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace midispec {
+
+/// @brief Counters of a transaction port
+struct transaction_port_statistics {
+    /// @brief Requests sent
+    std::uint64_t requests = 0;
+    /// @brief Replies matched to an outstanding request
+    std::uint64_t replies = 0;
+    /// @brief Requests that expired without reply
+    std::uint64_t timeouts = 0;
+    /// @brief Received messages that matched no outstanding request
+    std::uint64_t unmatched = 0;
+    /// @brief Largest count of requests outstanding at the same time
+    std::uint64_t outstanding_max = 0;
+};
+
+/// @brief Asynchronous request and reply multiplexer over a single pair of MIDI ports.
+/// Outstanding requests are indexed by manufacturer ID and, for universal messages, sub-ID#1 of the request,
+/// so that a received system exclusive message is only tested against the requests that can cause it
+struct transaction_port {
+
+    using output = std::function<void(const std::vector<std::uint8_t>&)>;
+    using matcher = std::function<bool(const std::vector<std::uint8_t>&)>;
+
+    transaction_port() = default;
+    transaction_port(const transaction_port&) = delete;
+    transaction_port& operator=(const transaction_port&) = delete;
+
+    inline ~transaction_port()
+    {
+        close();
+    }
+
+    /// @brief Starts the timeout thread
+    /// @param send Callback sending encoded messages to the hardware, called from the thread calling transact()
+    inline void open(output send)
+    {
+        close();
+        std::lock_guard<std::mutex> _lock(_mutex);
+        _send = std::move(send);
+        _statistics = transaction_port_statistics {};
+        _stop = false;
+        _thread = std::thread(&transaction_port::run, this);
+    }
+
+    /// @brief Stops the timeout thread. Outstanding requests complete with an empty reply
+    inline void close()
+    {
+        {
+            std::lock_guard<std::mutex> _lock(_mutex);
+            _stop = true;
+        }
+        _condition_variable.notify_all();
+        if (_thread.joinable()) {
+            _thread.join();
+        }
+        std::lock_guard<std::mutex> _lock(_mutex);
+        for (std::pair<const std::uint32_t, std::list<pending>>& _bucket : _pending) {
+            for (pending& _request : _bucket.second) {
+                _request.reply.set_value({});
+            }
+        }
+        _pending.clear();
+        _outstanding = 0;
+    }
+
+    /// @brief Sends a system exclusive request and registers it for its reply.
+    /// The request is registered before being sent so that replies faster than the send callback are not missed
+    /// @param request Encoded system exclusive request
+    /// @param reply Matcher accepting the reply among the messages with the same manufacturer and sub-ID as the request.
+    /// An empty matcher accepts the first of them
+    /// @param timeout Duration after which the request completes with an empty reply
+    /// @return Future receiving the encoded reply, or an empty vector on timeout or close()
+    inline std::future<std::vector<std::uint8_t>> transact(
+        const std::vector<std::uint8_t>& request,
+        matcher reply,
+        const std::chrono::milliseconds timeout)
+    {
+        std::promise<std::vector<std::uint8_t>> _promise;
+        std::future<std::vector<std::uint8_t>> _future = _promise.get_future();
+        const std::chrono::steady_clock::time_point _deadline = std::chrono::steady_clock::now() + timeout;
+        output _callback;
+        {
+            std::lock_guard<std::mutex> _lock(_mutex);
+            if (_stop) {
+                _promise.set_value({});
+                return _future;
+            }
+            _pending[key(request)].push_back(pending { std::move(reply), std::move(_promise), _deadline });
+            ++_outstanding;
+            ++_statistics.requests;
+            _statistics.outstanding_max = _outstanding > _statistics.outstanding_max ? _outstanding : _statistics.outstanding_max;
+            _callback = _send;
+        }
+        _condition_variable.notify_all();
+        _callback(request);
+        return _future;
+    }
+
+    /// @brief Completes the oldest outstanding request whose matcher accepts a received message.
+    /// Call from the input callback
+    /// @param encoded Vector to read the encoded message from
+    /// @return true if the message completed a request
+    inline bool receive(const std::vector<std::uint8_t>& encoded)
+    {
+        std::lock_guard<std::mutex> _lock(_mutex);
+        if (!encoded.empty() && encoded.front() == 0xF0) {
+            const auto _bucket = _pending.find(key(encoded));
+            if (_bucket != _pending.end()) {
+                for (auto _request = _bucket->second.begin(); _request != _bucket->second.end(); ++_request) {
+                    if (!_request->match || _request->match(encoded)) {
+                        _request->reply.set_value(encoded);
+                        _bucket->second.erase(_request);
+                        --_outstanding;
+                        ++_statistics.replies;
+                        return true;
+                    }
+                }
+            }
+        }
+        ++_statistics.unmatched;
+        return false;
+    }
+
+    /// @brief Gets the count of requests waiting for their reply
+    /// @return Outstanding requests count
+    inline std::size_t outstanding() const
+    {
+        std::lock_guard<std::mutex> _lock(_mutex);
+        return _outstanding;
+    }
+
+    /// @brief Gets a snapshot of the port counters
+    /// @return Counters since the last open()
+    inline transaction_port_statistics statistics() const
+    {
+        std::lock_guard<std::mutex> _lock(_mutex);
+        return _statistics;
+    }
+
+private:
+    struct pending {
+        matcher match;
+        std::promise<std::vector<std::uint8_t>> reply;
+        std::chrono::steady_clock::time_point deadline;
+    };
+
+    output _send;
+    std::unordered_map<std::uint32_t, std::list<pending>> _pending;
+    std::size_t _outstanding = 0;
+    transaction_port_statistics _statistics;
+    bool _stop = true;
+    mutable std::mutex _mutex;
+    std::condition_variable _condition_variable;
+    std::thread _thread;
+
+    /// manufacturer ID in the upper bytes with bit 24 set for three byte IDs, sub-ID#1 of universal messages in the lowest byte
+    inline static std::uint32_t key(const std::vector<std::uint8_t>& encoded)
+    {
+        if (encoded.size() < 3) {
+            return 0;
+        }
+        if (encoded[1] == 0x00 && encoded.size() > 4) {
+            return 0x01000000 | (static_cast<std::uint32_t>(encoded[2]) << 16) | (static_cast<std::uint32_t>(encoded[3]) << 8);
+        }
+        if ((encoded[1] == 0x7E || encoded[1] == 0x7F) && encoded.size() > 4) {
+            return (static_cast<std::uint32_t>(encoded[1]) << 8) | encoded[3];
+        }
+        return static_cast<std::uint32_t>(encoded[1]) << 8;
+    }
+
+    inline void run()
+    {
+        std::unique_lock<std::mutex> _lock(_mutex);
+        while (!_stop) {
+            std::chrono::steady_clock::time_point _next = std::chrono::steady_clock::time_point::max();
+            const std::chrono::steady_clock::time_point _now = std::chrono::steady_clock::now();
+            for (std::pair<const std::uint32_t, std::list<pending>>& _bucket : _pending) {
+                for (auto _request = _bucket.second.begin(); _request != _bucket.second.end();) {
+                    if (_request->deadline <= _now) {
+                        _request->reply.set_value({});
+                        _request = _bucket.second.erase(_request);
+                        --_outstanding;
+                        ++_statistics.timeouts;
+                        continue;
+                    }
+                    _next = _request->deadline < _next ? _request->deadline : _next;
+                    ++_request;
+                }
+            }
+            if (_next == std::chrono::steady_clock::time_point::max()) {
+                _condition_variable.wait(_lock);
+            } else {
+                _condition_variable.wait_until(_lock, _next);
+            }
+        }
+    }
+};
+
+}
@@ -0,0 +1,230 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <midispec/core/integral.hpp>
+#include <midispec/yamaha_tx81z.hpp>
+
+namespace midispec {
+
+/// @brief Counters of a voice allocator
+struct voice_allocator_statistics {
+    /// @brief Note on messages emitted
+    std::uint64_t note_ons = 0;
+    /// @brief Note off messages emitted
+    std::uint64_t note_offs = 0;
+    /// @brief Notes released by the allocator to make room for a new note on a full instrument
+    std::uint64_t stolen = 0;
+    /// @brief Note on events that no instrument could play, not emitted
+    std::uint64_t unrouted = 0;
+    /// @brief Note off events for notes that were not sounding, not emitted
+    std::uint64_t orphans = 0;
+};
+
+/// @brief Host side voice allocator mirroring the instruments of a yamaha_tx81z performance.
+/// Sounding notes are tracked per instrument in fixed size arrays, and when an instrument is full its oldest note is released
+/// with an explicit note off before the new note on is emitted, so that stealing is decided by the host instead of the hardware.
+/// Every event costs at most one pass over the 8 instruments. Not thread safe, drive it from the sequencer thread
+struct voice_allocator {
+
+    /// @brief Count of instruments of a performance
+    static constexpr std::size_t instruments = 8;
+
+    /// @brief Receive channel value of instruments that receive on every channel
+    static constexpr std::uint8_t omni = 16;
+
+    voice_allocator() = default;
+
+    /// @brief Creates an allocator mirroring a performance
+    /// @param performance Performance patch as sent to or received from the hardware
+    inline voice_allocator(const yamaha_tx81z::performance_patch& performance)
+    {
+        configure(performance);
+    }
+
+    /// @brief Mirrors the instruments of a performance and forgets every sounding note without emitting note offs.
+    /// Call release() first when notes may still sound on the hardware
+    /// @param performance Performance patch as sent to or received from the hardware
+    inline void configure(const yamaha_tx81z::performance_patch& performance)
+    {
+        _routes.fill(0);
+        for (std::size_t _index = 0; _index < instruments; ++_index) {
+            instrument& _instrument = _instruments[_index];
+            _instrument = instrument {};
+            _instrument.maximum = performance.inst_maximum_notes[_index].value();
+            _instrument.low = performance.inst_low_note_limit[_index].value();
+            _instrument.high = performance.inst_high_note_limit[_index].value();
+            if (_instrument.maximum == 0) {
+                continue;
+            }
+            const std::uint8_t _channel = performance.inst_receive_channel[_index].value();
+            for (std::uint8_t _route = 0; _route < 16; ++_route) {
+                if (_channel == omni || _channel == _route) {
+                    _routes[_route] |= static_cast<std::uint8_t>(1 << _index);
+                }
+            }
+        }
+    }
+
+    /// @brief Emits a note on for every instrument that plays it, preceded by note offs for the notes stolen to make room.
+    /// A note already sounding on the channel is released and retriggered
+    /// @param encoded Vector to append the encoded messages to
+    /// @param channel Channel number. In range [0, 15]
+    /// @param note MIDI note. In range [0, 127]
+    /// @param velocity MIDI velocity. In range [0, 127]
+    /// @return true if at least one instrument plays the note
+    inline bool note_on(
+        std::vector<std::uint8_t>& encoded,
+        const integral<std::uint8_t, 0, 15> channel,
+        const integral<std::uint8_t, 0, 127> note,
+        const integral<std::uint8_t, 0, 127> velocity)
+    {
+        const std::uint8_t _route = _routes[channel.value()];
+        std::uint8_t _playing = 0;
+        for (std::size_t _index = 0; _index < instruments; ++_index) {
+            const instrument& _instrument = _instruments[_index];
+            if ((_route & (1 << _index)) && note.value() >= _instrument.low && note.value() <= _instrument.high) {
+                _playing |= static_cast<std::uint8_t>(1 << _index);
+            }
+        }
+        if (_playing == 0) {
+            ++_statistics.unrouted;
+            return false;
+        }
+        release(encoded, channel.value(), note.value());
+        for (std::size_t _index = 0; _index < instruments; ++_index) {
+            if (!(_playing & (1 << _index))) {
+                continue;
+            }
+            instrument& _instrument = _instruments[_index];
+            // omni instruments may hold notes of other channels, the stolen note is released on the channel it was played on
+            if (_instrument.count == _instrument.maximum && release(encoded, _instrument.channel[_instrument.head], _instrument.head)) {
+                ++_statistics.stolen;
+            }
+            _instrument.push(note.value(), channel.value());
+        }
+        yamaha_tx81z::encode_note_on(encoded, channel, note, velocity);
+        ++_statistics.note_ons;
+        return true;
+    }
+
+    /// @brief Emits a note off if the note is sounding on the channel. Note offs for notes already stolen are suppressed
+    /// so that they cannot cut a later note on the same key
+    /// @param encoded Vector to append the encoded messages to
+    /// @param channel Channel number. In range [0, 15]
+    /// @param note MIDI note. In range [0, 127]
+    /// @return true if a note off was emitted
+    inline bool note_off(
+        std::vector<std::uint8_t>& encoded,
+        const integral<std::uint8_t, 0, 15> channel,
+        const integral<std::uint8_t, 0, 127> note)
+    {
+        if (!release(encoded, channel.value(), note.value())) {
+            ++_statistics.orphans;
+            return false;
+        }
+        return true;
+    }
+
+    /// @brief Emits a note off for every sounding note
+    /// @param encoded Vector to append the encoded messages to
+    inline void release(std::vector<std::uint8_t>& encoded)
+    {
+        for (instrument& _instrument : _instruments) {
+            while (_instrument.count > 0) {
+                release(encoded, _instrument.channel[_instrument.head], _instrument.head);
+            }
+        }
+    }
+
+    /// @brief Gets the count of notes sounding on an instrument
+    /// @param index Instrument index. In range [0, 7]
+    /// @return Sounding notes count
+    inline std::size_t sounding(const integral<std::uint8_t, 0, 7> index) const
+    {
+        return _instruments[index.value()].count;
+    }
+
+    /// @brief Gets a snapshot of the allocator counters
+    /// @return Counters since construction
+    inline voice_allocator_statistics statistics() const
+    {
+        return _statistics;
+    }
+
+private:
+    static constexpr std::uint8_t none = 0xFF;
+
+    /// sounding notes in age order, as a doubly linked list threaded through arrays indexed by note
+    struct instrument {
+        std::uint8_t maximum = 0;
+        std::uint8_t count = 0;
+        std::uint8_t low = 0;
+        std::uint8_t high = 127;
+        std::uint8_t head = none;
+        std::uint8_t tail = none;
+        std::array<std::uint8_t, 128> previous = {};
+        std::array<std::uint8_t, 128> next = {};
+        std::array<std::uint8_t, 128> channel = {};
+        std::array<bool, 128> sounding = {};
+
+        inline void push(const std::uint8_t note, const std::uint8_t from)
+        {
+            channel[note] = from;
+            previous[note] = tail;
+            next[note] = none;
+            if (tail != none) {
+                next[tail] = note;
+            } else {
+                head = note;
+            }
+            tail = note;
+            sounding[note] = true;
+            ++count;
+        }
+
+        inline bool erase(const std::uint8_t note)
+        {
+            if (!sounding[note]) {
+                return false;
+            }
+            if (previous[note] != none) {
+                next[previous[note]] = next[note];
+            } else {
+                head = next[note];
+            }
+            if (next[note] != none) {
+                previous[next[note]] = previous[note];
+            } else {
+                tail = previous[note];
+            }
+            sounding[note] = false;
+            --count;
+            return true;
+        }
+    };
+
+    std::array<instrument, instruments> _instruments;
+    std::array<std::uint8_t, 16> _routes = {};
+    voice_allocator_statistics _statistics;
+
+    /// a note off reaches every instrument receiving the channel, so the note is erased from all of them
+    inline bool release(std::vector<std::uint8_t>& encoded, const std::uint8_t channel, const std::uint8_t note)
+    {
+        bool _released = false;
+        for (std::size_t _index = 0; _index < instruments; ++_index) {
+            if (_routes[channel] & (1 << _index)) {
+                _released = _instruments[_index].erase(note) || _released;
+            }
+        }
+        if (_released) {
+            yamaha_tx81z::encode_note_off(encoded, channel, note);
+            ++_statistics.note_offs;
+        }
+        return _released;
+    }
+};
+
+}
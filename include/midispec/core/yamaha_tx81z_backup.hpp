@@ -0,0 +1,35 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <midispec/core/dump_pipeline.hpp>
+#include <midispec/core/integral.hpp>
+#include <midispec/yamaha_tx81z.hpp>
+
+namespace midispec {
+
+/// @brief Full state of a Yamaha TX81Z read back by add_backup_requests(). Sections without a decoder are kept as raw frames
+struct yamaha_tx81z_backup {
+    yamaha_tx81z::voice_patch voice;
+    std::array<yamaha_tx81z::voice_patch, 32> bank;
+    yamaha_tx81z::microtune_patch microtune;
+    std::vector<std::uint8_t> performance_frame;
+    std::vector<std::uint8_t> system_frame;
+    std::vector<std::uint8_t> effect_frame;
+    std::vector<std::uint8_t> program_change_frame;
+};
+
+/// @brief Adds the requests of a full Yamaha TX81Z backup to a dump pipeline: current voice (ACED and VCED), bank (VMEM),
+/// performance (PCED), system, effect, program change table and full keyboard microtune table (MCRT1).
+/// Answers are matched by their format byte or format header, whatever order they arrive in
+/// @param pipeline Pipeline to add the requests to, started by the caller
+/// @param device Target device number. In range [0, 15]
+/// @param data Backup written from the decode thread of the pipeline, must outlive it
+void add_backup_requests(
+    dump_pipeline& pipeline,
+    const integral<std::uint8_t, 0, 15>& device,
+    yamaha_tx81z_backup& data);
+
+}
@@ -4,6 +4,7 @@
 #include <vector>
 
 #include <midispec/core/capabilities.hpp>
+#include <midispec/core/decode_result.hpp>
 #include <midispec/core/integral.hpp>
 
 namespace midispec {
@@ -11,6 +12,35 @@ namespace midispec {
 /// @brief MIDI support for the Novation Launchpad controller
 struct novation_launchpad {
 
+    /// @brief LED colors of the 8x8 grid, the 8 side buttons and the 8 top buttons.
+    /// Colors are note on velocities with red brightness in bits [1:0],
+    /// copy and clear flags in bits [3:2] and green brightness in bits [5:4]
+    struct led_frame {
+        std::array<std::array<integral<std::uint8_t, 0, 63>, 8>, 8> grid;
+        std::array<integral<std::uint8_t, 0, 63>, 8> side;
+        std::array<integral<std::uint8_t, 0, 63>, 8> top;
+    };
+
+    /// @brief Host side LED framebuffer.
+    /// The back frame is drawn by the host and the front frame mirrors the LEDs last flushed to the hardware.
+    /// When double buffered the hardware must first be switched to Buffered 0 with encode_led_buffers_mode()
+    struct led_framebuffer {
+        led_frame back;
+        led_frame front;
+        integral<std::uint8_t, 0, 1> double_buffered;
+        integral<std::uint8_t, 0, 1> displayed_buffer;
+    };
+
+    /// @brief Dithering applied when quantizing images to LED colors
+    enum struct led_dithering : std::uint8_t {
+        /// @brief Nearest LED color
+        none,
+        /// @brief 8x8 Bayer matrix thresholds
+        ordered,
+        /// @brief Floyd-Steinberg error diffusion inside each frame
+        error_diffusion
+    };
+
     // channel common (on this hardware all messages are exchanged on channel 0)
 
     /// @brief Encodes a note off message
@@ -23,8 +53,8 @@ struct novation_launchpad {
     /// @brief Decodes a note off message
     /// @param encoded Vector to read the encoded message from
     /// @param note MIDI note. In range [0, 127]
-    /// @return true on success
-    static bool decode_note_off(
+    /// @return Success, or the reason of the rejection
+    static decode_result decode_note_off(
         const std::vector<std::uint8_t>& encoded,
         integral<std::uint8_t, 0, 127>& note);
 
@@ -41,8 +71,8 @@ struct novation_launchpad {
     /// @param encoded Vector to read the encoded message from
     /// @param note MIDI note. In range [0, 127]
     /// @param velocity MIDI velocity. In range [0, 127]
-    /// @return true on success
-    static bool decode_note_on(
+    /// @return Success, or the reason of the rejection
+    static decode_result decode_note_on(
         const std::vector<std::uint8_t>& encoded,
         integral<std::uint8_t, 0, 127>& note,
         integral<std::uint8_t, 0, 127>& velocity);
@@ -81,5 +111,91 @@ struct novation_launchpad {
     static void encode_led_buffers_mode(
         std::vector<std::uint8_t>& encoded,
         const integral<std::uint8_t, 0, 5> mode);
+
+    // leds (on this hardware LEDs are addressed with the X-Y button layout)
+
+    /// @brief Encodes a LED color change message for a pad of the 8x8 grid
+    /// @param encoded Vector to append the encoded message to
+    /// @param row Grid row from top to bottom. In range [0, 7]
+    /// @param column Grid column from left to right. In range [0, 7]
+    /// @param color LED color velocity. In range [0, 63]
+    static void encode_grid_led(
+        std::vector<std::uint8_t>& encoded,
+        const integral<std::uint8_t, 0, 7> row,
+        const integral<std::uint8_t, 0, 7> column,
+        const integral<std::uint8_t, 0, 63> color);
+
+    /// @brief Encodes a LED color change message for a side button
+    /// @param encoded Vector to append the encoded message to
+    /// @param row Side button row from top to bottom. In range [0, 7]
+    /// @param color LED color velocity. In range [0, 63]
+    static void encode_side_led(
+        std::vector<std::uint8_t>& encoded,
+        const integral<std::uint8_t, 0, 7> row,
+        const integral<std::uint8_t, 0, 63> color);
+
+    /// @brief Encodes a LED color change message for a top button
+    /// @param encoded Vector to append the encoded message to
+    /// @param column Top button column from left to right. In range [0, 7]
+    /// @param color LED color velocity. In range [0, 63]
+    static void encode_top_led(
+        std::vector<std::uint8_t>& encoded,
+        const integral<std::uint8_t, 0, 7> column,
+        const integral<std::uint8_t, 0, 63> color);
+
+    /// @brief Encodes a rapid LED update of a full frame.
+    /// Two LEDs are set per message walking the grid rows, then the side buttons and then the top buttons
+    /// @param encoded Vector to append the encoded messages to
+    /// @param frame LED colors to set
+    static void encode_rapid_led_update(
+        std::vector<std::uint8_t>& encoded,
+        const led_frame& frame);
+
+    /// @brief Encodes a LED framebuffer flush. Only LEDs whose color changed since the last flush are encoded,
+    /// falling back to a rapid LED update when it is shorter than individual LED messages.
+    /// When double buffered, changes are written to the hidden buffer which is then displayed atomically
+    /// @param encoded Vector to append the encoded messages to
+    /// @param framebuffer Framebuffer to flush, its front frame is updated to its back frame
+    static void encode_led_framebuffer(
+        std::vector<std::uint8_t>& encoded,
+        led_framebuffer& framebuffer);
+
+    /// @brief Quantizes RGB images to grid LED colors.
+    /// Red and green drive the red and green LEDs, blue is ignored. Side and top LEDs are left off
+    /// @param pixels Interleaved RGB pixels of consecutive 8x8 row-major images. In range [0, 1]
+    /// @param dithering Dithering applied before quantization
+    /// @param frames Vector to append one frame per complete image to
+    static void quantize_rgb_frames(
+        const std::vector<float>& pixels,
+        const led_dithering dithering,
+        std::vector<led_frame>& frames);
+
+    /// @brief Quantizes RGB images to grid LED colors.
+    /// Red and green drive the red and green LEDs, blue is ignored. Side and top LEDs are left off
+    /// @param pixels Interleaved RGB pixels of consecutive 8x8 row-major images. In range [0, 255]
+    /// @param dithering Dithering applied before quantization
+    /// @param frames Vector to append one frame per complete image to
+    static void quantize_rgb_frames(
+        const std::vector<std::uint8_t>& pixels,
+        const led_dithering dithering,
+        std::vector<led_frame>& frames);
+
+    /// @brief Quantizes greyscale images to amber grid LED colors. Side and top LEDs are left off
+    /// @param pixels Pixels of consecutive 8x8 row-major images. In range [0, 1]
+    /// @param dithering Dithering applied before quantization
+    /// @param frames Vector to append one frame per complete image to
+    static void quantize_greyscale_frames(
+        const std::vector<float>& pixels,
+        const led_dithering dithering,
+        std::vector<led_frame>& frames);
+
+    /// @brief Quantizes greyscale images to amber grid LED colors. Side and top LEDs are left off
+    /// @param pixels Pixels of consecutive 8x8 row-major images. In range [0, 255]
+    /// @param dithering Dithering applied before quantization
+    /// @param frames Vector to append one frame per complete image to
+    static void quantize_greyscale_frames(
+        const std::vector<std::uint8_t>& pixels,
+        const led_dithering dithering,
+        std::vector<led_frame>& frames);
 };
 }
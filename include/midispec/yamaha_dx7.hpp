@@ -4,6 +4,7 @@
 #include <vector>
 
 #include <midispec/core/capabilities.hpp>
+#include <midispec/core/decode_result.hpp>
 #include <midispec/core/integral.hpp>
 
 namespace midispec {
@@ -74,8 +75,8 @@ struct yamaha_dx7 {
     /// @param encoded Vector to read the encoded message from
     /// @param channel Target channel number. In range [0, 15]
     /// @param note MIDI note. In range [0, 127]
-    /// @return true on success
-    static bool decode_note_off(
+    /// @return Success, or the reason of the rejection
+    static decode_result decode_note_off(
         const std::vector<std::uint8_t>& encoded,
         integral<std::uint8_t, 0, 15>& channel,
         integral<std::uint8_t, 0, 127>& note);
@@ -96,8 +97,8 @@ struct yamaha_dx7 {
     /// @param channel Target channel number. In range [0, 15]
     /// @param note MIDI note. In range [0, 127]
     /// @param velocity MIDI velocity. In range [0, 127]
-    /// @return true on success
-    static bool decode_note_on(
+    /// @return Success, or the reason of the rejection
+    static decode_result decode_note_on(
         const std::vector<std::uint8_t>& encoded,
         integral<std::uint8_t, 0, 15>& channel,
         integral<std::uint8_t, 0, 127>& note,
@@ -116,8 +117,8 @@ struct yamaha_dx7 {
     /// @param encoded Vector to read the encoded message from
     /// @param channel Target channel number. In range [0, 15]
     /// @param program MIDI program clamped for the DX7. In range [0, 31]
-    /// @return true on success
-    static bool decode_program_change(
+    /// @return Success, or the reason of the rejection
+    static decode_result decode_program_change(
         const std::vector<std::uint8_t>& encoded,
         integral<std::uint8_t, 0, 15>& channel,
         integral<std::uint8_t, 0, 31>& program);
@@ -135,8 +136,8 @@ struct yamaha_dx7 {
     /// @param encoded Vector to read the encoded message from
     /// @param channel Target channel number. In range [0, 15]
     /// @param pitchbend MIDI pitchbend. In range [0, 16383] (Default 8192)
-    /// @return true on success
-    static bool decode_pitchbend_change(
+    /// @return Success, or the reason of the rejection
+    static decode_result decode_pitchbend_change(
         const std::vector<std::uint8_t>& encoded,
         integral<std::uint8_t, 0, 15>& channel,
         integral<std::uint16_t, 0, 16383, 8192>& pitchbend);
@@ -145,8 +146,8 @@ struct yamaha_dx7 {
     /// @param encoded Vector to read the encoded message from
     /// @param channel Target channel number. In range [0, 15]
     /// @param program Nonstandard MIDI channel pressure. In range [0, 127]
-    /// @return true on success
-    static bool decode_channel_pressure(
+    /// @return Success, or the reason of the rejection
+    static decode_result decode_channel_pressure(
         const std::vector<std::uint8_t>& encoded,
         integral<std::uint8_t, 0, 15>& channel,
         integral<std::uint8_t, 0, 127>& pressure);
@@ -860,6 +861,18 @@ struct yamaha_dx7 {
         const integral<std::uint8_t, 0, 15> device,
         const voice_patch& data);
 
+    /// @brief Encodes one parameter change message for each voice parameter that differs between two patches.
+    /// This is cheaper than encode_voice_patch() when fewer than 24 parameters changed
+    /// @param encoded Vector to append the encoded SysEx messages to
+    /// @param device Target device number. In range [0, 15]
+    /// @param previous Patch currently loaded by the hardware
+    /// @param data Patch to apply
+    static void encode_voice_patch_changes(
+        std::vector<std::uint8_t>& encoded,
+        const integral<std::uint8_t, 0, 15> device,
+        const voice_patch& previous,
+        const voice_patch& data);
+
     /// @brief Encodes a 32 patches bank SysEx data block
     /// Appends a complete internal bank (32 patches)
     /// @param encoded Vector to append the encoded SysEx message to
@@ -875,8 +888,8 @@ struct yamaha_dx7 {
     /// @param encoded Vector to decode the SysEx message from
     /// @param device Expected target device number. In range [0, 15]
     /// @param data Output array to receive the 32 decoded patches
-    /// @return true on success
-    static bool decode_voice_patch_bank(
+    /// @return Success, or the reason of the rejection
+    static decode_result decode_voice_patch_bank(
         const std::vector<std::uint8_t>& encoded,
         integral<std::uint8_t, 0, 15>& device,
         std::array<voice_patch, 32>& data);
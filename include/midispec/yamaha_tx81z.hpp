@@ -1,9 +1,11 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <vector>
 
 #include <midispec/core/capabilities.hpp>
+#include <midispec/core/decode_result.hpp>
 #include <midispec/core/integral.hpp>
 
 namespace midispec {
@@ -108,7 +110,14 @@ struct yamaha_tx81z {
         std::array<integral<std::uint8_t, 0, 1>, 12> effect_key_3;
     };
 
+    struct microtune_octave_patch {
+        std::array<integral<std::uint8_t, 13, 108>, 12> key_note;
+        std::array<integral<std::uint8_t, 0, 63>, 12> key_fine;
+    };
+
     struct microtune_patch {
+        std::array<integral<std::uint8_t, 13, 108>, 128> key_note;
+        std::array<integral<std::uint8_t, 0, 63>, 128> key_fine;
     };
 
     // channel common
@@ -270,19 +279,46 @@ struct yamaha_tx81z {
         const integral<std::uint8_t, 0, 15>& device,
         const voice_patch& data);
 
+    /// @brief Encodes a request for the current voice (ACED).
+    /// The hardware answers with the ACED followed by the VCED of the current voice
+    /// @param encoded Vector to append the encoded SysEx message to
+    /// @param device Target device number. In range [0, 15]
     static void encode_voice_patch_request(
         std::vector<std::uint8_t>& encoded,
         const integral<std::uint8_t, 0, 15>& device);
 
-    static void decode_voice_patch(
+    /// @brief Decodes the current voice from an ACED followed by a VCED SysEx data block, as encoded by encode_voice_patch().
+    /// A VCED alone is accepted and leaves the ACED parameters of data unchanged
+    /// @param encoded Vector to decode the SysEx messages from
+    /// @param device Expected target device number. In range [0, 15]
+    /// @param data Output patch to receive the decoded voice
+    /// @return Success, or the reason of the rejection
+    static decode_result decode_voice_patch(
         const std::vector<std::uint8_t>& encoded,
         integral<std::uint8_t, 0, 15>& device,
         voice_patch& data);
 
+    /// @brief Encodes one VCED or ACED parameter change message for each voice parameter that differs between two patches.
+    /// This is cheaper than encode_voice_patch() when fewer than 21 parameters changed
+    /// @param encoded Vector to append the encoded SysEx messages to
+    /// @param device Target device number. In range [0, 15]
+    /// @param previous Patch currently loaded by the hardware
+    /// @param data Patch to apply
+    static void encode_voice_patch_changes(
+        std::vector<std::uint8_t>& encoded,
+        const integral<std::uint8_t, 0, 15>& device,
+        const voice_patch& previous,
+        const voice_patch& data);
+
+    /// @brief Encodes a 32 patches bank SysEx data block (VMEM).
+    /// Appends a complete internal bank (32 patches) including the ACED parameters
+    /// @param encoded Vector to append the encoded SysEx message to
+    /// @param device Target device number. In range [0, 15]
+    /// @param data Array of 32 patches to encode
     static void encode_bank(
         std::vector<std::uint8_t>& encoded,
         const integral<std::uint8_t, 0, 15>& device,
-        const std::array<voice_patch, 128>& data);
+        const std::array<voice_patch, 32>& data);
 
     static void encode_performance_patch(
         std::vector<std::uint8_t>& encoded,
@@ -304,6 +340,21 @@ struct yamaha_tx81z {
         const integral<std::uint8_t, 0, 15>& device,
         const std::array<integral<std::uint8_t, 0, 127>, 127>& data);
 
+    /// @brief Encodes an octave microtune table SysEx data block (MCRT0).
+    /// Each of the 12 keys from C to B is tuned to a note and a fine offset in 1/64 semitone steps above it, repeated over the keyboard
+    /// @param encoded Vector to append the encoded SysEx message to
+    /// @param device Target device number. In range [0, 15]
+    /// @param data Octave table to encode
+    static void encode_microtune_octave_patch(
+        std::vector<std::uint8_t>& encoded,
+        const integral<std::uint8_t, 0, 15>& device,
+        const microtune_octave_patch& data);
+
+    /// @brief Encodes a full keyboard microtune table SysEx data block (MCRT1).
+    /// Each of the 128 keys is tuned to a note and a fine offset in 1/64 semitone steps above it
+    /// @param encoded Vector to append the encoded SysEx message to
+    /// @param device Target device number. In range [0, 15]
+    /// @param data Full keyboard table to encode
     static void encode_microtune_patch(
         std::vector<std::uint8_t>& encoded,
         const integral<std::uint8_t, 0, 15>& device,
@@ -311,26 +362,51 @@ struct yamaha_tx81z {
 
     //
 
+    /// @brief Encodes a request for a 32 patches bank (VMEM)
+    /// @param encoded Vector to append the encoded SysEx message to
+    /// @param device Target device number. In range [0, 15]
     static void encode_bank_request(
         std::vector<std::uint8_t>& encoded,
         const integral<std::uint8_t, 0, 15>& device);
 
+    /// @brief Encodes a request for the current performance (PCED)
+    /// @param encoded Vector to append the encoded SysEx message to
+    /// @param device Target device number. In range [0, 15]
     static void encode_performance_patch_request(
         std::vector<std::uint8_t>& encoded,
         const integral<std::uint8_t, 0, 15>& device);
 
+    /// @brief Encodes a request for the system setup (SYS)
+    /// @param encoded Vector to append the encoded SysEx message to
+    /// @param device Target device number. In range [0, 15]
     static void encode_system_patch_request(
         std::vector<std::uint8_t>& encoded,
         const integral<std::uint8_t, 0, 15>& device);
 
+    /// @brief Encodes a request for the effect setup (EFFECT)
+    /// @param encoded Vector to append the encoded SysEx message to
+    /// @param device Target device number. In range [0, 15]
     static void encode_effect_patch_request(
         std::vector<std::uint8_t>& encoded,
         const integral<std::uint8_t, 0, 15>& device);
 
+    /// @brief Encodes a request for the program change table (PCT)
+    /// @param encoded Vector to append the encoded SysEx message to
+    /// @param device Target device number. In range [0, 15]
     static void encode_program_change_patch_request(
         std::vector<std::uint8_t>& encoded,
         const integral<std::uint8_t, 0, 15>& device);
 
+    /// @brief Encodes a request for the octave microtune table (MCRT0)
+    /// @param encoded Vector to append the encoded SysEx message to
+    /// @param device Target device number. In range [0, 15]
+    static void encode_microtune_octave_patch_request(
+        std::vector<std::uint8_t>& encoded,
+        const integral<std::uint8_t, 0, 15>& device);
+
+    /// @brief Encodes a request for the full keyboard microtune table (MCRT1)
+    /// @param encoded Vector to append the encoded SysEx message to
+    /// @param device Target device number. In range [0, 15]
     static void encode_microtune_patch_request(
         std::vector<std::uint8_t>& encoded,
         const integral<std::uint8_t, 0, 15>& device);
@@ -338,10 +414,16 @@ struct yamaha_tx81z {
     //
 
 
-    static void decode_bank(
+    /// @brief Decodes a 32 patches bank SysEx data block (VMEM).
+    /// Parses an internal bank (32 patches) including the ACED parameters into structured data
+    /// @param encoded Vector to decode the SysEx message from
+    /// @param device Expected target device number. In range [0, 15]
+    /// @param data Output array to receive the 32 decoded patches
+    /// @return Success, or the reason of the rejection
+    static decode_result decode_bank(
         const std::vector<std::uint8_t>& encoded,
         integral<std::uint8_t, 0, 15>& device,
-        std::array<voice_patch, 128>& data);
+        std::array<voice_patch, 32>& data);
 
     static void decode_performance_patch(
         const std::vector<std::uint8_t>& encoded,
@@ -358,7 +440,22 @@ struct yamaha_tx81z {
         integral<std::uint8_t, 0, 15>& device,
         effect_patch& data);
 
-    static void decode_microtune_patch(
+    /// @brief Decodes an octave microtune table SysEx data block (MCRT0)
+    /// @param encoded Vector to decode the SysEx message from
+    /// @param device Expected target device number. In range [0, 15]
+    /// @param data Output table to receive the decoded tuning
+    /// @return Success, or the reason of the rejection
+    static decode_result decode_microtune_octave_patch(
+        const std::vector<std::uint8_t>& encoded,
+        integral<std::uint8_t, 0, 15>& device,
+        microtune_octave_patch& data);
+
+    /// @brief Decodes a full keyboard microtune table SysEx data block (MCRT1)
+    /// @param encoded Vector to decode the SysEx message from
+    /// @param device Expected target device number. In range [0, 15]
+    /// @param data Output table to receive the decoded tuning
+    /// @return Success, or the reason of the rejection
+    static decode_result decode_microtune_patch(
         const std::vector<std::uint8_t>& encoded,
         integral<std::uint8_t, 0, 15>& device,
         microtune_patch& data);
@@ -24,21 +24,21 @@ void akai_lpk25::encode_note_off(
     encoded.push_back(0x00);
 }
 
-bool akai_lpk25::decode_note_off(
+decode_result akai_lpk25::decode_note_off(
     const std::vector<std::uint8_t>& encoded,
     integral<std::uint8_t, 0, 15>& channel,
     integral<std::uint8_t, 0, 127>& note)
 {
     if (encoded.size() != 3) {
-        return false;
+        return decode_error::size;
     }
     if ((encoded[0] & 0xF0) != 0x80) {
-        return false;
+        return decode_error::header;
     }
 
     channel = encoded[0] & 0x0F;
     note = encoded[1] & 0x7F;
-    return true;
+    return decode_error::none;
 }
 
 void akai_lpk25::encode_note_on(
@@ -51,23 +51,23 @@ void akai_lpk25::encode_note_on(
     encoded.push_back(0x7F);
 }
 
-bool akai_lpk25::decode_note_on(
+decode_result akai_lpk25::decode_note_on(
     const std::vector<std::uint8_t>& encoded,
     integral<std::uint8_t, 0, 15>& channel,
     integral<std::uint8_t, 0, 127>& note,
     integral<std::uint8_t, 0, 127>& velocity)
 {
     if (encoded.size() != 3) {
-        return false;
+        return decode_error::size;
     }
     if ((encoded[0] & 0xF0) != 0x90) {
-        return false;
+        return decode_error::header;
     }
 
     channel = encoded[0] & 0x0F;
     note = encoded[1] & 0x7F;
     velocity = encoded[2] & 0x7F;
-    return true;
+    return decode_error::none;
 }
 
 // system common
@@ -91,16 +91,16 @@ void akai_lpk25::encode_continue(std::vector<std::uint8_t>& encoded)
     encoded.push_back(0xFB);
 }
 
-bool akai_lpk25::decode_reset(const std::vector<std::uint8_t>& encoded)
+decode_result akai_lpk25::decode_reset(const std::vector<std::uint8_t>& encoded)
 {
     if (encoded.size() != 1) {
-        return false;
+        return decode_error::size;
     }
     if (encoded[0] != 0xFF) {
-        return false;
+        return decode_error::header;
     }
 
-    return true;
+    return decode_error::none;
 }
 
 }
\ No newline at end of file
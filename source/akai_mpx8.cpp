@@ -26,24 +26,24 @@ void akai_mpx8::encode_note_off(
     encoded.push_back(velocity.value() & 0x7F);
 }
 
-bool akai_mpx8::decode_note_off(
+decode_result akai_mpx8::decode_note_off(
     const std::vector<std::uint8_t>& encoded,
     integral<std::uint8_t, 0, 127>& note,
     integral<std::uint8_t, 0, 127>& velocity)
 {
     if (encoded.size() != 3) {
-        return false;
+        return decode_error::size;
     }
     if ((encoded[0] & 0xF0) != 0x80) {
-        return false;
+        return decode_error::header;
     }
     if ((encoded[0] & 0x0F) != CHANNEL_MPX8) {
-        return false;
+        return decode_error::channel;
     }
 
     note = encoded[1] & 0x7F;
     velocity = encoded[2] & 0x7F;
-    return true;
+    return decode_error::none;
 }
 
 void akai_mpx8::encode_note_on(
@@ -56,47 +56,47 @@ void akai_mpx8::encode_note_on(
     encoded.push_back(velocity.value() & 0x7F);
 }
 
-bool akai_mpx8::decode_note_on(
+decode_result akai_mpx8::decode_note_on(
     const std::vector<std::uint8_t>& encoded,
     integral<std::uint8_t, 0, 127>& note,
     integral<std::uint8_t, 0, 127>& velocity)
 {
     if (encoded.size() != 3) {
-        return false;
+        return decode_error::size;
     }
     if ((encoded[0] & 0xF0) != 0x90) {
-        return false;
+        return decode_error::header;
     }
     if ((encoded[0] & 0x0F) != CHANNEL_MPX8) {
-        return false;
+        return decode_error::channel;
     }
 
     note = encoded[1] & 0x7F;
     velocity = encoded[2] & 0x7F;
-    return true;
+    return decode_error::none;
 }
 
-bool akai_mpx8::decode_note_aftertouch(
+decode_result akai_mpx8::decode_note_aftertouch(
     const std::vector<std::uint8_t>& encoded,
     integral<std::uint8_t, 0, 127>& note,
     integral<std::uint8_t, 0, 127>& aftertouch)
 {
     if (encoded.size() != 3) {
-        return false;
+        return decode_error::size;
     }
     if ((encoded[0] & 0xF0) != 0xA0) {
-        return false;
+        return decode_error::header;
     }
     if ((encoded[0] & 0x0F) != CHANNEL_MPX8) {
-        return false;
+        return decode_error::channel;
     }
     if ((encoded[1] | encoded[2]) & 0x80) {
-        return false;
+        return decode_error::range;
     }
 
     note = encoded[1] & 0x7F;
     aftertouch = encoded[2] & 0x7F;
-    return true;
+    return decode_error::none;
 }
 
 // system exclusive
@@ -118,7 +118,7 @@ void akai_mpx8::encode_universal_inquiry_request(
     encoded.push_back(SYSEX_END);
 }
 
-bool akai_mpx8::decode_universal_inquiry(
+decode_result akai_mpx8::decode_universal_inquiry(
     const std::vector<std::uint8_t>& encoded,
     integral<std::uint8_t, 0, 127>& device,
     std::uint32_t& manufacturer,
@@ -127,26 +127,26 @@ bool akai_mpx8::decode_universal_inquiry(
     std::uint32_t& version)
 {
     if (encoded.size() < 15) {
-        return false;
+        return decode_error::size;
     }
     if (encoded[0] != SYSEX_START) {
-        return false;
+        return decode_error::header;
     }
     if (encoded[1] != 0x7E) {
-        return false;
+        return decode_error::header;
     }
     if (encoded[3] != 0x06) {
-        return false;
+        return decode_error::header;
     }
     if (encoded[4] != 0x02) {
-        return false;
+        return decode_error::header;
     }
     if (encoded.back() != SYSEX_END) {
-        return false;
+        return decode_error::header;
     }
     for (std::size_t _index = 1; _index + 1 < encoded.size(); ++_index) {
         if (encoded[_index] & 0x80) {
-            return false;
+            return decode_error::range;
         }
     }
 
@@ -155,14 +155,14 @@ bool akai_mpx8::decode_universal_inquiry(
 
     if (encoded[_index] == 0x00) {
         if (encoded.size() < _index + 3 + 2 + 2 + 4 + 1) {
-            return false;
+            return decode_error::size;
         }
         manufacturer = ((encoded[_index]) << 16) | ((encoded[_index + 1]) << 8) | (encoded[_index + 2]);
         _index += 3;
 
     } else {
         if (encoded.size() < _index + 1 + 2 + 2 + 4 + 1) {
-            return false;
+            return decode_error::size;
         }
         manufacturer = encoded[_index];
         _index += 1;
@@ -175,6 +175,6 @@ bool akai_mpx8::decode_universal_inquiry(
     _index += 2;
 
     version = ((encoded[_index]) << 24) | ((encoded[_index + 1]) << 16) | ((encoded[_index + 2]) << 8) | encoded[_index + 3];
-    return true;
+    return decode_error::none;
 }
 }
\ No newline at end of file
@@ -1,5 +1,112 @@
-
+#include <midispec/akai_rythmwolf.hpp>
 
 /// User manual at
 /// https://cdn.inmusicbrands.com/akai/attachments/wolf/Rhythm%20Wolf%20-%20User%20Guide%20-%20v1.3.pdf
-/// https://brianhilmers.com/gear/manuals/akai-rhythm-wolf-midi-implementation.pdf
\ No newline at end of file
+/// https://brianhilmers.com/gear/manuals/akai-rhythm-wolf-midi-implementation.pdf
+
+namespace midispec {
+
+static_assert(has_clock_v<akai_rythmwolf, capability::receive, capability::transmit>);
+static_assert(has_start_v<akai_rythmwolf, capability::receive, capability::transmit>);
+static_assert(has_stop_v<akai_rythmwolf, capability::receive, capability::transmit>);
+static_assert(has_continue_v<akai_rythmwolf, capability::receive, capability::transmit>);
+static_assert(has_song_position_v<akai_rythmwolf, capability::receive, capability::transmit>);
+
+// system common
+
+void akai_rythmwolf::encode_clock(std::vector<std::uint8_t>& encoded)
+{
+    encoded.push_back(0xF8);
+}
+
+decode_result akai_rythmwolf::decode_clock(const std::vector<std::uint8_t>& encoded)
+{
+    if (encoded.size() != 1) {
+        return decode_error::size;
+    }
+    if (encoded[0] != 0xF8) {
+        return decode_error::header;
+    }
+
+    return decode_error::none;
+}
+
+void akai_rythmwolf::encode_start(std::vector<std::uint8_t>& encoded)
+{
+    encoded.push_back(0xFA);
+}
+
+decode_result akai_rythmwolf::decode_start(const std::vector<std::uint8_t>& encoded)
+{
+    if (encoded.size() != 1) {
+        return decode_error::size;
+    }
+    if (encoded[0] != 0xFA) {
+        return decode_error::header;
+    }
+
+    return decode_error::none;
+}
+
+void akai_rythmwolf::encode_stop(std::vector<std::uint8_t>& encoded)
+{
+    encoded.push_back(0xFC);
+}
+
+decode_result akai_rythmwolf::decode_stop(const std::vector<std::uint8_t>& encoded)
+{
+    if (encoded.size() != 1) {
+        return decode_error::size;
+    }
+    if (encoded[0] != 0xFC) {
+        return decode_error::header;
+    }
+
+    return decode_error::none;
+}
+
+void akai_rythmwolf::encode_continue(std::vector<std::uint8_t>& encoded)
+{
+    encoded.push_back(0xFB);
+}
+
+decode_result akai_rythmwolf::decode_continue(const std::vector<std::uint8_t>& encoded)
+{
+    if (encoded.size() != 1) {
+        return decode_error::size;
+    }
+    if (encoded[0] != 0xFB) {
+        return decode_error::header;
+    }
+
+    return decode_error::none;
+}
+
+void akai_rythmwolf::encode_song_position(
+    std::vector<std::uint8_t>& encoded,
+    const integral<std::uint16_t, 0, 16383> data)
+{
+    encoded.push_back(0xF2);
+    encoded.push_back(static_cast<std::uint8_t>(data.value() & 0x7F));
+    encoded.push_back(static_cast<std::uint8_t>((data.value() >> 7) & 0x7F));
+}
+
+decode_result akai_rythmwolf::decode_song_position(
+    const std::vector<std::uint8_t>& encoded,
+    integral<std::uint16_t, 0, 16383>& data)
+{
+    if (encoded.size() != 3) {
+        return decode_error::size;
+    }
+    if (encoded[0] != 0xF2) {
+        return decode_error::header;
+    }
+    if ((encoded[1] | encoded[2]) & 0x80) {
+        return decode_error::range;
+    }
+
+    data = static_cast<std::uint16_t>(encoded[1] | (encoded[2] << 7));
+    return decode_error::none;
+}
+
+}
\ No newline at end of file
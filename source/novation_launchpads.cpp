@@ -25,22 +25,22 @@ void novation_launchpads::encode_note_off(
     encoded.push_back(0x00);
 }
 
-bool novation_launchpads::decode_note_off(
+decode_result novation_launchpads::decode_note_off(
     const std::vector<std::uint8_t>& encoded,
     integral<std::uint8_t, 0, 127>& note)
 {
     if (encoded.size() != 3) {
-        return false;
+        return decode_error::size;
     }
     if ((encoded[0] & 0x0F) != CHANNEL_LAUNCHPAD) {
-        return false;
+        return decode_error::channel;
     }
     if (((encoded[0] & 0xF0) != 0x90) || (encoded[2] != 0)) {
-        return false;
+        return decode_error::header;
     }
 
     note = encoded[1];
-    return true;
+    return decode_error::none;
 }
 
 void novation_launchpads::encode_note_on(
@@ -53,24 +53,24 @@ void novation_launchpads::encode_note_on(
     encoded.push_back(velocity.value());
 }
 
-bool novation_launchpads::decode_note_on(
+decode_result novation_launchpads::decode_note_on(
     const std::vector<std::uint8_t>& encoded,
     integral<std::uint8_t, 0, 127>& note,
     integral<std::uint8_t, 0, 127>& velocity)
 {
     if (encoded.size() != 3) {
-        return false;
+        return decode_error::size;
     }
     if ((encoded[0] & 0x0F) != CHANNEL_LAUNCHPAD) {
-        return false;
+        return decode_error::channel;
     }
     if (((encoded[0] & 0xF0) != 0x90) || (encoded[2] == 0)) {
-        return false;
+        return decode_error::header;
     }
 
     note = encoded[1];
     velocity = encoded[2];
-    return true;
+    return decode_error::none;
 }
 
 // system common
@@ -134,6 +134,248 @@ void novation_launchpads::encode_led_buffers_mode(
     encoded.push_back(_led_buffer_modes[mode.value()]);
 }
 
+// leds
+
+namespace {
+    static constexpr std::uint8_t LED_TOP_CONTROLLER = 0x68;
+    static constexpr std::uint8_t LED_FLAGS_MASK = 0x33;
+    static constexpr std::uint8_t LED_BUFFERS_MODE_BUFFERED_0_COPY = 3;
+    static constexpr std::uint8_t LED_BUFFERS_MODE_BUFFERED_1_COPY = 4;
+    static constexpr std::uint8_t LED_RAPID_UPDATE = 0x92;
+    static constexpr std::size_t LED_COUNT = 80;
+    static constexpr std::size_t LED_MESSAGE_SIZE = 3;
+    static constexpr std::size_t LED_RAPID_UPDATE_SIZE = LED_MESSAGE_SIZE + (LED_COUNT / 2) * LED_MESSAGE_SIZE;
+
+    static std::array<std::uint8_t, LED_COUNT> flatten_led_frame(const novation_launchpads::led_frame& frame, const std::uint8_t mask)
+    {
+        // rapid LED update order is grid rows, side buttons from top to bottom, top buttons from left to right
+        std::array<std::uint8_t, LED_COUNT> _flat;
+        for (std::size_t _row = 0; _row < 8; ++_row) {
+            for (std::size_t _column = 0; _column < 8; ++_column) {
+                _flat[_row * 8 + _column] = frame.grid[_row][_column].value() & mask;
+            }
+        }
+        for (std::size_t _index = 0; _index < 8; ++_index) {
+            _flat[64 + _index] = frame.side[_index].value() & mask;
+            _flat[72 + _index] = frame.top[_index].value() & mask;
+        }
+        return _flat;
+    }
+
+    static void encode_rapid_led_flat(std::vector<std::uint8_t>& encoded, const std::array<std::uint8_t, LED_COUNT>& flat)
+    {
+        // any other message resets the rapid update cursor, the X-Y layout is also required to address LEDs
+        novation_launchpads::encode_button_layout(encoded, 0);
+        for (std::size_t _index = 0; _index < LED_COUNT; _index += 2) {
+            encoded.push_back(LED_RAPID_UPDATE);
+            encoded.push_back(flat[_index]);
+            encoded.push_back(flat[_index + 1]);
+        }
+    }
+
+    static constexpr std::uint8_t LED_BAYER_8X8[64] = {
+        0, 32, 8, 40, 2, 34, 10, 42,
+        48, 16, 56, 24, 50, 18, 58, 26,
+        12, 44, 4, 36, 14, 46, 6, 38,
+        60, 28, 52, 20, 62, 30, 54, 22,
+        3, 35, 11, 43, 1, 33, 9, 41,
+        51, 19, 59, 27, 49, 17, 57, 25,
+        15, 47, 7, 39, 13, 45, 5, 37,
+        63, 31, 55, 23, 61, 29, 53, 21
+    };
+
+    static std::uint8_t quantize_led_level(const float level)
+    {
+        // clamped before the conversion, which is undefined beyond the range of int, NaN fails both comparisons and maps to 0
+        const float _level = level >= 0.f ? (level < 3.f ? level : 3.f) : 0.f;
+        return static_cast<std::uint8_t>(_level);
+    }
+
+    template <std::size_t Channels, typename T>
+    static void quantize_led_frames(const std::vector<T>& pixels, const float scale, const novation_launchpads::led_dithering dithering, std::vector<novation_launchpads::led_frame>& frames)
+    {
+        // greyscale drives both LEDs, RGB drives red and green LEDs from the first two channels
+        static constexpr std::size_t _green_channel = Channels > 1 ? 1 : 0;
+        const std::size_t _frame_count = pixels.size() / (64 * Channels);
+        const float _level_scale = scale * 3.f;
+        const std::size_t _frames_offset = frames.size();
+        frames.resize(_frames_offset + _frame_count, novation_launchpads::led_frame {});
+
+        if (dithering == novation_launchpads::led_dithering::error_diffusion) {
+            for (std::size_t _frame_index = 0; _frame_index < _frame_count; ++_frame_index) {
+                const T* _pixels_ptr = pixels.data() + _frame_index * 64 * Channels;
+                std::array<std::array<float, 64>, 2> _levels;
+                for (std::size_t _index = 0; _index < 64; ++_index) {
+                    _levels[0][_index] = _pixels_ptr[_index * Channels] * _level_scale;
+                    _levels[1][_index] = _pixels_ptr[_index * Channels + _green_channel] * _level_scale;
+                }
+                std::array<std::array<std::uint8_t, 64>, 2> _quantized;
+                for (std::size_t _channel = 0; _channel < 2; ++_channel) {
+                    float* _level_ptr = _levels[_channel].data();
+                    for (std::size_t _index = 0; _index < 64; ++_index) {
+                        const std::size_t _column = _index % 8;
+                        const std::uint8_t _quantized_level = quantize_led_level(_level_ptr[_index] + 0.5f);
+                        const float _error = _level_ptr[_index] - _quantized_level;
+                        _quantized[_channel][_index] = _quantized_level;
+                        if (_column < 7) {
+                            _level_ptr[_index + 1] += _error * (7.f / 16.f);
+                        }
+                        if (_index + 8 < 64) {
+                            if (_column > 0) {
+                                _level_ptr[_index + 7] += _error * (3.f / 16.f);
+                            }
+                            _level_ptr[_index + 8] += _error * (5.f / 16.f);
+                            if (_column < 7) {
+                                _level_ptr[_index + 9] += _error * (1.f / 16.f);
+                            }
+                        }
+                    }
+                }
+                for (std::size_t _index = 0; _index < 64; ++_index) {
+                    frames[_frames_offset + _frame_index].grid[_index / 8][_index % 8] = _quantized[0][_index] | (_quantized[1][_index] << 4);
+                }
+            }
+            return;
+        }
+
+        // without error diffusion pixels are independent, the whole batch is quantized in one branchless pass
+        std::array<float, 64> _thresholds;
+        for (std::size_t _index = 0; _index < 64; ++_index) {
+            _thresholds[_index] = dithering == novation_launchpads::led_dithering::ordered ? (LED_BAYER_8X8[_index] + 0.5f) / 64.f : 0.5f;
+        }
+        std::vector<std::uint8_t> _colors(_frame_count * 64);
+        const T* _pixels_ptr = pixels.data();
+        std::uint8_t* _colors_ptr = _colors.data();
+        for (std::size_t _index = 0; _index < _colors.size(); ++_index) {
+            const float _threshold = _thresholds[_index & 63];
+            const std::uint8_t _red = quantize_led_level(_pixels_ptr[_index * Channels] * _level_scale + _threshold);
+            const std::uint8_t _green = quantize_led_level(_pixels_ptr[_index * Channels + _green_channel] * _level_scale + _threshold);
+            _colors_ptr[_index] = _red | (_green << 4);
+        }
+        for (std::size_t _frame_index = 0; _frame_index < _frame_count; ++_frame_index) {
+            for (std::size_t _index = 0; _index < 64; ++_index) {
+                frames[_frames_offset + _frame_index].grid[_index / 8][_index % 8] = _colors_ptr[_frame_index * 64 + _index];
+            }
+        }
+    }
+}
+
+void novation_launchpads::encode_grid_led(
+    std::vector<std::uint8_t>& encoded,
+    const integral<std::uint8_t, 0, 7> row,
+    const integral<std::uint8_t, 0, 7> column,
+    const integral<std::uint8_t, 0, 63> color)
+{
+    encoded.push_back(0x90 | CHANNEL_LAUNCHPAD);
+    encoded.push_back((row.value() << 4) | column.value());
+    encoded.push_back(color.value());
+}
+
+void novation_launchpads::encode_side_led(
+    std::vector<std::uint8_t>& encoded,
+    const integral<std::uint8_t, 0, 7> row,
+    const integral<std::uint8_t, 0, 63> color)
+{
+    encoded.push_back(0x90 | CHANNEL_LAUNCHPAD);
+    encoded.push_back((row.value() << 4) | 0x08);
+    encoded.push_back(color.value());
+}
+
+void novation_launchpads::encode_top_led(
+    std::vector<std::uint8_t>& encoded,
+    const integral<std::uint8_t, 0, 7> column,
+    const integral<std::uint8_t, 0, 63> color)
+{
+    encoded.push_back(0xB0 | CHANNEL_LAUNCHPAD);
+    encoded.push_back(LED_TOP_CONTROLLER + column.value());
+    encoded.push_back(color.value());
+}
+
+void novation_launchpads::encode_rapid_led_update(
+    std::vector<std::uint8_t>& encoded,
+    const led_frame& frame)
+{
+    encoded.reserve(encoded.size() + LED_RAPID_UPDATE_SIZE);
+    encode_rapid_led_flat(encoded, flatten_led_frame(frame, 0x3F));
+}
+
+void novation_launchpads::encode_led_framebuffer(
+    std::vector<std::uint8_t>& encoded,
+    led_framebuffer& framebuffer)
+{
+    // double buffered writes must clear the copy and clear flags to only update the hidden buffer
+    const bool _double_buffered = framebuffer.double_buffered.value() != 0;
+    const std::array<std::uint8_t, LED_COUNT> _back = flatten_led_frame(framebuffer.back, _double_buffered ? LED_FLAGS_MASK : 0x3F);
+    const std::array<std::uint8_t, LED_COUNT> _front = flatten_led_frame(framebuffer.front, _double_buffered ? LED_FLAGS_MASK : 0x3F);
+
+    std::size_t _changed_count = 0;
+    for (std::size_t _index = 0; _index < LED_COUNT; ++_index) {
+        _changed_count += _back[_index] != _front[_index];
+    }
+    if (_changed_count == 0) {
+        return;
+    }
+
+    if (_changed_count * LED_MESSAGE_SIZE > LED_RAPID_UPDATE_SIZE) {
+        encoded.reserve(encoded.size() + LED_RAPID_UPDATE_SIZE + LED_MESSAGE_SIZE);
+        encode_rapid_led_flat(encoded, _back);
+    } else {
+        encoded.reserve(encoded.size() + (_changed_count + 1) * LED_MESSAGE_SIZE);
+        for (std::size_t _index = 0; _index < LED_COUNT; ++_index) {
+            if (_back[_index] == _front[_index]) {
+                continue;
+            }
+            if (_index < 64) {
+                encode_grid_led(encoded, static_cast<std::uint8_t>(_index / 8), static_cast<std::uint8_t>(_index % 8), _back[_index]);
+            } else if (_index < 72) {
+                encode_side_led(encoded, static_cast<std::uint8_t>(_index - 64), _back[_index]);
+            } else {
+                encode_top_led(encoded, static_cast<std::uint8_t>(_index - 72), _back[_index]);
+            }
+        }
+    }
+
+    if (_double_buffered) {
+        // display the updated buffer and copy it to the new hidden buffer
+        const bool _displays_buffer_0 = framebuffer.displayed_buffer.value() == 0;
+        encode_led_buffers_mode(encoded, _displays_buffer_0 ? LED_BUFFERS_MODE_BUFFERED_1_COPY : LED_BUFFERS_MODE_BUFFERED_0_COPY);
+        framebuffer.displayed_buffer = _displays_buffer_0 ? 1 : 0;
+    }
+    framebuffer.front = framebuffer.back;
+}
+
+void novation_launchpads::quantize_rgb_frames(
+    const std::vector<float>& pixels,
+    const led_dithering dithering,
+    std::vector<led_frame>& frames)
+{
+    quantize_led_frames<3>(pixels, 1.f, dithering, frames);
+}
+
+void novation_launchpads::quantize_rgb_frames(
+    const std::vector<std::uint8_t>& pixels,
+    const led_dithering dithering,
+    std::vector<led_frame>& frames)
+{
+    quantize_led_frames<3>(pixels, 1.f / 255.f, dithering, frames);
+}
+
+void novation_launchpads::quantize_greyscale_frames(
+    const std::vector<float>& pixels,
+    const led_dithering dithering,
+    std::vector<led_frame>& frames)
+{
+    quantize_led_frames<1>(pixels, 1.f, dithering, frames);
+}
+
+void novation_launchpads::quantize_greyscale_frames(
+    const std::vector<std::uint8_t>& pixels,
+    const led_dithering dithering,
+    std::vector<led_frame>& frames)
+{
+    quantize_led_frames<1>(pixels, 1.f / 255.f, dithering, frames);
+}
+
 // system exclusive
 
 namespace {
@@ -190,7 +432,7 @@ void novation_launchpads::encode_universal_inquiry_request(
     encoded.push_back(SYSEX_END);
 }
 
-bool novation_launchpads::decode_universal_inquiry(
+decode_result novation_launchpads::decode_universal_inquiry(
     const std::vector<std::uint8_t>& encoded,
     integral<std::uint8_t, 0, 127>& device,
     std::uint32_t& manufacturer,
@@ -199,28 +441,46 @@ bool novation_launchpads::decode_universal_inquiry(
     std::uint32_t& version)
 {
     if (encoded.size() < 15) {
-        return false;
+        return decode_error::size;
     }
     if (encoded[0] != SYSEX_START) {
-        return false;
+        return decode_error::header;
     }
     if (encoded[1] != 0x7E) {
-        return false;
+        return decode_error::header;
+    }
+    if (encoded[3] != 0x06) {
+        return decode_error::header;
+    }
+    if (encoded[4] != 0x02) {
+        return decode_error::header;
     }
     if (encoded.back() != SYSEX_END) {
-        return false;
+        return decode_error::header;
     }
     for (std::size_t _index = 1; _index + 1 < encoded.size(); ++_index) {
         if (encoded[_index] & 0x80) {
-            return false;
+            return decode_error::range;
         }
     }
 
     device = encoded[2] & 0x7F;
-    std::size_t _index = 7;
+    std::size_t _index = 5;
 
-    manufacturer = (encoded[_index] << 16) | (encoded[_index + 1] << 8) | encoded[_index + 2];
-    _index += 3;
+    if (encoded[_index] == 0x00) {
+        if (encoded.size() < _index + 3 + 2 + 2 + 4 + 1) {
+            return decode_error::size;
+        }
+        manufacturer = (encoded[_index] << 16) | (encoded[_index + 1] << 8) | encoded[_index + 2];
+        _index += 3;
+
+    } else {
+        if (encoded.size() < _index + 1 + 2 + 2 + 4 + 1) {
+            return decode_error::size;
+        }
+        manufacturer = encoded[_index];
+        _index += 1;
+    }
 
     family = encoded[_index] | (encoded[_index + 1] << 8);
     _index += 2;
@@ -229,7 +489,7 @@ bool novation_launchpads::decode_universal_inquiry(
     _index += 2;
 
     version = (encoded[_index] << 24) | (encoded[_index + 1] << 16) | (encoded[_index + 2] << 8) | encoded[_index + 3];
-    return true;
+    return decode_error::none;
 }
 
 }
\ No newline at end of file
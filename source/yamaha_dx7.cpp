@@ -23,21 +23,21 @@ void yamaha_dx7::encode_note_off(
     encoded.push_back(0x00);
 }
 
-bool yamaha_dx7::decode_note_off(
+decode_result yamaha_dx7::decode_note_off(
     const std::vector<std::uint8_t>& encoded,
     integral<std::uint8_t, 0, 15>& channel,
     integral<std::uint8_t, 0, 127>& note)
 {
     if (encoded.size() != 3) {
-        return false;
+        return decode_error::size;
     }
     if ((encoded[0] & 0xF0) != 0x80) {
-        return false;
+        return decode_error::header;
     }
 
     channel = encoded[0] & 0x0F;
     note = encoded[1] & 0x7F;
-    return true;
+    return decode_error::none;
 }
 
 void yamaha_dx7::encode_note_on(
@@ -51,23 +51,23 @@ void yamaha_dx7::encode_note_on(
     encoded.push_back(velocity.value() & 0x7F);
 }
 
-bool yamaha_dx7::decode_note_on(
+decode_result yamaha_dx7::decode_note_on(
     const std::vector<std::uint8_t>& encoded,
     integral<std::uint8_t, 0, 15>& channel,
     integral<std::uint8_t, 0, 127>& note,
     integral<std::uint8_t, 0, 127>& velocity)
 {
     if (encoded.size() != 3) {
-        return false;
+        return decode_error::size;
     }
     if ((encoded[0] & 0xF0) != 0x90) {
-        return false;
+        return decode_error::header;
     }
 
     channel = encoded[0] & 0x0F;
     note = encoded[1] & 0x7F;
     velocity = encoded[2] & 0x7F;
-    return true;
+    return decode_error::none;
 }
 
 void yamaha_dx7::encode_program_change(
@@ -79,21 +79,21 @@ void yamaha_dx7::encode_program_change(
     encoded.push_back(program.value() & 0x7F);
 }
 
-bool yamaha_dx7::decode_program_change(
+decode_result yamaha_dx7::decode_program_change(
     const std::vector<std::uint8_t>& encoded,
     integral<std::uint8_t, 0, 15>& channel,
     integral<std::uint8_t, 0, 31>& program)
 {
     if (encoded.size() != 2) {
-        return false;
+        return decode_error::size;
     }
     if ((encoded[0] & 0xF0) != 0xC0) {
-        return false;
+        return decode_error::header;
     }
 
     channel = encoded[0] & 0x0F;
     program = encoded[1] & 0x7F;
-    return true;
+    return decode_error::none;
 }
 
 void yamaha_dx7::encode_pitchbend_change(
@@ -106,38 +106,38 @@ void yamaha_dx7::encode_pitchbend_change(
     encoded.push_back(static_cast<std::uint8_t>((pitchbend.value() >> 7) & 0x7F));
 }
 
-bool yamaha_dx7::decode_pitchbend_change(
+decode_result yamaha_dx7::decode_pitchbend_change(
     const std::vector<std::uint8_t>& encoded,
     integral<std::uint8_t, 0, 15>& channel,
     integral<std::uint16_t, 0, 16383, 8192>& pitchbend)
 {
     if (encoded.size() != 3) {
-        return false;
+        return decode_error::size;
     }
     if ((encoded[0] & 0xF0) != 0xE0) {
-        return false;
+        return decode_error::header;
     }
 
     channel = encoded[0] & 0x0F;
     pitchbend = ((encoded[2] & 0x7F) << 7) | encoded[1] & 0x7F;
-    return true;
+    return decode_error::none;
 }
 
-bool yamaha_dx7::decode_channel_pressure(
+decode_result yamaha_dx7::decode_channel_pressure(
     const std::vector<std::uint8_t>& encoded,
     integral<std::uint8_t, 0, 15>& channel,
     integral<std::uint8_t, 0, 127>& pressure)
 {
     if (encoded.size() != 2) {
-        return false;
+        return decode_error::size;
     }
     if ((encoded[0] & 0xF0) != 0xD0) {
-        return false;
+        return decode_error::header;
     }
 
     channel = encoded[0] & 0x0F;
     pressure = encoded[1] & 0x7F;
-    return true;
+    return decode_error::none;
 }
 
 // system exclusive
@@ -223,6 +223,7 @@ namespace {
     static constexpr std::uint8_t SYSEX_BUTTON_YES = 0x29;
 
     static constexpr std::uint8_t SYSEX_VCED_SINGLE = 0x00;
+    static constexpr std::size_t SYSEX_VCED_SIZE = 155;
     static constexpr std::uint8_t SYSEX_VCED_LENGTH_HIGH = 0x01;
     static constexpr std::uint8_t SYSEX_VCED_LENGTH_LOW = 0x1B;
 
@@ -230,6 +231,17 @@ namespace {
     static constexpr std::uint8_t SYSEX_VMEM_LENGTH_HIGH = 0x20;
     static constexpr std::uint8_t SYSEX_VMEM_LENGTH_LOW = 0x00;
 
+    /// checks a parameter against the range of its field before assigning it, out of range bytes are reported instead of thrown or clamped
+    template <typename T, T MinValue, T MaxValue, T DefaultValue>
+    static bool decode_parameter(const std::uint8_t parameter, integral<T, MinValue, MaxValue, DefaultValue>& field)
+    {
+        if (parameter < MinValue || parameter > MaxValue) {
+            return false;
+        }
+        field = parameter;
+        return true;
+    }
+
     static std::uint8_t compute_sysex_checksum(const std::uint8_t* data, const std::size_t length)
     {
         std::uint32_t _sum = 0;
@@ -281,6 +293,61 @@ namespace {
         encoded.push_back(compute_sysex_checksum(payload, payload_length) & 0x7F);
         encoded.push_back(SYSEX_END);
     }
+
+    static void encode_voice_parameters(const yamaha_dx7::voice_patch& data, std::uint8_t* parameters)
+    {
+        for (std::size_t _op_reversed_index = 0; _op_reversed_index < 6; ++_op_reversed_index) {
+            const std::size_t _op_index = 5 - _op_reversed_index;
+            const std::size_t _op_base = static_cast<std::size_t>(_op_reversed_index) * SYSEX_VOICE_OP_BLOCK_STRIDE;
+            std::uint8_t* _op_ptr = parameters + _op_base;
+
+            _op_ptr[SYSEX_VOICE_OP_ENVELOPE_GENERATOR_RATE_1] = data.op_envelope_generator_rate_1[_op_index].value() & 0x7F;
+            _op_ptr[SYSEX_VOICE_OP_ENVELOPE_GENERATOR_RATE_2] = data.op_envelope_generator_rate_2[_op_index].value() & 0x7F;
+            _op_ptr[SYSEX_VOICE_OP_ENVELOPE_GENERATOR_RATE_3] = data.op_envelope_generator_rate_3[_op_index].value() & 0x7F;
+            _op_ptr[SYSEX_VOICE_OP_ENVELOPE_GENERATOR_RATE_4] = data.op_envelope_generator_rate_4[_op_index].value() & 0x7F;
+            _op_ptr[SYSEX_VOICE_OP_ENVELOPE_GENERATOR_LEVEL_1] = data.op_envelope_generator_level_1[_op_index].value() & 0x7F;
+            _op_ptr[SYSEX_VOICE_OP_ENVELOPE_GENERATOR_LEVEL_2] = data.op_envelope_generator_level_2[_op_index].value() & 0x7F;
+            _op_ptr[SYSEX_VOICE_OP_ENVELOPE_GENERATOR_LEVEL_3] = data.op_envelope_generator_level_3[_op_index].value() & 0x7F;
+            _op_ptr[SYSEX_VOICE_OP_ENVELOPE_GENERATOR_LEVEL_4] = data.op_envelope_generator_level_4[_op_index].value() & 0x7F;
+            _op_ptr[SYSEX_VOICE_OP_KEYBOARD_SCALING_BREAKPOINT] = data.op_keyboard_scaling_breakpoint[_op_index].value() & 0x7F;
+            _op_ptr[SYSEX_VOICE_OP_KEYBOARD_SCALING_LEFT_DEPTH] = data.op_keyboard_scaling_left_depth[_op_index].value() & 0x7F;
+            _op_ptr[SYSEX_VOICE_OP_KEYBOARD_SCALING_RIGHT_DEPTH] = data.op_keyboard_scaling_right_depth[_op_index].value() & 0x7F;
+            _op_ptr[SYSEX_VOICE_OP_KEYBOARD_SCALING_LEFT_CURVE] = data.op_keyboard_scaling_left_curve[_op_index].value() & 0x03;
+            _op_ptr[SYSEX_VOICE_OP_KEYBOARD_SCALING_RIGHT_CURVE] = data.op_keyboard_scaling_right_curve[_op_index].value() & 0x03;
+            _op_ptr[SYSEX_VOICE_OP_KEYBOARD_SCALING_RATE] = data.op_keyboard_scaling_rate[_op_index].value() & 0x07;
+            _op_ptr[SYSEX_VOICE_OP_AMPLITUDE_MODULATION_SENSITIVITY] = data.op_amplitude_modulation_sensitivity[_op_index].value() & 0x03;
+            _op_ptr[SYSEX_VOICE_OP_VELOCITY_SENSITIVITY] = data.op_velocity_sensitivity[_op_index].value() & 0x07;
+            _op_ptr[SYSEX_VOICE_OP_OUTPUT_LEVEL] = data.op_output_level[_op_index].value() & 0x7F;
+            _op_ptr[SYSEX_VOICE_OP_OSCILLATOR_MODE] = data.op_oscillator_mode[_op_index].value() & 0x01;
+            _op_ptr[SYSEX_VOICE_OP_OSCILLATOR_COARSE] = data.op_oscillator_coarse[_op_index].value() & 0x1F;
+            _op_ptr[SYSEX_VOICE_OP_OSCILLATOR_FINE] = data.op_oscillator_fine[_op_index].value() & 0x7F;
+            _op_ptr[SYSEX_VOICE_OP_OSCILLATOR_DETUNE] = data.op_oscillator_detune[_op_index].value() & 0x0F;
+        }
+
+        parameters[SYSEX_VOICE_PITCH_ENVELOPE_RATE_1] = data.pitch_envelope_rate_1.value() & 0x7F;
+        parameters[SYSEX_VOICE_PITCH_ENVELOPE_RATE_2] = data.pitch_envelope_rate_2.value() & 0x7F;
+        parameters[SYSEX_VOICE_PITCH_ENVELOPE_RATE_3] = data.pitch_envelope_rate_3.value() & 0x7F;
+        parameters[SYSEX_VOICE_PITCH_ENVELOPE_RATE_4] = data.pitch_envelope_rate_4.value() & 0x7F;
+        parameters[SYSEX_VOICE_PITCH_ENVELOPE_LEVEL_1] = data.pitch_envelope_level_1.value() & 0x7F;
+        parameters[SYSEX_VOICE_PITCH_ENVELOPE_LEVEL_2] = data.pitch_envelope_level_2.value() & 0x7F;
+        parameters[SYSEX_VOICE_PITCH_ENVELOPE_LEVEL_3] = data.pitch_envelope_level_3.value() & 0x7F;
+        parameters[SYSEX_VOICE_PITCH_ENVELOPE_LEVEL_4] = data.pitch_envelope_level_4.value() & 0x7F;
+        parameters[SYSEX_VOICE_ALGORITHM_MODE] = data.algorithm_mode.value() & 0x7F;
+        parameters[SYSEX_VOICE_ALGORITHM_FEEDBACK] = data.algorithm_feedback.value() & 0x07;
+        parameters[SYSEX_VOICE_OSCILLATOR_KEY_SYNC] = data.oscillator_key_sync.value();
+        parameters[SYSEX_VOICE_LFO_SPEED] = data.lfo_speed.value() & 0x7F;
+        parameters[SYSEX_VOICE_LFO_DELAY] = data.lfo_delay.value() & 0x7F;
+        parameters[SYSEX_VOICE_LFO_PITCH_MODULATION_DEPTH] = data.lfo_pitch_modulation_depth.value() & 0x7F;
+        parameters[SYSEX_VOICE_LFO_AMPLITUDE_MODULATION_DEPTH] = data.lfo_amplitude_modulation_depth.value() & 0x7F;
+        parameters[SYSEX_VOICE_LFO_SYNC] = data.lfo_sync.value();
+        parameters[SYSEX_VOICE_LFO_WAVEFORM] = data.lfo_waveform_mode.value() & 0x07;
+        parameters[SYSEX_VOICE_PITCH_MODULATION_SENSITIVITY] = data.pitch_modulation_sensitivity.value() & 0x07;
+        parameters[SYSEX_VOICE_TRANSPOSE] = data.transpose_semitones.value() & 0x7F;
+
+        for (std::size_t _char_index = 0; _char_index < 10; ++_char_index) {
+            parameters[SYSEX_VOICE_VOICE_NAME_1 + _char_index] = static_cast<std::uint8_t>(data.voice_name[_char_index]) & 0x7F;
+        }
+    }
 }
 
 void yamaha_dx7::encode_op_envelope_generator_rate_1(
@@ -848,65 +915,32 @@ void yamaha_dx7::encode_voice_patch(
     const integral<std::uint8_t, 0, 15> device,
     const voice_patch& data)
 {
-    std::array<std::uint8_t, 155> _vced {};
-    std::uint8_t* _voice_ptr = _vced.data();
-
-    for (std::size_t _op_reversed_index = 0; _op_reversed_index < 6; ++_op_reversed_index) {
-        const std::size_t _op_index = 5 - _op_reversed_index;
-        const std::size_t _op_base = static_cast<std::size_t>(_op_reversed_index) * SYSEX_VOICE_OP_BLOCK_STRIDE;
-        std::uint8_t* _op_ptr = _voice_ptr + _op_base;
-
-        _op_ptr[SYSEX_VOICE_OP_ENVELOPE_GENERATOR_RATE_1] = data.op_envelope_generator_rate_1[_op_index].value() & 0x7F;
-        _op_ptr[SYSEX_VOICE_OP_ENVELOPE_GENERATOR_RATE_2] = data.op_envelope_generator_rate_2[_op_index].value() & 0x7F;
-        _op_ptr[SYSEX_VOICE_OP_ENVELOPE_GENERATOR_RATE_3] = data.op_envelope_generator_rate_3[_op_index].value() & 0x7F;
-        _op_ptr[SYSEX_VOICE_OP_ENVELOPE_GENERATOR_RATE_4] = data.op_envelope_generator_rate_4[_op_index].value() & 0x7F;
-        _op_ptr[SYSEX_VOICE_OP_ENVELOPE_GENERATOR_LEVEL_1] = data.op_envelope_generator_level_1[_op_index].value() & 0x7F;
-        _op_ptr[SYSEX_VOICE_OP_ENVELOPE_GENERATOR_LEVEL_2] = data.op_envelope_generator_level_2[_op_index].value() & 0x7F;
-        _op_ptr[SYSEX_VOICE_OP_ENVELOPE_GENERATOR_LEVEL_3] = data.op_envelope_generator_level_3[_op_index].value() & 0x7F;
-        _op_ptr[SYSEX_VOICE_OP_ENVELOPE_GENERATOR_LEVEL_4] = data.op_envelope_generator_level_4[_op_index].value() & 0x7F;
-        _op_ptr[SYSEX_VOICE_OP_KEYBOARD_SCALING_BREAKPOINT] = data.op_keyboard_scaling_breakpoint[_op_index].value() & 0x7F;
-        _op_ptr[SYSEX_VOICE_OP_KEYBOARD_SCALING_LEFT_DEPTH] = data.op_keyboard_scaling_left_depth[_op_index].value() & 0x7F;
-        _op_ptr[SYSEX_VOICE_OP_KEYBOARD_SCALING_RIGHT_DEPTH] = data.op_keyboard_scaling_right_depth[_op_index].value() & 0x7F;
-        _op_ptr[SYSEX_VOICE_OP_KEYBOARD_SCALING_LEFT_CURVE] = data.op_keyboard_scaling_left_curve[_op_index].value() & 0x03;
-        _op_ptr[SYSEX_VOICE_OP_KEYBOARD_SCALING_RIGHT_CURVE] = data.op_keyboard_scaling_right_curve[_op_index].value() & 0x03;
-        _op_ptr[SYSEX_VOICE_OP_KEYBOARD_SCALING_RATE] = data.op_keyboard_scaling_rate[_op_index].value() & 0x07;
-        _op_ptr[SYSEX_VOICE_OP_AMPLITUDE_MODULATION_SENSITIVITY] = data.op_amplitude_modulation_sensitivity[_op_index].value() & 0x03;
-        _op_ptr[SYSEX_VOICE_OP_VELOCITY_SENSITIVITY] = data.op_velocity_sensitivity[_op_index].value() & 0x07;
-        _op_ptr[SYSEX_VOICE_OP_OUTPUT_LEVEL] = data.op_output_level[_op_index].value() & 0x7F;
-        _op_ptr[SYSEX_VOICE_OP_OSCILLATOR_MODE] = data.op_oscillator_mode[_op_index].value() & 0x01;
-        _op_ptr[SYSEX_VOICE_OP_OSCILLATOR_COARSE] = data.op_oscillator_coarse[_op_index].value() & 0x1F;
-        _op_ptr[SYSEX_VOICE_OP_OSCILLATOR_FINE] = data.op_oscillator_fine[_op_index].value() & 0x7F;
-        _op_ptr[SYSEX_VOICE_OP_OSCILLATOR_DETUNE] = data.op_oscillator_detune[_op_index].value() & 0x0F;
-    }
-
-    _voice_ptr[SYSEX_VOICE_PITCH_ENVELOPE_RATE_1] = data.pitch_envelope_rate_1.value() & 0x7F;
-    _voice_ptr[SYSEX_VOICE_PITCH_ENVELOPE_RATE_2] = data.pitch_envelope_rate_2.value() & 0x7F;
-    _voice_ptr[SYSEX_VOICE_PITCH_ENVELOPE_RATE_3] = data.pitch_envelope_rate_3.value() & 0x7F;
-    _voice_ptr[SYSEX_VOICE_PITCH_ENVELOPE_RATE_4] = data.pitch_envelope_rate_4.value() & 0x7F;
-    _voice_ptr[SYSEX_VOICE_PITCH_ENVELOPE_LEVEL_1] = data.pitch_envelope_level_1.value() & 0x7F;
-    _voice_ptr[SYSEX_VOICE_PITCH_ENVELOPE_LEVEL_2] = data.pitch_envelope_level_2.value() & 0x7F;
-    _voice_ptr[SYSEX_VOICE_PITCH_ENVELOPE_LEVEL_3] = data.pitch_envelope_level_3.value() & 0x7F;
-    _voice_ptr[SYSEX_VOICE_PITCH_ENVELOPE_LEVEL_4] = data.pitch_envelope_level_4.value() & 0x7F;
-    _voice_ptr[SYSEX_VOICE_ALGORITHM_MODE] = data.algorithm_mode.value() & 0x7F;
-    _voice_ptr[SYSEX_VOICE_ALGORITHM_FEEDBACK] = data.algorithm_feedback.value() & 0x07;
-    _voice_ptr[SYSEX_VOICE_OSCILLATOR_KEY_SYNC] = data.oscillator_key_sync.value();
-    _voice_ptr[SYSEX_VOICE_LFO_SPEED] = data.lfo_speed.value() & 0x7F;
-    _voice_ptr[SYSEX_VOICE_LFO_DELAY] = data.lfo_delay.value() & 0x7F;
-    _voice_ptr[SYSEX_VOICE_LFO_PITCH_MODULATION_DEPTH] = data.lfo_pitch_modulation_depth.value() & 0x7F;
-    _voice_ptr[SYSEX_VOICE_LFO_AMPLITUDE_MODULATION_DEPTH] = data.lfo_amplitude_modulation_depth.value() & 0x7F;
-    _voice_ptr[SYSEX_VOICE_LFO_SYNC] = data.lfo_sync.value();
-    _voice_ptr[SYSEX_VOICE_LFO_WAVEFORM] = data.lfo_waveform_mode.value() & 0x07;
-    _voice_ptr[SYSEX_VOICE_PITCH_MODULATION_SENSITIVITY] = data.pitch_modulation_sensitivity.value() & 0x07;
-    _voice_ptr[SYSEX_VOICE_TRANSPOSE] = data.transpose_semitones.value() & 0x7F;
-
-    for (std::size_t _char_index = 0; _char_index < 10; ++_char_index) {
-        _voice_ptr[SYSEX_VOICE_VOICE_NAME_1 + _char_index] = static_cast<std::uint8_t>(data.voice_name[_char_index]) & 0x7F;
-    }
+    std::array<std::uint8_t, SYSEX_VCED_SIZE> _vced {};
+    encode_voice_parameters(data, _vced.data());
 
     encode_sysex_bulk_header(encoded, device.value(), SYSEX_VCED_SINGLE, SYSEX_VCED_LENGTH_HIGH, SYSEX_VCED_LENGTH_LOW);
     encode_sysex_bulk_finish(encoded, _vced.data(), _vced.size());
 }
 
+void yamaha_dx7::encode_voice_patch_changes(
+    std::vector<std::uint8_t>& encoded,
+    const integral<std::uint8_t, 0, 15> device,
+    const voice_patch& previous,
+    const voice_patch& data)
+{
+    std::array<std::uint8_t, SYSEX_VCED_SIZE> _previous_vced {};
+    std::array<std::uint8_t, SYSEX_VCED_SIZE> _vced {};
+    encode_voice_parameters(previous, _previous_vced.data());
+    encode_voice_parameters(data, _vced.data());
+
+    // VCED offsets are the parameter numbers of the voice group
+    for (std::size_t _parameter = 0; _parameter < SYSEX_VCED_SIZE; ++_parameter) {
+        if (_vced[_parameter] != _previous_vced[_parameter]) {
+            encode_sysex_parameter(encoded, device.value(), SYSEX_GROUP_VOICE, static_cast<std::uint16_t>(_parameter), _vced[_parameter]);
+        }
+    }
+}
+
 void yamaha_dx7::encode_voice_patch_bank(
     std::vector<std::uint8_t>& encoded,
     const integral<std::uint8_t, 0, 15> device,
@@ -967,18 +1001,21 @@ void yamaha_dx7::encode_voice_patch_bank(
     encode_sysex_bulk_finish(encoded, _vmem.data(), _vmem.size());
 }
 
-bool yamaha_dx7::decode_voice_patch_bank(
+decode_result yamaha_dx7::decode_voice_patch_bank(
     const std::vector<std::uint8_t>& encoded,
     integral<std::uint8_t, 0, 15>& device,
     std::array<voice_patch, 32>& data)
 {
-    if (encoded.size() < 8 || encoded[0] != SYSEX_START || encoded[1] != SYSEX_YAMAHA || encoded.back() != SYSEX_END) {
-        return false;
+    if (encoded.size() < 8) {
+        return decode_error::size;
+    }
+    if (encoded[0] != SYSEX_START || encoded[1] != SYSEX_YAMAHA || encoded.back() != SYSEX_END) {
+        return decode_error::header;
     }
 
     const bool _vmem_byte_is_correct = (encoded[2] & 0x70) == 0x00;
     if (!_vmem_byte_is_correct) {
-        return false;
+        return decode_error::header;
     }
 
     const std::uint8_t _header_group = encoded[3] & 0x7F;
@@ -987,23 +1024,26 @@ bool yamaha_dx7::decode_voice_patch_bank(
     const std::uint8_t _header_payload_offset = 6;
     const std::size_t _header_payload_length = encoded.size() - 6 - 1 - 1;
     if (_header_payload_length == 0) {
-        return false;
+        return decode_error::size;
     }
 
     const std::size_t _checksum_index = encoded.size() - 2;
     const std::uint8_t _checksum_calculation = compute_sysex_checksum(encoded.data() + _header_payload_offset, _header_payload_length);
     if ((encoded[_checksum_index] & 0x7F) != _checksum_calculation) {
-        return false;
+        return decode_error::checksum;
     }
 
     if (_header_group != SYSEX_VMEM_BANK || _header_length_high != SYSEX_VMEM_LENGTH_HIGH || _header_length_low != SYSEX_VMEM_LENGTH_LOW) {
-        return false;
+        return decode_error::header;
     }
 
     if (_header_payload_length != 4096) {
-        return false;
+        return decode_error::size;
     }
 
+    // voices are decoded aside so that a bank with an out of range field leaves data unchanged
+    std::array<voice_patch, 32> _decoded = data;
+    bool _in_range = true;
     const std::uint8_t* _bank_ptr = encoded.data() + _header_payload_offset;
     for (std::size_t _voice_index = 0; _voice_index < 32; ++_voice_index) {
 
@@ -1014,54 +1054,59 @@ bool yamaha_dx7::decode_voice_patch_bank(
             const std::size_t _op_index = 5 - _op_reversed_index;
             const std::uint8_t* _op_ptr = _voice_ptr + _op_base;
 
-            data[_voice_index].op_envelope_generator_rate_1[_op_index] = _op_ptr[0];
-            data[_voice_index].op_envelope_generator_rate_2[_op_index] = _op_ptr[1];
-            data[_voice_index].op_envelope_generator_rate_3[_op_index] = _op_ptr[2];
-            data[_voice_index].op_envelope_generator_rate_4[_op_index] = _op_ptr[3];
-            data[_voice_index].op_envelope_generator_level_1[_op_index] = _op_ptr[4];
-            data[_voice_index].op_envelope_generator_level_2[_op_index] = _op_ptr[5];
-            data[_voice_index].op_envelope_generator_level_3[_op_index] = _op_ptr[6];
-            data[_voice_index].op_envelope_generator_level_4[_op_index] = _op_ptr[7];
-            data[_voice_index].op_keyboard_scaling_breakpoint[_op_index] = _op_ptr[8];
-            data[_voice_index].op_keyboard_scaling_left_depth[_op_index] = _op_ptr[9];
-            data[_voice_index].op_keyboard_scaling_right_depth[_op_index] = _op_ptr[10];
-            data[_voice_index].op_keyboard_scaling_left_curve[_op_index] = _op_ptr[11] & 0x03;
-            data[_voice_index].op_keyboard_scaling_right_curve[_op_index] = (_op_ptr[11] >> 2) & 0x03;
-            data[_voice_index].op_keyboard_scaling_rate[_op_index] = _op_ptr[12] & 0x07;
-            data[_voice_index].op_amplitude_modulation_sensitivity[_op_index] = _op_ptr[13] & 0x03;
-            data[_voice_index].op_velocity_sensitivity[_op_index] = (_op_ptr[13] >> 2) & 0x07;
-            data[_voice_index].op_output_level[_op_index] = _op_ptr[14];
-            data[_voice_index].op_oscillator_mode[_op_index] = _op_ptr[15] & 0x01;
-            data[_voice_index].op_oscillator_coarse[_op_index] = (_op_ptr[15] >> 1) & 0x1F;
-            data[_voice_index].op_oscillator_fine[_op_index] = _op_ptr[16];
-            data[_voice_index].op_oscillator_detune[_op_index] = (_op_ptr[12] >> 3) & 0x0F;
+            _in_range &= decode_parameter(_op_ptr[0], _decoded[_voice_index].op_envelope_generator_rate_1[_op_index]);
+            _in_range &= decode_parameter(_op_ptr[1], _decoded[_voice_index].op_envelope_generator_rate_2[_op_index]);
+            _in_range &= decode_parameter(_op_ptr[2], _decoded[_voice_index].op_envelope_generator_rate_3[_op_index]);
+            _in_range &= decode_parameter(_op_ptr[3], _decoded[_voice_index].op_envelope_generator_rate_4[_op_index]);
+            _in_range &= decode_parameter(_op_ptr[4], _decoded[_voice_index].op_envelope_generator_level_1[_op_index]);
+            _in_range &= decode_parameter(_op_ptr[5], _decoded[_voice_index].op_envelope_generator_level_2[_op_index]);
+            _in_range &= decode_parameter(_op_ptr[6], _decoded[_voice_index].op_envelope_generator_level_3[_op_index]);
+            _in_range &= decode_parameter(_op_ptr[7], _decoded[_voice_index].op_envelope_generator_level_4[_op_index]);
+            _in_range &= decode_parameter(_op_ptr[8], _decoded[_voice_index].op_keyboard_scaling_breakpoint[_op_index]);
+            _in_range &= decode_parameter(_op_ptr[9], _decoded[_voice_index].op_keyboard_scaling_left_depth[_op_index]);
+            _in_range &= decode_parameter(_op_ptr[10], _decoded[_voice_index].op_keyboard_scaling_right_depth[_op_index]);
+            _in_range &= decode_parameter(_op_ptr[11] & 0x03, _decoded[_voice_index].op_keyboard_scaling_left_curve[_op_index]);
+            _in_range &= decode_parameter((_op_ptr[11] >> 2) & 0x03, _decoded[_voice_index].op_keyboard_scaling_right_curve[_op_index]);
+            _in_range &= decode_parameter(_op_ptr[12] & 0x07, _decoded[_voice_index].op_keyboard_scaling_rate[_op_index]);
+            _in_range &= decode_parameter(_op_ptr[13] & 0x03, _decoded[_voice_index].op_amplitude_modulation_sensitivity[_op_index]);
+            _in_range &= decode_parameter((_op_ptr[13] >> 2) & 0x07, _decoded[_voice_index].op_velocity_sensitivity[_op_index]);
+            _in_range &= decode_parameter(_op_ptr[14], _decoded[_voice_index].op_output_level[_op_index]);
+            _in_range &= decode_parameter(_op_ptr[15] & 0x01, _decoded[_voice_index].op_oscillator_mode[_op_index]);
+            _in_range &= decode_parameter((_op_ptr[15] >> 1) & 0x1F, _decoded[_voice_index].op_oscillator_coarse[_op_index]);
+            _in_range &= decode_parameter(_op_ptr[16], _decoded[_voice_index].op_oscillator_fine[_op_index]);
+            _in_range &= decode_parameter((_op_ptr[12] >> 3) & 0x0F, _decoded[_voice_index].op_oscillator_detune[_op_index]);
         }
 
-        data[_voice_index].pitch_envelope_rate_1 = _voice_ptr[102];
-        data[_voice_index].pitch_envelope_rate_2 = _voice_ptr[103];
-        data[_voice_index].pitch_envelope_rate_3 = _voice_ptr[104];
-        data[_voice_index].pitch_envelope_rate_4 = _voice_ptr[105];
-        data[_voice_index].pitch_envelope_level_1 = _voice_ptr[106];
-        data[_voice_index].pitch_envelope_level_2 = _voice_ptr[107];
-        data[_voice_index].pitch_envelope_level_3 = _voice_ptr[108];
-        data[_voice_index].pitch_envelope_level_4 = _voice_ptr[109];
-        data[_voice_index].algorithm_mode = _voice_ptr[110] & 0x7F;
-        data[_voice_index].algorithm_feedback = _voice_ptr[111] & 0x07;
-        data[_voice_index].oscillator_key_sync = (_voice_ptr[111] >> 3) & 0x01;
-        data[_voice_index].lfo_waveform_mode = (_voice_ptr[116] >> 1) & 0x07;
-        data[_voice_index].lfo_speed = _voice_ptr[112];
-        data[_voice_index].lfo_delay = _voice_ptr[113];
-        data[_voice_index].lfo_pitch_modulation_depth = _voice_ptr[114];
-        data[_voice_index].lfo_amplitude_modulation_depth = _voice_ptr[115];
-        data[_voice_index].lfo_sync = _voice_ptr[116] & 0x01;
-        data[_voice_index].pitch_modulation_sensitivity = (_voice_ptr[116] >> 4) & 0x07;
-        data[_voice_index].transpose_semitones = _voice_ptr[117];
+        _in_range &= decode_parameter(_voice_ptr[102], _decoded[_voice_index].pitch_envelope_rate_1);
+        _in_range &= decode_parameter(_voice_ptr[103], _decoded[_voice_index].pitch_envelope_rate_2);
+        _in_range &= decode_parameter(_voice_ptr[104], _decoded[_voice_index].pitch_envelope_rate_3);
+        _in_range &= decode_parameter(_voice_ptr[105], _decoded[_voice_index].pitch_envelope_rate_4);
+        _in_range &= decode_parameter(_voice_ptr[106], _decoded[_voice_index].pitch_envelope_level_1);
+        _in_range &= decode_parameter(_voice_ptr[107], _decoded[_voice_index].pitch_envelope_level_2);
+        _in_range &= decode_parameter(_voice_ptr[108], _decoded[_voice_index].pitch_envelope_level_3);
+        _in_range &= decode_parameter(_voice_ptr[109], _decoded[_voice_index].pitch_envelope_level_4);
+        _in_range &= decode_parameter(_voice_ptr[110] & 0x7F, _decoded[_voice_index].algorithm_mode);
+        _in_range &= decode_parameter(_voice_ptr[111] & 0x07, _decoded[_voice_index].algorithm_feedback);
+        _in_range &= decode_parameter((_voice_ptr[111] >> 3) & 0x01, _decoded[_voice_index].oscillator_key_sync);
+        _in_range &= decode_parameter((_voice_ptr[116] >> 1) & 0x07, _decoded[_voice_index].lfo_waveform_mode);
+        _in_range &= decode_parameter(_voice_ptr[112], _decoded[_voice_index].lfo_speed);
+        _in_range &= decode_parameter(_voice_ptr[113], _decoded[_voice_index].lfo_delay);
+        _in_range &= decode_parameter(_voice_ptr[114], _decoded[_voice_index].lfo_pitch_modulation_depth);
+        _in_range &= decode_parameter(_voice_ptr[115], _decoded[_voice_index].lfo_amplitude_modulation_depth);
+        _in_range &= decode_parameter(_voice_ptr[116] & 0x01, _decoded[_voice_index].lfo_sync);
+        _in_range &= decode_parameter((_voice_ptr[116] >> 4) & 0x07, _decoded[_voice_index].pitch_modulation_sensitivity);
+        _in_range &= decode_parameter(_voice_ptr[117], _decoded[_voice_index].transpose_semitones);
         for (std::size_t _name_index = 0; _name_index < 10; ++_name_index) {
-            data[_voice_index].voice_name[_name_index] = static_cast<char>(_voice_ptr[118 + _name_index]);
+            _decoded[_voice_index].voice_name[_name_index] = static_cast<char>(_voice_ptr[118 + _name_index]);
         }
     }
 
+    if (!_in_range) {
+        return decode_error::range;
+    }
+
+    data = _decoded;
     device = encoded[2] & 0x0F;
-    return true;
+    return decode_error::none;
 }
 }
@@ -1,3 +1,5 @@
+#include <midispec/core/metrics.hpp>
+#include <midispec/core/yamaha_tx81z_backup.hpp>
 #include <midispec/yamaha_tx81z.hpp>
 
 /// User manual at
@@ -140,34 +142,164 @@ namespace {
     static constexpr std::uint8_t SYSEX_END = 0xF7;
     static constexpr std::uint8_t SYSEX_YAMAHA = 0x43;
 
-    static constexpr std::uint8_t SYSEX_VCED_OP_ATTACK_RATE = 0;
-    static constexpr std::uint8_t SYSEX_VCED_OP_DECAY_RATE_1 = 1;
-    static constexpr std::uint8_t SYSEX_VCED_OP_DECAY_RATE_2 = 2;
-    static constexpr std::uint8_t SYSEX_VCED_OP_RELEASE_RATE = 3;
-    static constexpr std::uint8_t SYSEX_VCED_OP_DECAY_LEVEL_1 = 4;
-    static constexpr std::uint8_t SYSEX_VCED_OP_LEVEL_SCALING = 5;
-    static constexpr std::uint8_t SYSEX_VCED_OP_RATE_SCALING = 6;
-    static constexpr std::uint8_t SYSEX_VCED_OP_ENVELOPE_GENERATOR_BIAS_SENSITIVITY = 7;
-    static constexpr std::uint8_t SYSEX_VCED_OP_AMPLITUDE_MODULATION_ENABLE = 8;
-    static constexpr std::uint8_t SYSEX_VCED_OP_KEY_VELOCITY_SENSITIVITY = 9;
-    static constexpr std::uint8_t SYSEX_VCED_OP_OUTPUT_LEVEL = 10;
-    static constexpr std::uint8_t SYSEX_VCED_OP_FREQUENCY = 11;
-    static constexpr std::uint8_t SYSEX_VCED_OP_DETUNE = 12;
-
-    static constexpr std::uint8_t SYSEX_VCED_ALGORITHM_MODE = 10;
-    static constexpr std::uint8_t SYSEX_VCED_ALGORITHM_FEEDBACK = 10;
-    static constexpr std::uint8_t SYSEX_VCED_LFO_SPEED = 10;
-    static constexpr std::uint8_t SYSEX_VCED_LFO_DELAY = 10;
-    static constexpr std::uint8_t SYSEX_VCED_PITCH_MODULATION_DEPTH = 10;
-    static constexpr std::uint8_t SYSEX_VCED_AMPLITUDE_MODULATION_DEPTH = 10;
-
     static constexpr std::uint8_t SYSEX_ACED_OP_FIXED_FREQUENCY = 0;
     static constexpr std::uint8_t SYSEX_ACED_OP_FIXED_FREQUENCY_RANGE = 1;
     static constexpr std::uint8_t SYSEX_ACED_OP_FREQUENCY_RANGE_FINE = 2;
     static constexpr std::uint8_t SYSEX_ACED_OP_WAVEFORM = 3;
     static constexpr std::uint8_t SYSEX_ACED_OP_ENVELOPE_GENERATOR_SHIFT = 4;
 
+    static constexpr std::uint8_t SYSEX_ACED_OP_BLOCK_STRIDE = 5;
+    static constexpr std::uint8_t SYSEX_ACED_REVERB_RATE = 20;
+    static constexpr std::uint8_t SYSEX_ACED_FOOT_CONTROLLER_PITCH = 21;
+    static constexpr std::uint8_t SYSEX_ACED_FOOT_CONTROLLER_AMPLITUDE = 22;
+    static constexpr std::uint8_t SYSEX_ACED_SIZE = 23;
+
     static constexpr std::uint8_t SYSEX_VCED_SIZE = 0x005D;
+    static constexpr std::uint8_t SYSEX_VCED_SINGLE = 0x03;
+    static constexpr std::uint8_t SYSEX_ACED_SINGLE = 0x7E;
+    static constexpr std::uint8_t SYSEX_VCED_PARAMETER = 0x12;
+    static constexpr std::uint8_t SYSEX_ACED_PARAMETER = 0x13;
+    static constexpr std::array<std::uint8_t, 10> SYSEX_ACED_HEADER = { 'L', 'M', ' ', ' ', '8', '9', '7', '6', 'A', 'E' };
+    static constexpr std::array<std::uint8_t, 10> SYSEX_PCED_HEADER = { 'L', 'M', ' ', ' ', '8', '9', '7', '6', 'P', 'E' };
+    static constexpr std::array<std::uint8_t, 10> SYSEX_SYSTEM_HEADER = { 'L', 'M', ' ', ' ', '8', '9', '7', '6', 'S', '0' };
+    static constexpr std::array<std::uint8_t, 10> SYSEX_PROGRAM_CHANGE_HEADER = { 'L', 'M', ' ', ' ', '8', '9', '7', '6', 'S', '1' };
+    static constexpr std::array<std::uint8_t, 10> SYSEX_EFFECT_HEADER = { 'L', 'M', ' ', ' ', '8', '9', '7', '6', 'S', '2' };
+    static constexpr std::array<std::uint8_t, 10> SYSEX_MICROTUNE_OCTAVE_HEADER = { 'L', 'M', ' ', ' ', 'M', 'C', 'R', 'T', 'E', '0' };
+    static constexpr std::array<std::uint8_t, 10> SYSEX_MICROTUNE_HEADER = { 'L', 'M', ' ', ' ', 'M', 'C', 'R', 'T', 'E', '1' };
+    static constexpr std::uint8_t SYSEX_MICROTUNE_NOTE_MIN = 13;
+    static constexpr std::uint8_t SYSEX_MICROTUNE_NOTE_MAX = 108;
+
+    static constexpr std::uint8_t SYSEX_VOICE_OP_BLOCK_STRIDE = 13;
+    static constexpr std::uint8_t SYSEX_VOICE_OP_ATTACK_RATE = 0;
+    static constexpr std::uint8_t SYSEX_VOICE_OP_DECAY_RATE_1 = 1;
+    static constexpr std::uint8_t SYSEX_VOICE_OP_DECAY_RATE_2 = 2;
+    static constexpr std::uint8_t SYSEX_VOICE_OP_RELEASE_RATE = 3;
+    static constexpr std::uint8_t SYSEX_VOICE_OP_DECAY_LEVEL_1 = 4;
+    static constexpr std::uint8_t SYSEX_VOICE_OP_LEVEL_SCALING = 5;
+    static constexpr std::uint8_t SYSEX_VOICE_OP_RATE_SCALING = 6;
+    static constexpr std::uint8_t SYSEX_VOICE_OP_ENVELOPE_GENERATOR_BIAS_SENSITIVITY = 7;
+    static constexpr std::uint8_t SYSEX_VOICE_OP_AMPLITUDE_MODULATION_ENABLE = 8;
+    static constexpr std::uint8_t SYSEX_VOICE_OP_KEY_VELOCITY_SENSITIVITY = 9;
+    static constexpr std::uint8_t SYSEX_VOICE_OP_OUTPUT_LEVEL = 10;
+    static constexpr std::uint8_t SYSEX_VOICE_OP_FREQUENCY = 11;
+    static constexpr std::uint8_t SYSEX_VOICE_OP_DETUNE = 12;
+    static constexpr std::uint8_t SYSEX_VOICE_ALGORITHM_MODE = 52;
+    static constexpr std::uint8_t SYSEX_VOICE_ALGORITHM_FEEDBACK = 53;
+    static constexpr std::uint8_t SYSEX_VOICE_LFO_SPEED = 54;
+    static constexpr std::uint8_t SYSEX_VOICE_LFO_DELAY = 55;
+    static constexpr std::uint8_t SYSEX_VOICE_PITCH_MODULATION_DEPTH = 56;
+    static constexpr std::uint8_t SYSEX_VOICE_AMPLITUDE_MODULATION_DEPTH = 57;
+    static constexpr std::uint8_t SYSEX_VOICE_LFO_SYNC = 58;
+    static constexpr std::uint8_t SYSEX_VOICE_LFO_WAVE = 59;
+    static constexpr std::uint8_t SYSEX_VOICE_PITCH_MODULATION_SENSITIVITY = 60;
+    static constexpr std::uint8_t SYSEX_VOICE_AMPLITUDE_MODULATION_SENSITIVITY = 61;
+    static constexpr std::uint8_t SYSEX_VOICE_TRANSPOSE = 62;
+    static constexpr std::uint8_t SYSEX_VOICE_POLY_MONO = 63;
+    static constexpr std::uint8_t SYSEX_VOICE_PITCHBEND_RANGE = 64;
+    static constexpr std::uint8_t SYSEX_VOICE_PORTAMENTO_MODE = 65;
+    static constexpr std::uint8_t SYSEX_VOICE_PORTAMENTO_TIME = 66;
+    static constexpr std::uint8_t SYSEX_VOICE_FOOT_CONTROLLER_VOLUME = 67;
+    static constexpr std::uint8_t SYSEX_VOICE_SUSTAIN = 68;
+    static constexpr std::uint8_t SYSEX_VOICE_PORTAMENTO = 69;
+    static constexpr std::uint8_t SYSEX_VOICE_CHORUS = 70;
+    static constexpr std::uint8_t SYSEX_VOICE_MODULATION_WHEEL_PITCH = 71;
+    static constexpr std::uint8_t SYSEX_VOICE_MODULATION_WHEEL_AMPLITUDE = 72;
+    static constexpr std::uint8_t SYSEX_VOICE_BREATH_CONTROLLER_PITCH = 73;
+    static constexpr std::uint8_t SYSEX_VOICE_BREATH_CONTROLLER_AMPLITUDE = 74;
+    static constexpr std::uint8_t SYSEX_VOICE_BREATH_CONTROLLER_PITCH_BIAS = 75;
+    static constexpr std::uint8_t SYSEX_VOICE_BREATH_CONTROLLER_ENVELOPE_GENERATOR_BIAS = 76;
+    static constexpr std::uint8_t SYSEX_VOICE_VOICE_NAME_1 = 77;
+    static constexpr std::uint8_t SYSEX_VOICE_PITCH_ENVELOPE_RATE_1 = 87;
+    static constexpr std::uint8_t SYSEX_VOICE_PITCH_ENVELOPE_LEVEL_1 = 90;
+
+    static constexpr std::uint8_t SYSEX_VMEM_BANK = 0x04;
+    static constexpr std::uint8_t SYSEX_VMEM_LENGTH_HIGH = 0x20;
+    static constexpr std::uint8_t SYSEX_VMEM_LENGTH_LOW = 0x00;
+    static constexpr std::size_t SYSEX_VMEM_VOICE_SIZE = 128;
+    static constexpr std::size_t SYSEX_VMEM_SIZE = 32 * SYSEX_VMEM_VOICE_SIZE;
+
+    // operators are stored in the order OP4, OP2, OP3, OP1 in every voice format
+    static constexpr std::array<std::size_t, 4> SYSEX_OP_ORDER = { 3, 1, 2, 0 };
+
+    // VCED parameters followed by ACED parameters, as unpacked bytes
+    static constexpr std::size_t SYSEX_VOICE_PARAMETERS_SIZE = SYSEX_VCED_SIZE + SYSEX_ACED_SIZE;
+
+    struct vmem_field {
+        std::uint8_t parameter;
+        std::uint8_t byte;
+        std::uint8_t shift;
+        std::uint8_t mask;
+    };
+
+    constexpr std::array<vmem_field, SYSEX_VOICE_PARAMETERS_SIZE> make_vmem_fields()
+    {
+        std::array<vmem_field, SYSEX_VOICE_PARAMETERS_SIZE> _fields {};
+        std::size_t _index = 0;
+        const auto _add = [&](const std::size_t parameter, const std::size_t byte, const std::uint8_t shift, const std::uint8_t mask) {
+            _fields[_index++] = vmem_field { static_cast<std::uint8_t>(parameter), static_cast<std::uint8_t>(byte), shift, mask };
+        };
+        for (std::size_t _op_slot = 0; _op_slot < 4; ++_op_slot) {
+            const std::size_t _vced = _op_slot * SYSEX_VOICE_OP_BLOCK_STRIDE;
+            const std::size_t _aced = SYSEX_VCED_SIZE + _op_slot * SYSEX_ACED_OP_BLOCK_STRIDE;
+            const std::size_t _vmem = _op_slot * 10;
+            _add(_vced + SYSEX_VOICE_OP_ATTACK_RATE, _vmem + 0, 0, 0x1F);
+            _add(_vced + SYSEX_VOICE_OP_DECAY_RATE_1, _vmem + 1, 0, 0x1F);
+            _add(_vced + SYSEX_VOICE_OP_DECAY_RATE_2, _vmem + 2, 0, 0x1F);
+            _add(_vced + SYSEX_VOICE_OP_RELEASE_RATE, _vmem + 3, 0, 0x0F);
+            _add(_vced + SYSEX_VOICE_OP_DECAY_LEVEL_1, _vmem + 4, 0, 0x0F);
+            _add(_vced + SYSEX_VOICE_OP_LEVEL_SCALING, _vmem + 5, 0, 0x7F);
+            _add(_vced + SYSEX_VOICE_OP_AMPLITUDE_MODULATION_ENABLE, _vmem + 6, 6, 0x01);
+            _add(_vced + SYSEX_VOICE_OP_ENVELOPE_GENERATOR_BIAS_SENSITIVITY, _vmem + 6, 3, 0x07);
+            _add(_vced + SYSEX_VOICE_OP_KEY_VELOCITY_SENSITIVITY, _vmem + 6, 0, 0x07);
+            _add(_vced + SYSEX_VOICE_OP_OUTPUT_LEVEL, _vmem + 7, 0, 0x7F);
+            _add(_vced + SYSEX_VOICE_OP_FREQUENCY, _vmem + 8, 0, 0x3F);
+            _add(_vced + SYSEX_VOICE_OP_RATE_SCALING, _vmem + 9, 3, 0x03);
+            _add(_vced + SYSEX_VOICE_OP_DETUNE, _vmem + 9, 0, 0x07);
+            _add(_aced + SYSEX_ACED_OP_ENVELOPE_GENERATOR_SHIFT, 73 + _op_slot * 2, 4, 0x03);
+            _add(_aced + SYSEX_ACED_OP_FIXED_FREQUENCY, 73 + _op_slot * 2, 3, 0x01);
+            _add(_aced + SYSEX_ACED_OP_FIXED_FREQUENCY_RANGE, 73 + _op_slot * 2, 0, 0x07);
+            _add(_aced + SYSEX_ACED_OP_WAVEFORM, 74 + _op_slot * 2, 4, 0x07);
+            _add(_aced + SYSEX_ACED_OP_FREQUENCY_RANGE_FINE, 74 + _op_slot * 2, 0, 0x0F);
+        }
+        _add(SYSEX_VOICE_LFO_SYNC, 40, 6, 0x01);
+        _add(SYSEX_VOICE_ALGORITHM_FEEDBACK, 40, 3, 0x07);
+        _add(SYSEX_VOICE_ALGORITHM_MODE, 40, 0, 0x07);
+        _add(SYSEX_VOICE_LFO_SPEED, 41, 0, 0x7F);
+        _add(SYSEX_VOICE_LFO_DELAY, 42, 0, 0x7F);
+        _add(SYSEX_VOICE_PITCH_MODULATION_DEPTH, 43, 0, 0x7F);
+        _add(SYSEX_VOICE_AMPLITUDE_MODULATION_DEPTH, 44, 0, 0x7F);
+        _add(SYSEX_VOICE_PITCH_MODULATION_SENSITIVITY, 45, 4, 0x07);
+        _add(SYSEX_VOICE_AMPLITUDE_MODULATION_SENSITIVITY, 45, 2, 0x03);
+        _add(SYSEX_VOICE_LFO_WAVE, 45, 0, 0x03);
+        _add(SYSEX_VOICE_TRANSPOSE, 46, 0, 0x7F);
+        _add(SYSEX_VOICE_PITCHBEND_RANGE, 47, 0, 0x0F);
+        _add(SYSEX_VOICE_CHORUS, 48, 4, 0x01);
+        _add(SYSEX_VOICE_POLY_MONO, 48, 3, 0x01);
+        _add(SYSEX_VOICE_SUSTAIN, 48, 2, 0x01);
+        _add(SYSEX_VOICE_PORTAMENTO, 48, 1, 0x01);
+        _add(SYSEX_VOICE_PORTAMENTO_MODE, 48, 0, 0x01);
+        _add(SYSEX_VOICE_PORTAMENTO_TIME, 49, 0, 0x7F);
+        _add(SYSEX_VOICE_FOOT_CONTROLLER_VOLUME, 50, 0, 0x7F);
+        _add(SYSEX_VOICE_MODULATION_WHEEL_PITCH, 51, 0, 0x7F);
+        _add(SYSEX_VOICE_MODULATION_WHEEL_AMPLITUDE, 52, 0, 0x7F);
+        _add(SYSEX_VOICE_BREATH_CONTROLLER_PITCH, 53, 0, 0x7F);
+        _add(SYSEX_VOICE_BREATH_CONTROLLER_AMPLITUDE, 54, 0, 0x7F);
+        _add(SYSEX_VOICE_BREATH_CONTROLLER_PITCH_BIAS, 55, 0, 0x7F);
+        _add(SYSEX_VOICE_BREATH_CONTROLLER_ENVELOPE_GENERATOR_BIAS, 56, 0, 0x7F);
+        for (std::size_t _char_index = 0; _char_index < 10; ++_char_index) {
+            _add(SYSEX_VOICE_VOICE_NAME_1 + _char_index, 57 + _char_index, 0, 0x7F);
+        }
+        for (std::size_t _pitch_index = 0; _pitch_index < 6; ++_pitch_index) {
+            _add(SYSEX_VOICE_PITCH_ENVELOPE_RATE_1 + _pitch_index, 67 + _pitch_index, 0, 0x7F);
+        }
+        _add(SYSEX_VCED_SIZE + SYSEX_ACED_REVERB_RATE, 81, 0, 0x07);
+        _add(SYSEX_VCED_SIZE + SYSEX_ACED_FOOT_CONTROLLER_PITCH, 82, 0, 0x7F);
+        _add(SYSEX_VCED_SIZE + SYSEX_ACED_FOOT_CONTROLLER_AMPLITUDE, 83, 0, 0x7F);
+        return _fields;
+    }
+
+    // every unpacked parameter maps to a bit field of the 128 byte VMEM voice
+    static constexpr std::array<vmem_field, SYSEX_VOICE_PARAMETERS_SIZE> SYSEX_VMEM_FIELDS = make_vmem_fields();
 
     static std::uint8_t compute_sysex_checksum(const std::uint8_t* data, const std::size_t length)
     {
@@ -179,118 +311,477 @@ namespace {
         return (128 - (_sum & 0x7F)) & 0x7F;
     }
 
+    /// checks a parameter against the range of its field before assigning it, out of range bytes are reported instead of thrown or clamped
+    template <typename T, T MinValue, T MaxValue, T DefaultValue>
+    static bool decode_parameter(const std::uint8_t parameter, integral<T, MinValue, MaxValue, DefaultValue>& field)
+    {
+        if (parameter < MinValue || parameter > MaxValue) {
+            return false;
+        }
+        field = parameter;
+        return true;
+    }
+
     static void sysex_open(std::vector<std::uint8_t>& encoded, const std::uint8_t device, const std::uint8_t function, const std::uint16_t size)
     {
         encoded.push_back(SYSEX_START);
         encoded.push_back(SYSEX_YAMAHA);
-        encoded.push_back(0x10 | (device & 0x0F));
+        encoded.push_back(0x00 | (device & 0x0F));
         encoded.push_back(function);
-        encoded.push_back(static_cast<std::uint8_t>((size >> 8) & 0x7F));
+        encoded.push_back(static_cast<std::uint8_t>((size >> 7) & 0x7F));
         encoded.push_back(static_cast<std::uint8_t>((size) & 0x7F));
     }
 
-    static void sysex_close(std::vector<uint8_t>& encoded, const std::size_t data_start_index)
+    static void sysex_request(std::vector<std::uint8_t>& encoded, const std::uint8_t device, const std::uint8_t format)
     {
-        const std::uint8_t* _data_ptr = encoded.data() + data_start_index;
-        const std::size_t _data_size = encoded.size() - data_start_index;
-        encoded.push_back(compute_sysex_checksum(_data_ptr, _data_size));
+        encoded.push_back(SYSEX_START);
+        encoded.push_back(SYSEX_YAMAHA);
+        encoded.push_back(0x20 | (device & 0x0F));
+        encoded.push_back(format);
         encoded.push_back(SYSEX_END);
     }
-}
 
-void yamaha_tx81z::encode_voice_patch(
-    std::vector<std::uint8_t>& encoded,
-    const integral<std::uint8_t, 0, 15>& device,
-    const voice_patch& data)
-{
+    static void sysex_request(std::vector<std::uint8_t>& encoded, const std::uint8_t device, const std::array<std::uint8_t, 10>& header)
+    {
+        encoded.push_back(SYSEX_START);
+        encoded.push_back(SYSEX_YAMAHA);
+        encoded.push_back(0x20 | (device & 0x0F));
+        encoded.push_back(SYSEX_ACED_SINGLE);
+        encoded.insert(encoded.end(), header.begin(), header.end());
+        encoded.push_back(SYSEX_END);
+    }
+
+    /// checks the header, byte count and checksum of a bulk dump frame spanning size + 8 bytes
+    static decode_result sysex_check(const std::uint8_t* frame, const std::size_t available, const std::uint8_t format, const std::size_t size)
+    {
+        if (available < size + 8) {
+            return decode_error::size;
+        }
+        if (frame[0] != SYSEX_START || frame[1] != SYSEX_YAMAHA || (frame[2] & 0x70) != 0x00 || frame[3] != format) {
+            return decode_error::header;
+        }
+        if (frame[4] != ((size >> 7) & 0x7F) || frame[5] != (size & 0x7F) || frame[size + 7] != SYSEX_END) {
+            return decode_error::header;
+        }
+        if (compute_sysex_checksum(frame + 6, size) != (frame[size + 6] & 0x7F)) {
+            return decode_error::checksum;
+        }
+        return decode_error::none;
+    }
+
+    /// matches a dump frame by its format byte, for the VCED and VMEM formats
+    static dump_pipeline::matcher match_dump(const std::uint8_t device, const std::uint8_t format)
+    {
+        return dump_pipeline::match_prefix({ SYSEX_START, SYSEX_YAMAHA, static_cast<std::uint8_t>(device & 0x0F), format });
+    }
+
+    /// matches a dump frame in the ACED format by its header, whatever its byte count
+    static dump_pipeline::matcher match_dump(const std::uint8_t device, const std::array<std::uint8_t, 10>& header)
     {
-        // VCED
-        std::array<std::uint8_t, SYSEX_VCED_SIZE> _vced;
-        std::uint8_t* _voice_ptr = _vced.data();
-
-        for (std::size_t _op_index = 3; _op_index >= 0; --_op_index) {
-            std::uint8_t* _op_ptr = _vced.data() + 12 * _op_index;
-
-            _op_ptr[SYSEX_VCED_OP_ATTACK_RATE] = data.op_attack_rate[_op_index].value();
-            _op_ptr[SYSEX_VCED_OP_DECAY_RATE_1] = data.op_decay_rate_1[_op_index].value();
-            _op_ptr[SYSEX_VCED_OP_DECAY_RATE_2] = data.op_decay_rate_2[_op_index].value();
-            _op_ptr[SYSEX_VCED_OP_RELEASE_RATE] = data.op_release_rate[_op_index].value();
-            _op_ptr[SYSEX_VCED_OP_DECAY_LEVEL_1] = data.op_decay_level_1[_op_index].value();
-            _op_ptr[SYSEX_VCED_OP_LEVEL_SCALING] = data.op_level_scaling[_op_index].value();
-            _op_ptr[SYSEX_VCED_OP_RATE_SCALING] = data.op_rate_scaling[_op_index].value();
-            _op_ptr[SYSEX_VCED_OP_ENVELOPE_GENERATOR_BIAS_SENSITIVITY] = data.op_envelope_generator_bias_sensitivity[_op_index].value();
-            _op_ptr[SYSEX_VCED_OP_AMPLITUDE_MODULATION_ENABLE] = data.op_amplitude_modulation_enable[_op_index].value();
-            _op_ptr[SYSEX_VCED_OP_KEY_VELOCITY_SENSITIVITY] = data.op_key_velocity_sensitivity[_op_index].value();
-            _op_ptr[SYSEX_VCED_OP_OUTPUT_LEVEL] = data.op_output_level[_op_index].value();
-            _op_ptr[SYSEX_VCED_OP_FREQUENCY] = data.op_frequency[_op_index].value();
-            _op_ptr[SYSEX_VCED_OP_DETUNE] = data.op_detune[_op_index].value();
-        }
-
-        encoded.push_back(data.algorithm_mode.value());
-        encoded.push_back(data.algorithm_feedback.value());
-        encoded.push_back(data.lfo_speed.value());
-        encoded.push_back(data.lfo_delay.value());
-        encoded.push_back(data.pitch_modulation_depth.value());
-        encoded.push_back(data.amplitude_modulation_depth.value());
-        encoded.push_back(data.lfo_sync.value());
-        encoded.push_back(data.lfo_wave.value());
-        encoded.push_back(data.pitch_modulation_sensitivity.value());
-        encoded.push_back(data.amplitude_modulation_sensitivity.value());
-        encoded.push_back(data.transpose.value());
-        encoded.push_back(data.poly_mono.value());
-        encoded.push_back(data.pitchbend_range.value());
-        encoded.push_back(data.portamento_mode.value());
-        encoded.push_back(data.portamento_time.value());
-        encoded.push_back(data.foot_controller_volume.value());
-        encoded.push_back(data.sustain.value());
-        encoded.push_back(data.portamento.value());
-        encoded.push_back(data.chorus.value());
-        encoded.push_back(data.modulation_wheel_pitch.value());
-        encoded.push_back(data.modulation_wheel_amplitude.value());
-        encoded.push_back(data.breath_controller_pitch.value());
-        encoded.push_back(data.breath_controller_amplitude.value());
-        encoded.push_back(data.breath_controller_pitch_bias.value());
-        encoded.push_back(data.breath_controller_envelope_generator_bias.value());
+        std::vector<std::uint8_t> _prefix = { SYSEX_START, SYSEX_YAMAHA, static_cast<std::uint8_t>(device & 0x0F), SYSEX_ACED_SINGLE, 0x00, 0x00 };
+        _prefix.insert(_prefix.end(), header.begin(), header.end());
+        return dump_pipeline::match_prefix(std::move(_prefix), { 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00 });
+    }
+
+    /// keeps a dump frame that has no decoder yet, once its byte count and checksum are checked
+    static decode_result keep_frame(const std::vector<std::uint8_t>& encoded, std::vector<std::uint8_t>& frame)
+    {
+        if (encoded.size() < 8) {
+            return decode_error::size;
+        }
+        const std::size_t _size = (static_cast<std::size_t>(encoded[4] & 0x7F) << 7) | (encoded[5] & 0x7F);
+        if (encoded.size() != _size + 8) {
+            return decode_error::size;
+        }
+        const decode_result _checked = sysex_check(encoded.data(), encoded.size(), SYSEX_ACED_SINGLE, _size);
+        if (!_checked) {
+            return _checked;
+        }
+        frame = encoded;
+        return decode_error::none;
+    }
+
+    static void sysex_parameter(std::vector<std::uint8_t>& encoded, const std::uint8_t device, const std::uint8_t group, const std::uint8_t parameter, const std::uint8_t value)
+    {
+        encoded.push_back(SYSEX_START);
+        encoded.push_back(SYSEX_YAMAHA);
+        encoded.push_back(0x10 | (device & 0x0F));
+        encoded.push_back(group);
+        encoded.push_back(parameter & 0x7F);
+        encoded.push_back(value & 0x7F);
+        encoded.push_back(SYSEX_END);
+    }
+
+    static void sysex_append(std::vector<std::uint8_t>& encoded, const std::uint8_t* data, const std::size_t size, std::uint32_t& sum)
+    {
+        for (std::size_t _index = 0; _index < size; ++_index) {
+            encoded.push_back(data[_index]);
+            sum += data[_index];
+        }
+    }
+
+    static void sysex_close(std::vector<uint8_t>& encoded, const std::uint32_t sum)
+    {
+        encoded.push_back((128 - (sum & 0x7F)) & 0x7F);
+        encoded.push_back(SYSEX_END);
+    }
+
+    static void encode_voice_parameters(const yamaha_tx81z::voice_patch& data, std::uint8_t* parameters)
+    {
+        std::uint8_t* _aced_ptr = parameters + SYSEX_VCED_SIZE;
+        for (std::size_t _op_slot = 0; _op_slot < 4; ++_op_slot) {
+            const std::size_t _op_index = SYSEX_OP_ORDER[_op_slot];
+            std::uint8_t* _op_ptr = parameters + _op_slot * SYSEX_VOICE_OP_BLOCK_STRIDE;
+            std::uint8_t* _aced_op_ptr = _aced_ptr + _op_slot * SYSEX_ACED_OP_BLOCK_STRIDE;
+
+            _op_ptr[SYSEX_VOICE_OP_ATTACK_RATE] = data.op_attack_rate[_op_index].value();
+            _op_ptr[SYSEX_VOICE_OP_DECAY_RATE_1] = data.op_decay_rate_1[_op_index].value();
+            _op_ptr[SYSEX_VOICE_OP_DECAY_RATE_2] = data.op_decay_rate_2[_op_index].value();
+            _op_ptr[SYSEX_VOICE_OP_RELEASE_RATE] = data.op_release_rate[_op_index].value();
+            _op_ptr[SYSEX_VOICE_OP_DECAY_LEVEL_1] = data.op_decay_level_1[_op_index].value();
+            _op_ptr[SYSEX_VOICE_OP_LEVEL_SCALING] = data.op_level_scaling[_op_index].value();
+            _op_ptr[SYSEX_VOICE_OP_RATE_SCALING] = data.op_rate_scaling[_op_index].value();
+            _op_ptr[SYSEX_VOICE_OP_ENVELOPE_GENERATOR_BIAS_SENSITIVITY] = data.op_envelope_generator_bias_sensitivity[_op_index].value();
+            _op_ptr[SYSEX_VOICE_OP_AMPLITUDE_MODULATION_ENABLE] = data.op_amplitude_modulation_enable[_op_index].value();
+            _op_ptr[SYSEX_VOICE_OP_KEY_VELOCITY_SENSITIVITY] = data.op_key_velocity_sensitivity[_op_index].value();
+            _op_ptr[SYSEX_VOICE_OP_OUTPUT_LEVEL] = data.op_output_level[_op_index].value();
+            _op_ptr[SYSEX_VOICE_OP_FREQUENCY] = data.op_frequency[_op_index].value();
+            _op_ptr[SYSEX_VOICE_OP_DETUNE] = data.op_detune[_op_index].value();
+
+            _aced_op_ptr[SYSEX_ACED_OP_FIXED_FREQUENCY] = data.op_fixed_frequency[_op_index].value();
+            _aced_op_ptr[SYSEX_ACED_OP_FIXED_FREQUENCY_RANGE] = data.op_fixed_frequency_range[_op_index].value();
+            _aced_op_ptr[SYSEX_ACED_OP_FREQUENCY_RANGE_FINE] = data.op_frequency_range_fine[_op_index].value();
+            _aced_op_ptr[SYSEX_ACED_OP_WAVEFORM] = data.op_waveform[_op_index].value();
+            _aced_op_ptr[SYSEX_ACED_OP_ENVELOPE_GENERATOR_SHIFT] = data.op_envelope_generator_shift[_op_index].value();
+        }
+
+        parameters[SYSEX_VOICE_ALGORITHM_MODE] = data.algorithm_mode.value();
+        parameters[SYSEX_VOICE_ALGORITHM_FEEDBACK] = data.algorithm_feedback.value();
+        parameters[SYSEX_VOICE_LFO_SPEED] = data.lfo_speed.value();
+        parameters[SYSEX_VOICE_LFO_DELAY] = data.lfo_delay.value();
+        parameters[SYSEX_VOICE_PITCH_MODULATION_DEPTH] = data.pitch_modulation_depth.value();
+        parameters[SYSEX_VOICE_AMPLITUDE_MODULATION_DEPTH] = data.amplitude_modulation_depth.value();
+        parameters[SYSEX_VOICE_LFO_SYNC] = data.lfo_sync.value();
+        parameters[SYSEX_VOICE_LFO_WAVE] = data.lfo_wave.value();
+        parameters[SYSEX_VOICE_PITCH_MODULATION_SENSITIVITY] = data.pitch_modulation_sensitivity.value();
+        parameters[SYSEX_VOICE_AMPLITUDE_MODULATION_SENSITIVITY] = data.amplitude_modulation_sensitivity.value();
+        parameters[SYSEX_VOICE_TRANSPOSE] = data.transpose.value();
+        parameters[SYSEX_VOICE_POLY_MONO] = data.poly_mono.value();
+        parameters[SYSEX_VOICE_PITCHBEND_RANGE] = data.pitchbend_range.value();
+        parameters[SYSEX_VOICE_PORTAMENTO_MODE] = data.portamento_mode.value();
+        parameters[SYSEX_VOICE_PORTAMENTO_TIME] = data.portamento_time.value();
+        parameters[SYSEX_VOICE_FOOT_CONTROLLER_VOLUME] = data.foot_controller_volume.value();
+        parameters[SYSEX_VOICE_SUSTAIN] = data.sustain.value();
+        parameters[SYSEX_VOICE_PORTAMENTO] = data.portamento.value();
+        parameters[SYSEX_VOICE_CHORUS] = data.chorus.value();
+        parameters[SYSEX_VOICE_MODULATION_WHEEL_PITCH] = data.modulation_wheel_pitch.value();
+        parameters[SYSEX_VOICE_MODULATION_WHEEL_AMPLITUDE] = data.modulation_wheel_amplitude.value();
+        parameters[SYSEX_VOICE_BREATH_CONTROLLER_PITCH] = data.breath_controller_pitch.value();
+        parameters[SYSEX_VOICE_BREATH_CONTROLLER_AMPLITUDE] = data.breath_controller_amplitude.value();
+        parameters[SYSEX_VOICE_BREATH_CONTROLLER_PITCH_BIAS] = data.breath_controller_pitch_bias.value();
+        parameters[SYSEX_VOICE_BREATH_CONTROLLER_ENVELOPE_GENERATOR_BIAS] = data.breath_controller_envelope_generator_bias.value();
         for (std::size_t _char_index = 0; _char_index < 10; ++_char_index) {
-            encoded.push_back(static_cast<uint8_t>(data.voice_name[_char_index]));
+            parameters[SYSEX_VOICE_VOICE_NAME_1 + _char_index] = static_cast<std::uint8_t>(data.voice_name[_char_index]) & 0x7F;
         }
-        for (std::size_t _empty_index = 0; _empty_index < 6; ++_empty_index) {
-            encoded.push_back(0x00);
+
+        // the pitch envelope is not used by the TX81Z and is kept neutral for DX21 compatibility
+        for (std::size_t _pitch_index = 0; _pitch_index < 3; ++_pitch_index) {
+            parameters[SYSEX_VOICE_PITCH_ENVELOPE_RATE_1 + _pitch_index] = 99;
+            parameters[SYSEX_VOICE_PITCH_ENVELOPE_LEVEL_1 + _pitch_index] = 50;
         }
 
-        const std::size_t _data_start = encoded.size();
-        encoded.insert(encoded.end(), _vced.begin(), _vced.end());
-        sysex_close(encoded, _data_start);
+        _aced_ptr[SYSEX_ACED_REVERB_RATE] = data.reverb_rate.value();
+        _aced_ptr[SYSEX_ACED_FOOT_CONTROLLER_PITCH] = data.foot_controller_pitch.value();
+        _aced_ptr[SYSEX_ACED_FOOT_CONTROLLER_AMPLITUDE] = data.foot_controller_amplitude.value();
     }
 
+    static decode_result decode_voice_parameters(const std::uint8_t* parameters, yamaha_tx81z::voice_patch& data)
     {
-        // ACED
-        sysex_open(encoded, static_cast<std::uint8_t>(device), 0x7E, 0x0021);
-        const size_t data_start = encoded.size();
+        // ranges are checked before assigning so that a corrupted voice leaves data unchanged
+        yamaha_tx81z::voice_patch _decoded = data;
+        bool _in_range = true;
+        const std::uint8_t* _aced_ptr = parameters + SYSEX_VCED_SIZE;
+        for (std::size_t _op_slot = 0; _op_slot < 4; ++_op_slot) {
+            const std::size_t _op_index = SYSEX_OP_ORDER[_op_slot];
+            const std::uint8_t* _op_ptr = parameters + _op_slot * SYSEX_VOICE_OP_BLOCK_STRIDE;
+            const std::uint8_t* _aced_op_ptr = _aced_ptr + _op_slot * SYSEX_ACED_OP_BLOCK_STRIDE;
+
+            _in_range &= decode_parameter(_op_ptr[SYSEX_VOICE_OP_ATTACK_RATE], _decoded.op_attack_rate[_op_index]);
+            _in_range &= decode_parameter(_op_ptr[SYSEX_VOICE_OP_DECAY_RATE_1], _decoded.op_decay_rate_1[_op_index]);
+            _in_range &= decode_parameter(_op_ptr[SYSEX_VOICE_OP_DECAY_RATE_2], _decoded.op_decay_rate_2[_op_index]);
+            _in_range &= decode_parameter(_op_ptr[SYSEX_VOICE_OP_RELEASE_RATE], _decoded.op_release_rate[_op_index]);
+            _in_range &= decode_parameter(_op_ptr[SYSEX_VOICE_OP_DECAY_LEVEL_1], _decoded.op_decay_level_1[_op_index]);
+            _in_range &= decode_parameter(_op_ptr[SYSEX_VOICE_OP_LEVEL_SCALING], _decoded.op_level_scaling[_op_index]);
+            _in_range &= decode_parameter(_op_ptr[SYSEX_VOICE_OP_RATE_SCALING], _decoded.op_rate_scaling[_op_index]);
+            _in_range &= decode_parameter(_op_ptr[SYSEX_VOICE_OP_ENVELOPE_GENERATOR_BIAS_SENSITIVITY], _decoded.op_envelope_generator_bias_sensitivity[_op_index]);
+            _in_range &= decode_parameter(_op_ptr[SYSEX_VOICE_OP_AMPLITUDE_MODULATION_ENABLE], _decoded.op_amplitude_modulation_enable[_op_index]);
+            _in_range &= decode_parameter(_op_ptr[SYSEX_VOICE_OP_KEY_VELOCITY_SENSITIVITY], _decoded.op_key_velocity_sensitivity[_op_index]);
+            _in_range &= decode_parameter(_op_ptr[SYSEX_VOICE_OP_OUTPUT_LEVEL], _decoded.op_output_level[_op_index]);
+            _in_range &= decode_parameter(_op_ptr[SYSEX_VOICE_OP_FREQUENCY], _decoded.op_frequency[_op_index]);
+            _in_range &= decode_parameter(_op_ptr[SYSEX_VOICE_OP_DETUNE], _decoded.op_detune[_op_index]);
+
+            _in_range &= decode_parameter(_aced_op_ptr[SYSEX_ACED_OP_FIXED_FREQUENCY], _decoded.op_fixed_frequency[_op_index]);
+            _in_range &= decode_parameter(_aced_op_ptr[SYSEX_ACED_OP_FIXED_FREQUENCY_RANGE], _decoded.op_fixed_frequency_range[_op_index]);
+            _in_range &= decode_parameter(_aced_op_ptr[SYSEX_ACED_OP_FREQUENCY_RANGE_FINE], _decoded.op_frequency_range_fine[_op_index]);
+            _in_range &= decode_parameter(_aced_op_ptr[SYSEX_ACED_OP_WAVEFORM], _decoded.op_waveform[_op_index]);
+            _in_range &= decode_parameter(_aced_op_ptr[SYSEX_ACED_OP_ENVELOPE_GENERATOR_SHIFT], _decoded.op_envelope_generator_shift[_op_index]);
+        }
 
-        encoded.insert(encoded.end(), { 'L', 'M', ' ', ' ', '8', '9', '7', '6', 'A', 'E' });
+        _in_range &= decode_parameter(parameters[SYSEX_VOICE_ALGORITHM_MODE], _decoded.algorithm_mode);
+        _in_range &= decode_parameter(parameters[SYSEX_VOICE_ALGORITHM_FEEDBACK], _decoded.algorithm_feedback);
+        _in_range &= decode_parameter(parameters[SYSEX_VOICE_LFO_SPEED], _decoded.lfo_speed);
+        _in_range &= decode_parameter(parameters[SYSEX_VOICE_LFO_DELAY], _decoded.lfo_delay);
+        _in_range &= decode_parameter(parameters[SYSEX_VOICE_PITCH_MODULATION_DEPTH], _decoded.pitch_modulation_depth);
+        _in_range &= decode_parameter(parameters[SYSEX_VOICE_AMPLITUDE_MODULATION_DEPTH], _decoded.amplitude_modulation_depth);
+        _in_range &= decode_parameter(parameters[SYSEX_VOICE_LFO_SYNC], _decoded.lfo_sync);
+        _in_range &= decode_parameter(parameters[SYSEX_VOICE_LFO_WAVE], _decoded.lfo_wave);
+        _in_range &= decode_parameter(parameters[SYSEX_VOICE_PITCH_MODULATION_SENSITIVITY], _decoded.pitch_modulation_sensitivity);
+        _in_range &= decode_parameter(parameters[SYSEX_VOICE_AMPLITUDE_MODULATION_SENSITIVITY], _decoded.amplitude_modulation_sensitivity);
+        _in_range &= decode_parameter(parameters[SYSEX_VOICE_TRANSPOSE], _decoded.transpose);
+        _in_range &= decode_parameter(parameters[SYSEX_VOICE_POLY_MONO], _decoded.poly_mono);
+        _in_range &= decode_parameter(parameters[SYSEX_VOICE_PITCHBEND_RANGE], _decoded.pitchbend_range);
+        _in_range &= decode_parameter(parameters[SYSEX_VOICE_PORTAMENTO_MODE], _decoded.portamento_mode);
+        _in_range &= decode_parameter(parameters[SYSEX_VOICE_PORTAMENTO_TIME], _decoded.portamento_time);
+        _in_range &= decode_parameter(parameters[SYSEX_VOICE_FOOT_CONTROLLER_VOLUME], _decoded.foot_controller_volume);
+        _in_range &= decode_parameter(parameters[SYSEX_VOICE_SUSTAIN], _decoded.sustain);
+        _in_range &= decode_parameter(parameters[SYSEX_VOICE_PORTAMENTO], _decoded.portamento);
+        _in_range &= decode_parameter(parameters[SYSEX_VOICE_CHORUS], _decoded.chorus);
+        _in_range &= decode_parameter(parameters[SYSEX_VOICE_MODULATION_WHEEL_PITCH], _decoded.modulation_wheel_pitch);
+        _in_range &= decode_parameter(parameters[SYSEX_VOICE_MODULATION_WHEEL_AMPLITUDE], _decoded.modulation_wheel_amplitude);
+        _in_range &= decode_parameter(parameters[SYSEX_VOICE_BREATH_CONTROLLER_PITCH], _decoded.breath_controller_pitch);
+        _in_range &= decode_parameter(parameters[SYSEX_VOICE_BREATH_CONTROLLER_AMPLITUDE], _decoded.breath_controller_amplitude);
+        _in_range &= decode_parameter(parameters[SYSEX_VOICE_BREATH_CONTROLLER_PITCH_BIAS], _decoded.breath_controller_pitch_bias);
+        _in_range &= decode_parameter(parameters[SYSEX_VOICE_BREATH_CONTROLLER_ENVELOPE_GENERATOR_BIAS], _decoded.breath_controller_envelope_generator_bias);
+        for (std::size_t _char_index = 0; _char_index < 10; ++_char_index) {
+            _decoded.voice_name[_char_index] = static_cast<char>(parameters[SYSEX_VOICE_VOICE_NAME_1 + _char_index]);
+        }
 
-        // for (std::size_t _op_index = 3; _op_index >= 0; --_op_index) {
-        //     encoded.push_back(data.op_fixed_frequency[_op_index]);
-        //     encoded.push_back(data.op_fixed_frequency_range[_op_index]);
-        //     encoded.push_back(data.op_frequency_range_fine[_op_index]);
-        //     encoded.push_back(data.op_waveform[_op_index]);
-        //     encoded.push_back(data.op_envelope_generator_shift[_op_index]);
-        // }
+        _in_range &= decode_parameter(_aced_ptr[SYSEX_ACED_REVERB_RATE], _decoded.reverb_rate);
+        _in_range &= decode_parameter(_aced_ptr[SYSEX_ACED_FOOT_CONTROLLER_PITCH], _decoded.foot_controller_pitch);
+        _in_range &= decode_parameter(_aced_ptr[SYSEX_ACED_FOOT_CONTROLLER_AMPLITUDE], _decoded.foot_controller_amplitude);
+        if (!_in_range) {
+            return decode_error::range;
+        }
+        data = _decoded;
+        return decode_error::none;
+    }
 
-        // encoded.push_back(data.reverb_rate);
-        // encoded.push_back(data.foot_controller_pitch);
-        // encoded.push_back(data.foot_controller_amplitude);
+    /// microtune tables are a header followed by a note and fine byte pair for each key
+    static void encode_microtune_keys(
+        std::vector<std::uint8_t>& encoded,
+        const std::uint8_t device,
+        const std::array<std::uint8_t, 10>& header,
+        const integral<std::uint8_t, 13, 108>* note,
+        const integral<std::uint8_t, 0, 63>* fine,
+        const std::size_t keys)
+    {
+        encoded.reserve(encoded.size() + 6 + header.size() + keys * 2 + 2);
+        std::uint32_t _sum = 0;
+        sysex_open(encoded, device, SYSEX_ACED_SINGLE, static_cast<std::uint16_t>(header.size() + keys * 2));
+        sysex_append(encoded, header.data(), header.size(), _sum);
+        for (std::size_t _key = 0; _key < keys; ++_key) {
+            const std::uint8_t _pair[2] = { note[_key].value(), fine[_key].value() };
+            sysex_append(encoded, _pair, 2, _sum);
+        }
+        sysex_close(encoded, _sum);
+    }
 
-        sysex_close(encoded, data_start);
+    static decode_result decode_microtune_keys(
+        const std::vector<std::uint8_t>& encoded,
+        integral<std::uint8_t, 0, 15>& device,
+        const std::array<std::uint8_t, 10>& header,
+        integral<std::uint8_t, 13, 108>* note,
+        integral<std::uint8_t, 0, 63>* fine,
+        const std::size_t keys)
+    {
+        const std::size_t _size = header.size() + keys * 2;
+        const decode_result _checked = sysex_check(encoded.data(), encoded.size(), SYSEX_ACED_SINGLE, _size);
+        if (!_checked) {
+            return _checked;
+        }
+        if (encoded.size() != _size + 8) {
+            return decode_error::size;
+        }
+        if (!std::equal(header.begin(), header.end(), encoded.begin() + 6)) {
+            return decode_error::header;
+        }
+
+        // ranges are checked before assigning so that a corrupted table leaves data unchanged
+        const std::uint8_t* _keys_ptr = encoded.data() + 6 + header.size();
+        for (std::size_t _key = 0; _key < keys; ++_key) {
+            if (_keys_ptr[_key * 2] < SYSEX_MICROTUNE_NOTE_MIN || _keys_ptr[_key * 2] > SYSEX_MICROTUNE_NOTE_MAX || _keys_ptr[_key * 2 + 1] > 63) {
+                return decode_error::range;
+            }
+        }
+        for (std::size_t _key = 0; _key < keys; ++_key) {
+            note[_key] = _keys_ptr[_key * 2];
+            fine[_key] = _keys_ptr[_key * 2 + 1];
+        }
+        device = encoded[2] & 0x0F;
+        return decode_error::none;
+    }
+}
+
+void yamaha_tx81z::encode_voice_patch(
+    std::vector<std::uint8_t>& encoded,
+    const integral<std::uint8_t, 0, 15>& device,
+    const voice_patch& data)
+{
+    std::array<std::uint8_t, SYSEX_VOICE_PARAMETERS_SIZE> _parameters;
+    encode_voice_parameters(data, _parameters.data());
+    encoded.reserve(encoded.size() + (6 + SYSEX_ACED_HEADER.size() + SYSEX_ACED_SIZE + 2) + (6 + SYSEX_VCED_SIZE + 2));
+
+    // the hardware applies ACED parameters when the following VCED is received, so ACED goes first
+    std::uint32_t _aced_sum = 0;
+    sysex_open(encoded, device.value(), SYSEX_ACED_SINGLE, SYSEX_ACED_HEADER.size() + SYSEX_ACED_SIZE);
+    sysex_append(encoded, SYSEX_ACED_HEADER.data(), SYSEX_ACED_HEADER.size(), _aced_sum);
+    sysex_append(encoded, _parameters.data() + SYSEX_VCED_SIZE, SYSEX_ACED_SIZE, _aced_sum);
+    sysex_close(encoded, _aced_sum);
+
+    std::uint32_t _vced_sum = 0;
+    sysex_open(encoded, device.value(), SYSEX_VCED_SINGLE, SYSEX_VCED_SIZE);
+    sysex_append(encoded, _parameters.data(), SYSEX_VCED_SIZE, _vced_sum);
+    sysex_close(encoded, _vced_sum);
+}
+
+decode_result yamaha_tx81z::decode_voice_patch(
+    const std::vector<std::uint8_t>& encoded,
+    integral<std::uint8_t, 0, 15>& device,
+    voice_patch& data)
+{
+    std::array<std::uint8_t, SYSEX_VOICE_PARAMETERS_SIZE> _parameters;
+    encode_voice_parameters(data, _parameters.data());
+
+    const std::uint8_t* _frame_ptr = encoded.data();
+    std::size_t _available = encoded.size();
+    // the ACED frame is optional, a leading frame in the ACED format that fails its checks is reported rather than read as VCED
+    const decode_result _aced = sysex_check(_frame_ptr, _available, SYSEX_ACED_SINGLE, SYSEX_ACED_HEADER.size() + SYSEX_ACED_SIZE);
+    const bool _has_aced = _aced;
+    if (!_aced && _aced.error() != decode_error::header) {
+        return _aced;
+    }
+    if (_has_aced) {
+        if (!std::equal(SYSEX_ACED_HEADER.begin(), SYSEX_ACED_HEADER.end(), _frame_ptr + 6)) {
+            return decode_error::header;
+        }
+        const std::size_t _aced_size = SYSEX_ACED_HEADER.size() + SYSEX_ACED_SIZE + 8;
+        std::copy(_frame_ptr + 6 + SYSEX_ACED_HEADER.size(), _frame_ptr + 6 + SYSEX_ACED_HEADER.size() + SYSEX_ACED_SIZE, _parameters.begin() + SYSEX_VCED_SIZE);
+        _frame_ptr += _aced_size;
+        _available -= _aced_size;
+    }
+
+    const decode_result _vced = sysex_check(_frame_ptr, _available, SYSEX_VCED_SINGLE, SYSEX_VCED_SIZE);
+    if (!_vced) {
+        return _vced;
+    }
+    if (_available != SYSEX_VCED_SIZE + 8) {
+        return decode_error::size;
+    }
+    if (_has_aced && (encoded[2] & 0x0F) != (_frame_ptr[2] & 0x0F)) {
+        return decode_error::device;
+    }
+    std::copy(_frame_ptr + 6, _frame_ptr + 6 + SYSEX_VCED_SIZE, _parameters.begin());
+
+    const decode_result _decoded = decode_voice_parameters(_parameters.data(), data);
+    if (!_decoded) {
+        return _decoded;
+    }
+    device = _frame_ptr[2] & 0x0F;
+    return decode_error::none;
+}
+
+void yamaha_tx81z::encode_voice_patch_changes(
+    std::vector<std::uint8_t>& encoded,
+    const integral<std::uint8_t, 0, 15>& device,
+    const voice_patch& previous,
+    const voice_patch& data)
+{
+    std::array<std::uint8_t, SYSEX_VOICE_PARAMETERS_SIZE> _previous_parameters;
+    std::array<std::uint8_t, SYSEX_VOICE_PARAMETERS_SIZE> _parameters;
+    encode_voice_parameters(previous, _previous_parameters.data());
+    encode_voice_parameters(data, _parameters.data());
+
+    // VCED and ACED offsets are the parameter numbers of their groups
+    for (std::size_t _index = 0; _index < SYSEX_VOICE_PARAMETERS_SIZE; ++_index) {
+        if (_parameters[_index] == _previous_parameters[_index]) {
+            continue;
+        }
+        if (_index < SYSEX_VCED_SIZE) {
+            sysex_parameter(encoded, device.value(), SYSEX_VCED_PARAMETER, static_cast<std::uint8_t>(_index), _parameters[_index]);
+        } else {
+            sysex_parameter(encoded, device.value(), SYSEX_ACED_PARAMETER, static_cast<std::uint8_t>(_index - SYSEX_VCED_SIZE), _parameters[_index]);
+        }
     }
 }
 
 void yamaha_tx81z::encode_bank(
     std::vector<std::uint8_t>& encoded,
     const integral<std::uint8_t, 0, 15>& device,
-    const std::array<voice_patch, 128>& data)
+    const std::array<voice_patch, 32>& data)
+{
+    encoded.reserve(encoded.size() + 6 + SYSEX_VMEM_SIZE + 2);
+    sysex_open(encoded, device.value(), SYSEX_VMEM_BANK, (SYSEX_VMEM_LENGTH_HIGH << 7) | SYSEX_VMEM_LENGTH_LOW);
+    const std::size_t _data_start = encoded.size();
+    encoded.resize(_data_start + SYSEX_VMEM_SIZE, 0x00);
+
+    std::array<std::uint8_t, SYSEX_VOICE_PARAMETERS_SIZE> _parameters;
+    std::uint32_t _sum = 0;
+    for (std::size_t _voice_index = 0; _voice_index < 32; ++_voice_index) {
+        std::uint8_t* _voice_ptr = encoded.data() + _data_start + _voice_index * SYSEX_VMEM_VOICE_SIZE;
+        encode_voice_parameters(data[_voice_index], _parameters.data());
+        for (const vmem_field& _field : SYSEX_VMEM_FIELDS) {
+            _voice_ptr[_field.byte] |= (_parameters[_field.parameter] & _field.mask) << _field.shift;
+        }
+
+        // the checksum is accumulated while the packed voice is still in cache
+        for (std::size_t _byte_index = 0; _byte_index < SYSEX_VMEM_VOICE_SIZE; ++_byte_index) {
+            _sum += _voice_ptr[_byte_index];
+        }
+    }
+
+    encoded.push_back((128 - (_sum & 0x7F)) & 0x7F);
+    encoded.push_back(SYSEX_END);
+}
+
+decode_result yamaha_tx81z::decode_bank(
+    const std::vector<std::uint8_t>& encoded,
+    integral<std::uint8_t, 0, 15>& device,
+    std::array<voice_patch, 32>& data)
 {
+    if (encoded.size() != 6 + SYSEX_VMEM_SIZE + 2) {
+        return decode_error::size;
+    }
+    if (encoded[0] != SYSEX_START || encoded[1] != SYSEX_YAMAHA || encoded.back() != SYSEX_END) {
+        return decode_error::header;
+    }
+
+    const bool _vmem_byte_is_correct = (encoded[2] & 0x70) == 0x00;
+    if (!_vmem_byte_is_correct || encoded[3] != SYSEX_VMEM_BANK || encoded[4] != SYSEX_VMEM_LENGTH_HIGH || encoded[5] != SYSEX_VMEM_LENGTH_LOW) {
+        return decode_error::header;
+    }
+
+    const std::uint8_t* _bank_ptr = encoded.data() + 6;
+    if (compute_sysex_checksum(_bank_ptr, SYSEX_VMEM_SIZE) != (encoded[6 + SYSEX_VMEM_SIZE] & 0x7F)) {
+        return decode_error::checksum;
+    }
+
+    // voices are decoded aside so that a bank with an out of range field leaves data unchanged
+    std::array<voice_patch, 32> _decoded = data;
+    std::array<std::uint8_t, SYSEX_VOICE_PARAMETERS_SIZE> _parameters;
+    for (std::size_t _voice_index = 0; _voice_index < 32; ++_voice_index) {
+        const std::uint8_t* _voice_ptr = _bank_ptr + _voice_index * SYSEX_VMEM_VOICE_SIZE;
+        for (const vmem_field& _field : SYSEX_VMEM_FIELDS) {
+            _parameters[_field.parameter] = (_voice_ptr[_field.byte] >> _field.shift) & _field.mask;
+        }
+        const decode_result _voice = decode_voice_parameters(_parameters.data(), _decoded[_voice_index]);
+        if (!_voice) {
+            return _voice;
+        }
+    }
+
+    data = _decoded;
+    device = encoded[2] & 0x0F;
+    return decode_error::none;
 }
 
 void yamaha_tx81z::encode_performance_patch(
@@ -321,52 +812,144 @@ void yamaha_tx81z::encode_program_change_patch(
 {
 }
 
+void yamaha_tx81z::encode_microtune_octave_patch(
+    std::vector<std::uint8_t>& encoded,
+    const integral<std::uint8_t, 0, 15>& device,
+    const microtune_octave_patch& data)
+{
+    encode_microtune_keys(encoded, device.value(), SYSEX_MICROTUNE_OCTAVE_HEADER, data.key_note.data(), data.key_fine.data(), data.key_note.size());
+}
+
 void yamaha_tx81z::encode_microtune_patch(
     std::vector<std::uint8_t>& encoded,
     const integral<std::uint8_t, 0, 15>& device,
     const microtune_patch& data)
 {
+    encode_microtune_keys(encoded, device.value(), SYSEX_MICROTUNE_HEADER, data.key_note.data(), data.key_fine.data(), data.key_note.size());
 }
 
 void yamaha_tx81z::encode_voice_patch_request(
     std::vector<std::uint8_t>& encoded,
     const integral<std::uint8_t, 0, 15>& device)
 {
+    sysex_request(encoded, device.value(), SYSEX_ACED_HEADER);
 }
 
 void yamaha_tx81z::encode_bank_request(
     std::vector<std::uint8_t>& encoded,
     const integral<std::uint8_t, 0, 15>& device)
 {
+    sysex_request(encoded, device.value(), SYSEX_VMEM_BANK);
 }
 
 void yamaha_tx81z::encode_performance_patch_request(
     std::vector<std::uint8_t>& encoded,
     const integral<std::uint8_t, 0, 15>& device)
 {
+    sysex_request(encoded, device.value(), SYSEX_PCED_HEADER);
 }
 
 void yamaha_tx81z::encode_system_patch_request(
     std::vector<std::uint8_t>& encoded,
     const integral<std::uint8_t, 0, 15>& device)
 {
+    sysex_request(encoded, device.value(), SYSEX_SYSTEM_HEADER);
 }
 
 void yamaha_tx81z::encode_effect_patch_request(
     std::vector<std::uint8_t>& encoded,
     const integral<std::uint8_t, 0, 15>& device)
 {
+    sysex_request(encoded, device.value(), SYSEX_EFFECT_HEADER);
 }
 
 void yamaha_tx81z::encode_program_change_patch_request(
     std::vector<std::uint8_t>& encoded,
     const integral<std::uint8_t, 0, 15>& device)
 {
+    sysex_request(encoded, device.value(), SYSEX_PROGRAM_CHANGE_HEADER);
+}
+
+void yamaha_tx81z::encode_microtune_octave_patch_request(
+    std::vector<std::uint8_t>& encoded,
+    const integral<std::uint8_t, 0, 15>& device)
+{
+    sysex_request(encoded, device.value(), SYSEX_MICROTUNE_OCTAVE_HEADER);
 }
 
 void yamaha_tx81z::encode_microtune_patch_request(
     std::vector<std::uint8_t>& encoded,
     const integral<std::uint8_t, 0, 15>& device)
 {
+    sysex_request(encoded, device.value(), SYSEX_MICROTUNE_HEADER);
+}
+
+void add_backup_requests(
+    dump_pipeline& pipeline,
+    const integral<std::uint8_t, 0, 15>& device,
+    yamaha_tx81z_backup& data)
+{
+    const std::uint8_t _device = device.value();
+
+    std::vector<std::uint8_t> _voice_request;
+    yamaha_tx81z::encode_voice_patch_request(_voice_request, device);
+    pipeline.add(std::move(_voice_request), { match_dump(_device, SYSEX_ACED_HEADER), match_dump(_device, SYSEX_VCED_SINGLE) }, [&data](const std::vector<std::uint8_t>& encoded) {
+        integral<std::uint8_t, 0, 15> _received;
+        return decode_counted<yamaha_tx81z>(&yamaha_tx81z::decode_voice_patch, encoded, _received, data.voice);
+    });
+
+    std::vector<std::uint8_t> _bank_request;
+    yamaha_tx81z::encode_bank_request(_bank_request, device);
+    pipeline.add(std::move(_bank_request), { match_dump(_device, SYSEX_VMEM_BANK) }, [&data](const std::vector<std::uint8_t>& encoded) {
+        integral<std::uint8_t, 0, 15> _received;
+        return decode_counted<yamaha_tx81z>(&yamaha_tx81z::decode_bank, encoded, _received, data.bank);
+    });
+
+    std::vector<std::uint8_t> _performance_request;
+    yamaha_tx81z::encode_performance_patch_request(_performance_request, device);
+    pipeline.add(std::move(_performance_request), { match_dump(_device, SYSEX_PCED_HEADER) }, [&data](const std::vector<std::uint8_t>& encoded) {
+        return keep_frame(encoded, data.performance_frame);
+    });
+
+    std::vector<std::uint8_t> _system_request;
+    yamaha_tx81z::encode_system_patch_request(_system_request, device);
+    pipeline.add(std::move(_system_request), { match_dump(_device, SYSEX_SYSTEM_HEADER) }, [&data](const std::vector<std::uint8_t>& encoded) {
+        return keep_frame(encoded, data.system_frame);
+    });
+
+    std::vector<std::uint8_t> _effect_request;
+    yamaha_tx81z::encode_effect_patch_request(_effect_request, device);
+    pipeline.add(std::move(_effect_request), { match_dump(_device, SYSEX_EFFECT_HEADER) }, [&data](const std::vector<std::uint8_t>& encoded) {
+        return keep_frame(encoded, data.effect_frame);
+    });
+
+    std::vector<std::uint8_t> _program_change_request;
+    yamaha_tx81z::encode_program_change_patch_request(_program_change_request, device);
+    pipeline.add(std::move(_program_change_request), { match_dump(_device, SYSEX_PROGRAM_CHANGE_HEADER) }, [&data](const std::vector<std::uint8_t>& encoded) {
+        return keep_frame(encoded, data.program_change_frame);
+    });
+
+    std::vector<std::uint8_t> _microtune_request;
+    yamaha_tx81z::encode_microtune_patch_request(_microtune_request, device);
+    pipeline.add(std::move(_microtune_request), { match_dump(_device, SYSEX_MICROTUNE_HEADER) }, [&data](const std::vector<std::uint8_t>& encoded) {
+        integral<std::uint8_t, 0, 15> _received;
+        return decode_counted<yamaha_tx81z>(&yamaha_tx81z::decode_microtune_patch, encoded, _received, data.microtune);
+    });
+}
+
+decode_result yamaha_tx81z::decode_microtune_octave_patch(
+    const std::vector<std::uint8_t>& encoded,
+    integral<std::uint8_t, 0, 15>& device,
+    microtune_octave_patch& data)
+{
+    return decode_microtune_keys(encoded, device, SYSEX_MICROTUNE_OCTAVE_HEADER, data.key_note.data(), data.key_fine.data(), data.key_note.size());
+}
+
+decode_result yamaha_tx81z::decode_microtune_patch(
+    const std::vector<std::uint8_t>& encoded,
+    integral<std::uint8_t, 0, 15>& device,
+    microtune_patch& data)
+{
+    return decode_microtune_keys(encoded, device, SYSEX_MICROTUNE_HEADER, data.key_note.data(), data.key_fine.data(), data.key_note.size());
+}
 }
-}
\ No newline at end of file
@@ -1,5 +1,9 @@
 #include <midispec/akai_lpk25.hpp>
+#include <midispec/akai_mpx8.hpp>
+#include <midispec/core/capability_matrix.hpp>
 #include <midispec/core/hardware.hpp>
+#include <midispec/core/note_messages.hpp>
+#include <midispec/novation_launchpads.hpp>
 
 namespace midispec {
 
@@ -8,6 +12,130 @@ struct gtest_akai_lpk25 : public gtest_hardware {};
 TEST_F(gtest_akai_lpk25, no_test_to_run)
 {
 }
+
+// codec tests run without hardware
+
+TEST(gtest_akai_lpk25_codec, note_messages_without_velocity)
+{
+    std::vector<std::uint8_t> _encoded;
+    integral<std::uint8_t, 0, 15> _channel;
+    integral<std::uint8_t, 0, 127> _note;
+    integral<std::uint8_t, 0, 127> _velocity;
+
+    // the LPK25 plays at full velocity and releases at zero velocity, whatever is requested
+    encode_note_on<akai_lpk25>(_encoded, 3, 60, 10);
+    encode_note_off<akai_lpk25>(_encoded, 3, 60, 20);
+    const std::vector<std::uint8_t> _expected = { 0x93, 0x3C, 0x7F, 0x83, 0x3C, 0x00 };
+    EXPECT_EQ(_encoded, _expected);
+
+    // the release velocity it does not decode is read from the message
+    EXPECT_TRUE(decode_note_off<akai_lpk25>({ 0x83, 0x3C, 0x40 }, _channel, _note, _velocity));
+    EXPECT_EQ(_channel, 3);
+    EXPECT_EQ(_note, 60);
+    EXPECT_EQ(_velocity, 0x40);
+    EXPECT_TRUE(decode_note_on<akai_lpk25>({ 0x95, 0x3E, 0x22 }, _channel, _note, _velocity));
+    EXPECT_EQ(_channel, 5);
+    EXPECT_EQ(_velocity, 0x22);
+    EXPECT_EQ(decode_note_off<akai_lpk25>({ 0x93, 0x3C, 0x40 }, _channel, _note, _velocity).error(), decode_error::header);
+}
+
+TEST(gtest_akai_lpk25_codec, note_messages_without_channel)
+{
+    std::vector<std::uint8_t> _encoded;
+    integral<std::uint8_t, 0, 15> _channel;
+    integral<std::uint8_t, 0, 127> _note;
+    integral<std::uint8_t, 0, 127> _velocity;
+
+    // the MPX8 always uses channel 10, the requested channel is dropped
+    encode_note_on<akai_mpx8>(_encoded, 3, 60, 100);
+    encode_note_off<akai_mpx8>(_encoded, 3, 60, 20);
+    const std::vector<std::uint8_t> _expected = { 0x99, 0x3C, 0x64, 0x89, 0x3C, 0x14 };
+    EXPECT_EQ(_encoded, _expected);
+
+    // the channel it does not decode is read from the status byte, and left untouched on rejection
+    EXPECT_TRUE(decode_note_on<akai_mpx8>({ 0x99, 0x3C, 0x64 }, _channel, _note, _velocity));
+    EXPECT_EQ(_channel, 9);
+    EXPECT_EQ(_note, 60);
+    EXPECT_EQ(_velocity, 100);
+    _channel = 0;
+    EXPECT_EQ(decode_note_off<akai_mpx8>({ 0x83, 0x3C, 0x14 }, _channel, _note, _velocity).error(), decode_error::channel);
+    EXPECT_EQ(_channel, 0);
+}
+
+TEST(gtest_akai_lpk25_codec, note_messages_without_channel_and_velocity)
+{
+    std::vector<std::uint8_t> _encoded;
+    integral<std::uint8_t, 0, 15> _channel;
+    integral<std::uint8_t, 0, 127> _note;
+    integral<std::uint8_t, 0, 127> _velocity;
+
+    // the Launchpad S listens on channel 1 and turns LEDs off with a zero velocity note on
+    encode_note_on<novation_launchpads>(_encoded, 5, 0x11, 0x3C);
+    encode_note_off<novation_launchpads>(_encoded, 5, 0x11, 100);
+    const std::vector<std::uint8_t> _expected = { 0x90, 0x11, 0x3C, 0x90, 0x11, 0x00 };
+    EXPECT_EQ(_encoded, _expected);
+
+    // both channel and velocity are synthesized from the accepted message
+    _channel = 5;
+    _velocity = 5;
+    EXPECT_TRUE(decode_note_off<novation_launchpads>({ 0x90, 0x11, 0x00 }, _channel, _note, _velocity));
+    EXPECT_EQ(_channel, 0);
+    EXPECT_EQ(_note, 0x11);
+    EXPECT_EQ(_velocity, 0);
+    EXPECT_TRUE(decode_note_on<novation_launchpads>({ 0x90, 0x12, 0x3C }, _channel, _note, _velocity));
+    EXPECT_EQ(_note, 0x12);
+    EXPECT_EQ(_velocity, 0x3C);
+    EXPECT_EQ(decode_note_on<novation_launchpads>({ 0x90, 0x12, 0x00 }, _channel, _note, _velocity).error(), decode_error::header);
+}
+
+TEST(gtest_akai_lpk25_codec, capability_matrix)
+{
+    const capability_mask _notes = capability_bit(message::note_off, capability::receive) | capability_bit(message::note_off, capability::transmit)
+        | capability_bit(message::note_on, capability::receive) | capability_bit(message::note_on, capability::transmit);
+    const capability_mask _inquiry = capability_bit(message::universal_inquiry, capability::request) | capability_bit(message::universal_inquiry, capability::transmit);
+    EXPECT_EQ(capability_bit(message::note_off, capability::receive), 0x1u);
+    EXPECT_EQ(capability_bit(message::voice_patch, capability::transmit), capability_mask(1) << 44);
+    EXPECT_EQ(capability_bit(message::count, capability::receive), 0u);
+
+    EXPECT_EQ(capability_matrix_v<akai_lpk25>, _notes | capability_bit(message::clock, capability::receive) | capability_bit(message::song_position, capability::receive) | capability_bit(message::continue_, capability::receive) | capability_bit(message::reset, capability::transmit));
+    EXPECT_EQ(capability_matrix_v<akai_mpx8>, _notes | capability_bit(message::note_aftertouch, capability::transmit) | _inquiry);
+    EXPECT_EQ(capability_matrix_v<novation_launchpads>, _notes | capability_bit(message::reset, capability::receive) | _inquiry);
+
+    EXPECT_TRUE(has_capability(capability_matrix_v<akai_mpx8>, message::note_aftertouch, capability::transmit));
+    EXPECT_FALSE(has_capability(capability_matrix_v<akai_mpx8>, message::note_aftertouch, capability::receive));
+    EXPECT_FALSE(has_capability(capability_matrix_v<akai_lpk25>, message::universal_inquiry, capability::request));
+    EXPECT_STREQ(message_name(message::continue_), "continue");
+    EXPECT_STREQ(message_name(message::count), "");
+}
+
+TEST(gtest_akai_lpk25_codec, message_of)
+{
+    std::vector<std::uint8_t> _encoded;
+    akai_lpk25::encode_clock(_encoded);
+    EXPECT_EQ(message_of(_encoded), message::clock);
+    EXPECT_EQ(message_of({ 0x83, 0x3C, 0x00 }), message::note_off);
+    EXPECT_EQ(message_of({ 0x93, 0x3C, 0x00 }), message::note_on);
+    EXPECT_EQ(message_of({ 0xA9, 0x3C, 0x40 }), message::note_aftertouch);
+    EXPECT_EQ(message_of({ 0xB0, 0x7B, 0x00 }), message::all_notes_off);
+    EXPECT_EQ(message_of({ 0xB0, 0x07, 0x64 }), message::count);
+    EXPECT_EQ(message_of({ 0xC2, 0x05 }), message::program_change);
+    EXPECT_EQ(message_of({ 0xE0, 0x00, 0x40 }), message::pitchbend_change);
+    EXPECT_EQ(message_of({ 0xF2, 0x10, 0x00 }), message::song_position);
+    EXPECT_EQ(message_of({ 0xFA }), message::start);
+    EXPECT_EQ(message_of({ 0xFB }), message::continue_);
+    EXPECT_EQ(message_of({ 0xFC }), message::stop);
+    EXPECT_EQ(message_of({ 0xFE }), message::active_sens);
+    EXPECT_EQ(message_of({ 0xFF }), message::reset);
+    EXPECT_EQ(message_of({ 0xF0, 0x7E, 0x7F, 0x06, 0x01, 0xF7 }), message::universal_inquiry);
+    EXPECT_EQ(message_of({ 0xF0, 0x47, 0x00, 0x26, 0x40, 0xF7 }), message::system_exclusive);
+    EXPECT_EQ(message_of(std::vector<std::uint8_t> {}), message::count);
+
+    // routing by capability accepts what the hardware receives, and messages outside the traits
+    const capability_mask _lpk25 = capability_matrix_v<akai_lpk25>;
+    EXPECT_TRUE(has_capability(_lpk25, message_of(_encoded), capability::receive));
+    EXPECT_FALSE(has_capability(_lpk25, message_of({ 0xFA }), capability::receive));
+    EXPECT_EQ(capability_bit(message_of({ 0xB0, 0x07, 0x64 }), capability::receive) & ~_lpk25, 0u);
+}
 }
 
 int main(int argc, char** argv)
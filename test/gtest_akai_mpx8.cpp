@@ -1,5 +1,8 @@
 #include <midispec/akai_mpx8.hpp>
+#include <midispec/akai_rythmwolf.hpp>
+#include <midispec/core/device_variant.hpp>
 #include <midispec/core/hardware.hpp>
+#include <midispec/core/transaction_port.hpp>
 
 namespace midispec {
 
@@ -25,6 +28,164 @@ TEST_F(gtest_akai_mpx8, universal_inquiry)
     EXPECT_EQ(_received_model, 25);
     // when tested version == 256
 }
+
+// codec tests run without hardware
+
+TEST(gtest_akai_mpx8_codec, decode_errors)
+{
+    integral<std::uint8_t, 0, 127> _note;
+    integral<std::uint8_t, 0, 127> _velocity;
+
+    EXPECT_EQ(akai_mpx8::decode_note_on({ 0x99, 0x3C, 0x7F }, _note, _velocity).error(), decode_error::none);
+    EXPECT_EQ(akai_mpx8::decode_note_on({ 0x99, 0x3C }, _note, _velocity).error(), decode_error::size);
+    EXPECT_EQ(akai_mpx8::decode_note_on({ 0x89, 0x3C, 0x7F }, _note, _velocity).error(), decode_error::header);
+    EXPECT_EQ(akai_mpx8::decode_note_on({ 0x90, 0x3C, 0x7F }, _note, _velocity).error(), decode_error::channel);
+    EXPECT_EQ(akai_mpx8::decode_note_aftertouch({ 0xA9, 0x3C, 0xFF }, _note, _velocity).error(), decode_error::range);
+}
+
+TEST(gtest_akai_mpx8_codec, variant_universal_inquiry)
+{
+    const std::vector<std::uint8_t> _encoded = { 0xF0, 0x7E, 0x00, 0x06, 0x02, 0x47, 0x19, 0x00, 0x19, 0x00, 0x00, 0x01, 0x00, 0x00, 0xF7 };
+    integral<std::uint8_t, 0, 127> _received_device;
+    std::uint32_t _received_manufacturer;
+    std::uint32_t _received_family;
+    std::uint32_t _received_model;
+    std::uint32_t _received_version;
+
+    device_variant<akai_mpx8, akai_rythmwolf> _variant;
+    EXPECT_TRUE(_variant.decode_universal_inquiry(_encoded, _received_device, _received_manufacturer, _received_family, _received_model, _received_version));
+    EXPECT_EQ(_received_manufacturer, 71);
+    EXPECT_EQ(_received_family, 25);
+    EXPECT_EQ(_received_model, 25);
+    EXPECT_EQ(_variant.decode_universal_inquiry({ 0xF0, 0x7E, 0x00, 0x06, 0x02, 0xF7 }, _received_device, _received_manufacturer, _received_family, _received_model, _received_version).error(), decode_error::size);
+
+    _variant = device_variant<akai_mpx8, akai_rythmwolf>(hardware_tag<akai_rythmwolf> {});
+    EXPECT_EQ(_variant.decode_universal_inquiry(_encoded, _received_device, _received_manufacturer, _received_family, _received_model, _received_version).error(), decode_error::unsupported);
+}
+
+namespace {
+
+    bool ready(std::future<std::vector<std::uint8_t>>& future)
+    {
+        return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }
+
+}
+
+TEST(gtest_akai_mpx8_codec, transaction_port_buckets)
+{
+    std::vector<std::vector<std::uint8_t>> _sent;
+    transaction_port _port;
+    _port.open([&_sent](const std::vector<std::uint8_t>& encoded) { _sent.push_back(encoded); });
+
+    // universal requests are keyed by sub-ID#1, manufacturer requests by their one or three byte ID
+    std::vector<std::uint8_t> _inquiry;
+    akai_mpx8::encode_universal_inquiry_request(_inquiry, 0x7F);
+    std::future<std::vector<std::uint8_t>> _inquiry_reply = _port.transact(_inquiry, {}, std::chrono::seconds(10));
+    std::future<std::vector<std::uint8_t>> _yamaha_reply = _port.transact({ 0xF0, 0x43, 0x20, 0x03, 0xF7 }, {}, std::chrono::seconds(10));
+    std::future<std::vector<std::uint8_t>> _novation_reply = _port.transact({ 0xF0, 0x00, 0x20, 0x29, 0x00, 0xF7 }, [](const std::vector<std::uint8_t>& encoded) { return encoded.size() > 4 && encoded[4] == 0x02; }, std::chrono::seconds(10));
+    ASSERT_EQ(_sent.size(), 3u);
+    EXPECT_EQ(_sent[0], _inquiry);
+    EXPECT_EQ(_port.outstanding(), 3u);
+
+    EXPECT_FALSE(_port.receive({ 0xF0, 0x7E, 0x00, 0x09, 0x01, 0xF7 }));
+    EXPECT_FALSE(_port.receive({ 0xF0, 0x00, 0x20, 0x30, 0x02, 0xF7 }));
+    EXPECT_FALSE(_port.receive({ 0xF0, 0x00, 0x20, 0x29, 0x01, 0xF7 }));
+    EXPECT_FALSE(_port.receive({ 0x99, 0x3C, 0x7F }));
+    EXPECT_FALSE(ready(_inquiry_reply));
+    EXPECT_FALSE(ready(_yamaha_reply));
+    EXPECT_FALSE(ready(_novation_reply));
+
+    const std::vector<std::uint8_t> _yamaha_dump = { 0xF0, 0x43, 0x00, 0x03, 0x00, 0xF7 };
+    EXPECT_TRUE(_port.receive(_yamaha_dump));
+    ASSERT_TRUE(ready(_yamaha_reply));
+    EXPECT_EQ(_yamaha_reply.get(), _yamaha_dump);
+    EXPECT_FALSE(ready(_inquiry_reply));
+
+    const std::vector<std::uint8_t> _inquiry_encoded = { 0xF0, 0x7E, 0x00, 0x06, 0x02, 0x47, 0x19, 0x00, 0x19, 0x00, 0x00, 0x01, 0x00, 0x00, 0xF7 };
+    EXPECT_TRUE(_port.receive(_inquiry_encoded));
+    ASSERT_TRUE(ready(_inquiry_reply));
+    integral<std::uint8_t, 0, 127> _device;
+    std::uint32_t _manufacturer;
+    std::uint32_t _family;
+    std::uint32_t _model;
+    std::uint32_t _version;
+    EXPECT_TRUE(akai_mpx8::decode_universal_inquiry(_inquiry_reply.get(), _device, _manufacturer, _family, _model, _version));
+    EXPECT_EQ(_manufacturer, 71);
+
+    const std::vector<std::uint8_t> _novation_encoded = { 0xF0, 0x00, 0x20, 0x29, 0x02, 0xF7 };
+    EXPECT_TRUE(_port.receive(_novation_encoded));
+    ASSERT_TRUE(ready(_novation_reply));
+    EXPECT_EQ(_novation_reply.get(), _novation_encoded);
+
+    EXPECT_EQ(_port.outstanding(), 0u);
+    const transaction_port_statistics _statistics = _port.statistics();
+    EXPECT_EQ(_statistics.requests, 3u);
+    EXPECT_EQ(_statistics.replies, 3u);
+    EXPECT_EQ(_statistics.unmatched, 4u);
+    EXPECT_EQ(_statistics.outstanding_max, 3u);
+}
+
+TEST(gtest_akai_mpx8_codec, transaction_port_reply_before_send)
+{
+    // the hardware answers before the send callback returns
+    const std::vector<std::uint8_t> _reply = { 0xF0, 0x7E, 0x00, 0x06, 0x02, 0x47, 0x19, 0x00, 0x19, 0x00, 0x00, 0x01, 0x00, 0x00, 0xF7 };
+    transaction_port _port;
+    bool _received = false;
+    _port.open([&_port, &_reply, &_received](const std::vector<std::uint8_t>&) { _received = _port.receive(_reply); });
+    std::vector<std::uint8_t> _inquiry;
+    akai_mpx8::encode_universal_inquiry_request(_inquiry, 0x7F);
+    std::future<std::vector<std::uint8_t>> _future = _port.transact(_inquiry, {}, std::chrono::seconds(10));
+    EXPECT_TRUE(_received);
+    ASSERT_TRUE(ready(_future));
+    EXPECT_EQ(_future.get(), _reply);
+    EXPECT_EQ(_port.statistics().unmatched, 0u);
+}
+
+TEST(gtest_akai_mpx8_codec, transaction_port_timeout)
+{
+    transaction_port _port;
+    _port.open([](const std::vector<std::uint8_t>&) { });
+    std::vector<std::uint8_t> _inquiry;
+    akai_mpx8::encode_universal_inquiry_request(_inquiry, 0x7F);
+    std::future<std::vector<std::uint8_t>> _short = _port.transact(_inquiry, {}, std::chrono::milliseconds(20));
+    std::future<std::vector<std::uint8_t>> _long = _port.transact(_inquiry, {}, std::chrono::seconds(10));
+    ASSERT_EQ(_short.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    EXPECT_TRUE(_short.get().empty());
+    EXPECT_FALSE(ready(_long));
+    EXPECT_EQ(_port.outstanding(), 1u);
+    EXPECT_EQ(_port.statistics().timeouts, 1u);
+
+    // the reply of the expired request completes the next one
+    const std::vector<std::uint8_t> _reply = { 0xF0, 0x7E, 0x00, 0x06, 0x02, 0x47, 0x19, 0x00, 0x19, 0x00, 0x00, 0x01, 0x00, 0x00, 0xF7 };
+    EXPECT_TRUE(_port.receive(_reply));
+    ASSERT_TRUE(ready(_long));
+    EXPECT_EQ(_long.get(), _reply);
+    EXPECT_FALSE(_port.receive(_reply));
+}
+
+TEST(gtest_akai_mpx8_codec, transaction_port_close)
+{
+    std::size_t _sent = 0;
+    transaction_port _port;
+    _port.open([&_sent](const std::vector<std::uint8_t>&) { ++_sent; });
+    std::vector<std::uint8_t> _inquiry;
+    akai_mpx8::encode_universal_inquiry_request(_inquiry, 0x7F);
+    std::future<std::vector<std::uint8_t>> _first = _port.transact(_inquiry, {}, std::chrono::seconds(10));
+    std::future<std::vector<std::uint8_t>> _second = _port.transact({ 0xF0, 0x43, 0x20, 0x03, 0xF7 }, {}, std::chrono::seconds(10));
+    _port.close();
+    ASSERT_TRUE(ready(_first));
+    ASSERT_TRUE(ready(_second));
+    EXPECT_TRUE(_first.get().empty());
+    EXPECT_TRUE(_second.get().empty());
+    EXPECT_EQ(_port.outstanding(), 0u);
+
+    // requests after close complete at once without being sent
+    std::future<std::vector<std::uint8_t>> _closed = _port.transact(_inquiry, {}, std::chrono::seconds(10));
+    ASSERT_TRUE(ready(_closed));
+    EXPECT_TRUE(_closed.get().empty());
+    EXPECT_EQ(_sent, 2u);
+}
 }
 
 int main(int argc, char** argv)
@@ -0,0 +1,126 @@
+#include <algorithm>
+
+#include <midispec/akai_rythmwolf.hpp>
+#include <midispec/core/clock_follower.hpp>
+#include <midispec/core/clock_master.hpp>
+#include <midispec/core/hardware.hpp>
+
+namespace midispec {
+
+struct gtest_akai_rythmwolf : public gtest_hardware {};
+
+TEST_F(gtest_akai_rythmwolf, no_test_to_run)
+{
+}
+
+// codec tests run without hardware
+
+TEST(gtest_akai_rythmwolf_codec, clock_follower_position)
+{
+    const std::vector<std::uint8_t> _clock = { 0xF8 };
+    const std::vector<std::uint8_t> _start = { 0xFA };
+    const std::vector<std::uint8_t> _stop = { 0xFC };
+    const std::chrono::nanoseconds _period = std::chrono::microseconds(20833);
+    clock_follower<akai_rythmwolf> _follower;
+    std::chrono::steady_clock::time_point _time = std::chrono::steady_clock::time_point() + std::chrono::seconds(1);
+
+    // the position waits on the first tick after start, whose arrival is position 0
+    EXPECT_TRUE(_follower.receive(_start, _time));
+    EXPECT_DOUBLE_EQ(_follower.position(_time + _period / 2), 0.0);
+    double _previous = 0.0;
+    for (std::size_t _tick = 0; _tick < 48; ++_tick) {
+        _time += _period;
+        const double _before = _follower.position(_time - std::chrono::nanoseconds(1));
+        EXPECT_TRUE(_follower.receive(_clock, _time));
+        const double _after = _follower.position(_time);
+        // the position advances tick by tick until the loop locks on the second interval, then never jumps
+        EXPECT_NEAR(_after, static_cast<double>(_tick), 0.01);
+        if (_tick >= 2) {
+            EXPECT_NEAR(_after, _before, 0.01);
+        }
+        EXPECT_GE(_after, _previous);
+        _previous = _after;
+    }
+    EXPECT_NEAR(_follower.beats_per_minute(), 120.0, 0.01);
+
+    // stopping halfway to the next tick keeps the position where it was
+    const double _playing = _follower.position(_time + _period / 2);
+    EXPECT_NEAR(_playing, 47.5, 0.01);
+    EXPECT_TRUE(_follower.receive(_stop, _time + _period / 2));
+    EXPECT_DOUBLE_EQ(_follower.position(_time + _period / 2), _playing);
+    EXPECT_DOUBLE_EQ(_follower.position(_time + _period * 10), _playing);
+    EXPECT_TRUE(_follower.receive(_clock, _time + _period));
+    EXPECT_DOUBLE_EQ(_follower.position(_time + _period * 10), _playing);
+}
+
+TEST(gtest_akai_rythmwolf_codec, clock_master_transport)
+{
+    struct sent {
+        std::chrono::steady_clock::time_point time;
+        std::vector<std::uint8_t> message;
+    };
+    std::mutex _mutex;
+    std::vector<sent> _sent;
+    const auto _wait_ticks = [&_mutex, &_sent](const std::size_t ticks) {
+        std::size_t _count = 0;
+        while (_count < ticks) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            std::lock_guard<std::mutex> _lock(_mutex);
+            _count = std::count_if(_sent.begin(), _sent.end(), [](const sent& value) { return value.message == std::vector<std::uint8_t> { 0xF8 }; });
+        }
+    };
+
+    // 625 beats per minute ticks every 4 ms, 1000 every 2.5 ms
+    clock_master<akai_rythmwolf> _master;
+    _master.open([&_mutex, &_sent](const std::vector<std::uint8_t>& encoded) {
+        std::lock_guard<std::mutex> _lock(_mutex);
+        _sent.push_back(sent { std::chrono::steady_clock::now(), encoded });
+    },
+        625.0);
+    _wait_ticks(5);
+    _master.start();
+    _wait_ticks(30);
+    _master.tempo(1000.0);
+    _master.stop();
+    _wait_ticks(60);
+    _master.song_position(16);
+    _master.close();
+
+    // transport goes out on its own right before a tick, or when closing without waiting for the next tick
+    std::lock_guard<std::mutex> _lock(_mutex);
+    std::vector<std::uint8_t> _transport;
+    std::vector<std::chrono::steady_clock::time_point> _ticks;
+    for (std::size_t _index = 0; _index < _sent.size(); ++_index) {
+        const std::vector<std::uint8_t>& _message = _sent[_index].message;
+        if (_message == std::vector<std::uint8_t> { 0xF8 }) {
+            _ticks.push_back(_sent[_index].time);
+            continue;
+        }
+        ASSERT_FALSE(_message.empty());
+        _transport.push_back(_message[0]);
+        if (_message[0] != 0xF2) {
+            ASSERT_EQ(_message.size(), 1);
+            ASSERT_LT(_index + 1, _sent.size());
+            EXPECT_EQ(_sent[_index + 1].message, std::vector<std::uint8_t> { 0xF8 });
+        } else {
+            EXPECT_EQ(_message, (std::vector<std::uint8_t> { 0xF2, 0x10, 0x00 }));
+            EXPECT_TRUE(_index + 1 == _sent.size() || _sent[_index + 1].message == std::vector<std::uint8_t> { 0xF8 });
+        }
+    }
+    EXPECT_EQ(_transport, (std::vector<std::uint8_t> { 0xFA, 0xFC, 0xF2 }));
+
+    // deadlines are anchored on the origin, so the mean period follows the tempo on each side of the change
+    ASSERT_GE(_ticks.size(), 60);
+    const double _before = static_cast<double>((_ticks[30] - _ticks[0]).count()) / 30.0e6;
+    const double _after = static_cast<double>((_ticks.back() - _ticks[_ticks.size() - 21]).count()) / 20.0e6;
+    EXPECT_NEAR(_before, 4.0, 0.5);
+    EXPECT_NEAR(_after, 2.5, 0.5);
+    EXPECT_EQ(_master.statistics().ticks, _ticks.size());
+}
+}
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
\ No newline at end of file
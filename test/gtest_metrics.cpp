@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+
+#include <midispec/core/metrics.hpp>
+#include <midispec/core/state_mirror.hpp>
+#include <midispec/yamaha_dx7.hpp>
+#include <midispec/yamaha_tx81z.hpp>
+
+namespace midispec {
+
+// codec tests run without hardware, this executable is built with MIDISPEC_METRICS
+
+namespace {
+
+    constexpr std::size_t SYSTEM_EXCLUSIVE = static_cast<std::size_t>(message::system_exclusive);
+
+}
+
+TEST(gtest_metrics_codec, enabled)
+{
+    EXPECT_TRUE(metrics_enabled);
+}
+
+TEST(gtest_metrics_codec, message_of_system_exclusive)
+{
+    const std::vector<std::uint8_t> _inquiry = { 0xF0, 0x7E, 0x00, 0x06, 0x01, 0xF7 };
+    const std::vector<std::uint8_t> _dump = { 0xF0, 0x43, 0x05, 0x00, 0x01, 0x1B };
+    EXPECT_EQ(message_of(_inquiry), message::universal_inquiry);
+    EXPECT_EQ(message_of(_dump), message::system_exclusive);
+    EXPECT_STREQ(message_name(message::system_exclusive), "system_exclusive");
+
+    // system exclusive messages without a capability trait carry no capability bit, so routing never rejects them
+    EXPECT_EQ(capability_bit(message::system_exclusive, capability::receive), 0u);
+    EXPECT_FALSE(has_capability(~capability_mask(0), message::system_exclusive, capability::receive));
+}
+
+TEST(gtest_metrics_codec, decode_counted)
+{
+    const metrics_snapshot _before = metrics<yamaha_dx7>::snapshot();
+    std::vector<std::uint8_t> _encoded;
+    std::array<yamaha_dx7::voice_patch, 32> _bank = {};
+    integral<std::uint8_t, 0, 15> _device;
+    yamaha_dx7::encode_voice_patch_bank(_encoded, 3, _bank);
+    EXPECT_TRUE(decode_counted<yamaha_dx7>(&yamaha_dx7::decode_voice_patch_bank, _encoded, _device, _bank));
+    EXPECT_EQ(_device, 3);
+    _encoded[_encoded.size() - 2] ^= 0x01;
+    EXPECT_EQ(decode_counted<yamaha_dx7>(&yamaha_dx7::decode_voice_patch_bank, _encoded, _device, _bank).error(), decode_error::checksum);
+
+    const metrics_snapshot _after = metrics<yamaha_dx7>::snapshot();
+    EXPECT_EQ(_after.decoded[SYSTEM_EXCLUSIVE] - _before.decoded[SYSTEM_EXCLUSIVE], 1u);
+    EXPECT_EQ(_after.rejected[SYSTEM_EXCLUSIVE] - _before.rejected[SYSTEM_EXCLUSIVE], 1u);
+    const std::size_t _checksum = static_cast<std::size_t>(decode_error::checksum);
+    EXPECT_EQ(_after.rejections[_checksum] - _before.rejections[_checksum], 1u);
+}
+
+TEST(gtest_metrics_codec, state_mirror_receive)
+{
+    const metrics_snapshot _before = metrics<yamaha_tx81z>::snapshot();
+    state_mirror<yamaha_tx81z> _mirror;
+    std::vector<std::uint8_t> _encoded;
+    yamaha_tx81z::encode_voice_patch(_encoded, 1, yamaha_tx81z::voice_patch {});
+    EXPECT_TRUE(_mirror.receive(_encoded));
+    _encoded.resize(_encoded.size() - 1);
+    EXPECT_FALSE(_mirror.receive(_encoded));
+
+    const metrics_snapshot _after = metrics<yamaha_tx81z>::snapshot();
+    EXPECT_EQ(_after.decoded[SYSTEM_EXCLUSIVE] - _before.decoded[SYSTEM_EXCLUSIVE], 1u);
+    EXPECT_EQ(_after.rejected[SYSTEM_EXCLUSIVE] - _before.rejected[SYSTEM_EXCLUSIVE], 1u);
+}
+
+}
@@ -0,0 +1,204 @@
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
+#include <gtest/gtest.h>
+
+#include <midispec/core/midi_file_reader.hpp>
+#include <midispec/core/midi_file_recorder.hpp>
+
+namespace midispec {
+
+// codec tests run without hardware
+
+namespace {
+
+    // format 1 file at 96 ticks per quarter note, a tempo track and a note track using running status
+    const std::vector<std::uint8_t> two_tracks = {
+        'M', 'T', 'h', 'd', 0x00, 0x00, 0x00, 0x06, 0x00, 0x01, 0x00, 0x02, 0x00, 0x60,
+        'M', 'T', 'r', 'k', 0x00, 0x00, 0x00, 0x12,
+        0x00, 0xFF, 0x51, 0x03, 0x07, 0xA1, 0x20, // 120 bpm at tick 0
+        0x60, 0xFF, 0x51, 0x03, 0x03, 0xD0, 0x90, // 240 bpm at tick 96
+        0x60, 0xFF, 0x2F, 0x00, // end of track at tick 192
+        'M', 'T', 'r', 'k', 0x00, 0x00, 0x00, 0x12,
+        0x00, 0x90, 0x3C, 0x64, // note on at tick 0
+        0x30, 0x3E, 0x64, // note on at tick 48, running status
+        0x30, 0x80, 0x3C, 0x00, // note off at tick 96
+        0x60, 0x3E, 0x00, // note off at tick 192, running status
+        0x00, 0xFF, 0x2F, 0x00 // end of track at tick 192
+    };
+
+    struct expected_event {
+        std::uint64_t tick;
+        std::int64_t time;
+        std::uint16_t track;
+        std::uint8_t status;
+        std::uint8_t meta_type;
+        std::uint8_t first;
+    };
+
+    std::vector<std::uint8_t> read_file(const std::string& path)
+    {
+        std::ifstream _stream(path, std::ios::binary);
+        return std::vector<std::uint8_t>(std::istreambuf_iterator<char>(_stream), std::istreambuf_iterator<char>());
+    }
+
+}
+
+TEST(gtest_midi_file_reader_codec, header)
+{
+    midi_file_reader _reader;
+    ASSERT_TRUE(_reader.open(two_tracks.data(), two_tracks.size()));
+    EXPECT_EQ(_reader.format(), 1);
+    EXPECT_EQ(_reader.tracks(), 2);
+    EXPECT_EQ(_reader.division(), 96);
+    EXPECT_FALSE(_reader.open(two_tracks.data(), 13));
+}
+
+TEST(gtest_midi_file_reader_codec, merge_running_status_and_tempo)
+{
+    const expected_event _expected[] = {
+        { 0, 0, 0, 0xFF, 0x51, 0x07 },
+        { 0, 0, 1, 0x90, 0x00, 0x3C },
+        { 48, 250000, 1, 0x90, 0x00, 0x3E },
+        { 96, 500000, 0, 0xFF, 0x51, 0x03 },
+        { 96, 500000, 1, 0x80, 0x00, 0x3C },
+        { 192, 750000, 0, 0xFF, 0x2F, 0x00 },
+        { 192, 750000, 1, 0x80, 0x00, 0x3E },
+        { 192, 750000, 1, 0xFF, 0x2F, 0x00 }
+    };
+    midi_file_reader _reader;
+    midi_file_event _event;
+    ASSERT_TRUE(_reader.open(two_tracks.data(), two_tracks.size()));
+    for (int _pass = 0; _pass < 2; ++_pass) {
+        for (const expected_event& _next : _expected) {
+            ASSERT_TRUE(_reader.next(_event));
+            EXPECT_EQ(_event.tick, _next.tick);
+            EXPECT_EQ(_event.time.count(), _next.time);
+            EXPECT_EQ(_event.track, _next.track);
+            EXPECT_EQ(_event.status, _next.status);
+            EXPECT_EQ(_event.meta_type, _next.meta_type);
+            if (_event.size != 0) {
+                EXPECT_EQ(_event.data[0], _next.first);
+            }
+        }
+        EXPECT_FALSE(_reader.next(_event));
+        _reader.rewind();
+    }
+}
+
+TEST(gtest_midi_file_reader_codec, encode_running_status)
+{
+    midi_file_reader _reader;
+    midi_file_event _event;
+    std::vector<std::uint8_t> _encoded;
+    ASSERT_TRUE(_reader.open(two_tracks.data(), two_tracks.size()));
+    while (_reader.next(_event)) {
+        _event.encode(_encoded);
+    }
+    const std::vector<std::uint8_t> _wire = { 0x90, 0x3C, 0x64, 0x90, 0x3E, 0x64, 0x80, 0x3C, 0x00, 0x80, 0x3E, 0x00 };
+    EXPECT_EQ(_encoded, _wire);
+}
+
+TEST(gtest_midi_file_reader_codec, recorder_round_trip)
+{
+    const std::string _path = testing::TempDir() + "midispec_recorder_round_trip.mid";
+    const std::chrono::steady_clock::time_point _origin = std::chrono::steady_clock::now();
+    midi_file_recorder _recorder;
+    ASSERT_TRUE(_recorder.open(_path, _origin, 480, 500000));
+    _recorder.record({ 0x90, 0x3C, 0x64 }, _origin);
+    _recorder.record({ 0x90, 0x3E, 0x64 }, _origin + std::chrono::milliseconds(250));
+    _recorder.record({ 0xF8 }, _origin + std::chrono::milliseconds(300));
+    _recorder.record({ 0xF0, 0x7E, 0x7F, 0x06, 0x01, 0xF7 }, _origin + std::chrono::milliseconds(500));
+    _recorder.record({ 0x90, 0x3C, 0x00 }, _origin + std::chrono::milliseconds(750));
+    _recorder.close();
+    const midi_file_recorder_statistics _statistics = _recorder.statistics();
+    EXPECT_EQ(_statistics.events_recorded, 4u);
+    EXPECT_EQ(_statistics.events_skipped, 1u);
+    EXPECT_EQ(_statistics.events_dropped, 0u);
+    EXPECT_EQ(_statistics.write_errors, 0u);
+
+    // the second note uses running status, the system exclusive message cancels it for the last note
+    const std::vector<std::uint8_t> _track = {
+        0x00, 0xFF, 0x51, 0x03, 0x07, 0xA1, 0x20,
+        0x00, 0x90, 0x3C, 0x64,
+        0x81, 0x70, 0x3E, 0x64,
+        0x81, 0x70, 0xF0, 0x05, 0x7E, 0x7F, 0x06, 0x01, 0xF7,
+        0x81, 0x70, 0x90, 0x3C, 0x00,
+        0x00, 0xFF, 0x2F, 0x00
+    };
+    const std::vector<std::uint8_t> _file = read_file(_path);
+    ASSERT_EQ(_file.size(), 22 + _track.size());
+    EXPECT_EQ(_statistics.bytes_written, _file.size());
+    const std::vector<std::uint8_t> _length = { 0x00, 0x00, 0x00, static_cast<std::uint8_t>(_track.size()) };
+    EXPECT_TRUE(std::equal(_length.begin(), _length.end(), _file.begin() + 18));
+    EXPECT_TRUE(std::equal(_track.begin(), _track.end(), _file.begin() + 22));
+
+    const expected_event _expected[] = {
+        { 0, 0, 0, 0xFF, 0x51, 0x07 },
+        { 0, 0, 0, 0x90, 0x00, 0x3C },
+        { 240, 250000, 0, 0x90, 0x00, 0x3E },
+        { 480, 500000, 0, 0xF0, 0x00, 0x7E },
+        { 720, 750000, 0, 0x90, 0x00, 0x3C },
+        { 720, 750000, 0, 0xFF, 0x2F, 0x00 }
+    };
+    midi_file_reader _reader;
+    midi_file_event _event;
+    std::vector<std::uint8_t> _encoded;
+    ASSERT_TRUE(_reader.open(_path));
+    EXPECT_EQ(_reader.format(), 0);
+    EXPECT_EQ(_reader.tracks(), 1);
+    EXPECT_EQ(_reader.division(), 480);
+    for (const expected_event& _next : _expected) {
+        ASSERT_TRUE(_reader.next(_event));
+        EXPECT_EQ(_event.tick, _next.tick);
+        EXPECT_EQ(_event.time.count(), _next.time);
+        EXPECT_EQ(_event.status, _next.status);
+        EXPECT_EQ(_event.meta_type, _next.meta_type);
+        if (_event.size != 0) {
+            EXPECT_EQ(_event.data[0], _next.first);
+        }
+        _event.encode(_encoded);
+    }
+    EXPECT_FALSE(_reader.next(_event));
+    const std::vector<std::uint8_t> _wire = { 0x90, 0x3C, 0x64, 0x90, 0x3E, 0x64, 0xF0, 0x7E, 0x7F, 0x06, 0x01, 0xF7, 0x90, 0x3C, 0x00 };
+    EXPECT_EQ(_encoded, _wire);
+    _reader.close();
+    std::remove(_path.c_str());
+}
+
+TEST(gtest_midi_file_reader_codec, recorder_drops_beyond_chunk)
+{
+    const std::string _path = testing::TempDir() + "midispec_recorder_drops.mid";
+    const std::chrono::steady_clock::time_point _origin = std::chrono::steady_clock::now();
+    midi_file_recorder _recorder;
+    ASSERT_TRUE(_recorder.open(_path, _origin, 480, 500000, 32));
+
+    // a message larger than the chunk never fits, the next message carries its time
+    std::vector<std::uint8_t> _sysex(40, 0x00);
+    _sysex.front() = 0xF0;
+    _sysex.back() = 0xF7;
+    _recorder.record(_sysex, _origin + std::chrono::milliseconds(250));
+    _recorder.record({ 0x90, 0x3C, 0x64 }, _origin + std::chrono::milliseconds(500));
+    _recorder.close();
+    const midi_file_recorder_statistics _statistics = _recorder.statistics();
+    EXPECT_EQ(_statistics.events_recorded, 1u);
+    EXPECT_EQ(_statistics.events_dropped, 1u);
+
+    midi_file_reader _reader;
+    midi_file_event _event;
+    ASSERT_TRUE(_reader.open(_path));
+    ASSERT_TRUE(_reader.next(_event));
+    EXPECT_EQ(_event.status, 0xFF);
+    ASSERT_TRUE(_reader.next(_event));
+    EXPECT_EQ(_event.status, 0x90);
+    EXPECT_EQ(_event.tick, 480u);
+    ASSERT_TRUE(_reader.next(_event));
+    EXPECT_EQ(_event.meta_type, 0x2F);
+    EXPECT_FALSE(_reader.next(_event));
+    _reader.close();
+    std::remove(_path.c_str());
+}
+
+}
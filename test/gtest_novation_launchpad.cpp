@@ -1,3 +1,5 @@
+#include <limits>
+
 #include <midispec/core/hardware.hpp>
 #include <midispec/novation_launchpad.hpp>
 
@@ -8,6 +10,28 @@ struct gtest_novation_launchpad : public gtest_hardware {};
 TEST_F(gtest_novation_launchpad, no_test_to_run)
 {
 }
+
+// codec tests run without hardware
+
+TEST(gtest_novation_launchpad_codec, quantize_out_of_range)
+{
+    // pixels beyond [0, 1] are clamped, including values too large for an int and NaN
+    const std::vector<float> _pixels = { 0.f, 1.f, 2.f, -1.f, 1e30f, -1e30f, std::numeric_limits<float>::infinity(), std::numeric_limits<float>::quiet_NaN() };
+    std::vector<float> _rgb(64 * 3, 0.f);
+    for (std::size_t _index = 0; _index < _pixels.size(); ++_index) {
+        _rgb[_index * 3] = _pixels[_index];
+        _rgb[_index * 3 + 1] = _pixels[_index];
+    }
+    for (const novation_launchpad::led_dithering _dithering : { novation_launchpad::led_dithering::none, novation_launchpad::led_dithering::ordered }) {
+        std::vector<novation_launchpad::led_frame> _frames;
+        novation_launchpad::quantize_rgb_frames(_rgb, _dithering, _frames);
+        ASSERT_EQ(_frames.size(), 1u);
+        const std::uint8_t _expected[] = { 0x00, 0x33, 0x33, 0x00, 0x33, 0x00, 0x33, 0x00 };
+        for (std::size_t _index = 0; _index < _pixels.size(); ++_index) {
+            EXPECT_EQ(_frames[0].grid[0][_index], _expected[_index]) << _index;
+        }
+    }
+}
 }
 
 int main(int argc, char** argv)
@@ -1,4 +1,13 @@
+#include <algorithm>
+#include <future>
+#include <limits>
+
+#include <midispec/core/device_discovery.hpp>
 #include <midispec/core/hardware.hpp>
+#include <midispec/core/led_animation.hpp>
+#include <midispec/core/message_split.hpp>
+#include <midispec/core/midi_router.hpp>
+#include <midispec/akai_mpx8.hpp>
 #include <midispec/novation_launchpads.hpp>
 
 namespace midispec {
@@ -26,6 +35,344 @@ TEST_F(gtest_novation_launchpads, universal_inquiry)
     EXPECT_EQ(_received_model, 0);
     // when tested version == 0
 }
+
+// codec tests run without hardware
+
+TEST(gtest_novation_launchpads_codec, universal_inquiry_reply)
+{
+    const std::vector<std::uint8_t> _encoded = { 0xF0, 0x7E, 0x00, 0x06, 0x02, 0x00, 0x20, 0x29, 0x20, 0x00, 0x00, 0x00, 0x00, 0x01, 0x02, 0x03, 0xF7 };
+    integral<std::uint8_t, 0, 127> _received_device;
+    std::uint32_t _received_manufacturer;
+    std::uint32_t _received_family;
+    std::uint32_t _received_model;
+    std::uint32_t _received_version;
+
+    EXPECT_TRUE(novation_launchpads::decode_universal_inquiry(_encoded, _received_device, _received_manufacturer, _received_family, _received_model, _received_version));
+    EXPECT_EQ(_received_device, 0);
+    EXPECT_EQ(_received_manufacturer, 8233);
+    EXPECT_EQ(_received_family, 32);
+    EXPECT_EQ(_received_model, 0);
+    EXPECT_EQ(_received_version, 0x00010203);
+
+    std::vector<std::uint8_t> _truncated(_encoded.begin(), _encoded.begin() + 14);
+    _truncated.push_back(0xF7);
+    EXPECT_EQ(novation_launchpads::decode_universal_inquiry(_truncated, _received_device, _received_manufacturer, _received_family, _received_model, _received_version).error(), decode_error::size);
+    std::vector<std::uint8_t> _request;
+    novation_launchpads::encode_universal_inquiry_request(_request, 0x7F);
+    EXPECT_EQ(novation_launchpads::decode_universal_inquiry(_request, _received_device, _received_manufacturer, _received_family, _received_model, _received_version).error(), decode_error::size);
+}
+
+TEST(gtest_novation_launchpads_codec, discovery_reply)
+{
+    device_discovery<akai_mpx8, novation_launchpads> _discovery;
+    _discovery.identify<novation_launchpads>(0x002029, 32, 0);
+
+    EXPECT_TRUE(_discovery.receive(1, { 0xF0, 0x7E, 0x05, 0x06, 0x02, 0x00, 0x20, 0x29, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF7 }));
+    EXPECT_FALSE(_discovery.receive(1, { 0x90, 0x3C, 0x7F }));
+    const std::vector<discovered_device> _devices = _discovery.wait(std::chrono::milliseconds(0));
+    ASSERT_EQ(_devices.size(), 1);
+    EXPECT_EQ(_devices[0].port, 1);
+    EXPECT_EQ(_devices[0].device, 5);
+    EXPECT_EQ(_devices[0].manufacturer, 0x002029);
+    EXPECT_EQ(_devices[0].hardware, (device_discovery<akai_mpx8, novation_launchpads>::index_of<novation_launchpads>()));
+}
+
+TEST(gtest_novation_launchpads_codec, discovery_blocked_port)
+{
+    device_discovery<akai_mpx8, novation_launchpads> _discovery;
+    const std::vector<std::uint8_t> _reply = { 0xF0, 0x7E, 0x00, 0x06, 0x02, 0x00, 0x20, 0x29, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF7 };
+    const std::vector<device_discovery<akai_mpx8, novation_launchpads>::output> _ports = {
+        [](const std::vector<std::uint8_t>&) { std::this_thread::sleep_for(std::chrono::milliseconds(300)); },
+        [&_discovery, &_reply](const std::vector<std::uint8_t>&) { _discovery.receive(1, _reply); },
+    };
+
+    // a blocked port neither delays start() nor the shared deadline
+    const std::chrono::steady_clock::time_point _start = std::chrono::steady_clock::now();
+    _discovery.start(_ports);
+    const std::vector<discovered_device> _devices = _discovery.wait(std::chrono::milliseconds(100));
+    EXPECT_LT(std::chrono::steady_clock::now() - _start, std::chrono::milliseconds(250));
+    ASSERT_EQ(_devices.size(), 1);
+    EXPECT_EQ(_devices[0].port, 1);
+}
+
+TEST(gtest_novation_launchpads_codec, rapid_led_update_messages)
+{
+    novation_launchpads::led_frame _frame {};
+    std::vector<std::uint8_t> _encoded;
+    novation_launchpads::encode_rapid_led_update(_encoded, _frame);
+    _encoded.push_back(0x92);
+
+    // the truncated trailing message is dropped, every other one is handed over on its own
+    std::vector<std::uint8_t> _message;
+    std::size_t _sent = 0;
+    EXPECT_EQ(split_messages(_encoded, _message, [&_sent](const std::vector<std::uint8_t>& message) {
+        EXPECT_EQ(message.size(), 3);
+        EXPECT_TRUE(message[0] & 0x80);
+        ++_sent;
+    }),
+        _encoded.size() / 3);
+    EXPECT_EQ(_sent, _encoded.size() / 3);
+
+    // data bytes following a channel message get its status byte repeated
+    const std::vector<std::uint8_t> _running = { 0x92, 0x01, 0x02, 0x03, 0x04, 0xF8, 0x05, 0x06 };
+    std::vector<std::vector<std::uint8_t>> _messages;
+    split_messages(_running, _message, [&_messages](const std::vector<std::uint8_t>& message) { _messages.push_back(message); });
+    const std::vector<std::vector<std::uint8_t>> _expected = { { 0x92, 0x01, 0x02 }, { 0x92, 0x03, 0x04 }, { 0xF8 }, { 0x92, 0x05, 0x06 } };
+    EXPECT_EQ(_messages, _expected);
+}
+
+namespace {
+
+    // waits for the animation to flip a count of frames, polling its counters
+    bool wait_flipped(const led_animation<novation_launchpads>& animation, const std::uint64_t frames)
+    {
+        const std::chrono::steady_clock::time_point _deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (animation.statistics().frames_flipped < frames) {
+            if (std::chrono::steady_clock::now() > _deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+}
+
+TEST(gtest_novation_launchpads_codec, led_animation_low_bandwidth)
+{
+    std::mutex _mutex;
+    std::vector<std::vector<std::uint8_t>> _messages;
+    led_animation<novation_launchpads> _animation;
+
+    // 50 bytes per second at 100 frames per second leaves half a byte per tick
+    _animation.start([&_mutex, &_messages](const std::vector<std::uint8_t>& encoded) {
+        std::lock_guard<std::mutex> _lock(_mutex);
+        _messages.push_back(encoded);
+    },
+        100, 50);
+    novation_launchpads::led_frame _frame {};
+    _frame.grid[0][0] = 0x03;
+    _animation.submit(_frame);
+    ASSERT_TRUE(wait_flipped(_animation, 1));
+    _frame.grid[7][7] = 0x30;
+    _animation.submit(_frame);
+    ASSERT_TRUE(wait_flipped(_animation, 2));
+    _animation.stop();
+
+    // each flush of 6 bytes is paid back over 11 ticks before the next one
+    const led_animation_statistics _statistics = _animation.statistics();
+    EXPECT_EQ(_statistics.frames_submitted, 2);
+    EXPECT_GE(_statistics.ticks_throttled, 11);
+    std::lock_guard<std::mutex> _lock(_mutex);
+    const std::vector<std::vector<std::uint8_t>> _expected = {
+        { 0xB0, 0x00, 0x00 }, { 0xB0, 0x00, 0x24 },
+        { 0x90, 0x00, 0x03 }, { 0xB0, 0x00, 0x31 },
+        { 0x90, 0x77, 0x30 }, { 0xB0, 0x00, 0x34 }
+    };
+    EXPECT_EQ(_messages, _expected);
+}
+
+TEST(gtest_novation_launchpads_codec, router_blocked_port)
+{
+    std::promise<void> _entered;
+    std::promise<void> _release;
+    std::shared_future<void> _released = _release.get_future().share();
+    bool _first = true;
+    std::promise<void> _delivered;
+    std::vector<std::vector<std::uint8_t>> _received;
+
+    // the launchpad port blocks in its first write until released, the mpx8 port records what it receives
+    midi_router_port _launchpad;
+    _launchpad.capacity = 2;
+    _launchpad.capabilities = capability_matrix_v<novation_launchpads>;
+    _launchpad.send = [&](const std::vector<std::uint8_t>&) {
+        if (_first) {
+            _first = false;
+            _entered.set_value();
+            _released.wait();
+        }
+    };
+    midi_router_port _mpx8;
+    _mpx8.capabilities = capability_matrix_v<akai_mpx8>;
+    _mpx8.send = [&](const std::vector<std::uint8_t>& encoded) {
+        _received.push_back(encoded);
+        if (_received.size() == 3) {
+            _delivered.set_value();
+        }
+    };
+    midi_router _router;
+    _router.open({ _launchpad, _mpx8 });
+
+    std::vector<std::uint8_t> _encoded;
+    novation_launchpads::encode_note_on(_encoded, 0x00, 0x3C);
+    EXPECT_TRUE(_router.route(0, _encoded));
+    ASSERT_EQ(_entered.get_future().wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    EXPECT_TRUE(_router.route(0, _encoded));
+    EXPECT_TRUE(_router.route(0, _encoded));
+    EXPECT_FALSE(_router.route(0, _encoded));
+
+    // the other port keeps draining while the first one is stalled, and only gets what its hardware can receive
+    const std::vector<std::uint8_t> _note_on = { 0x99, 0x3C, 0x7F };
+    const std::vector<std::uint8_t> _aftertouch = { 0xA9, 0x3C, 0x40 };
+    EXPECT_TRUE(_router.route(1, _note_on, capability_bit(message_of(_note_on), capability::receive)));
+    EXPECT_FALSE(_router.route(1, _aftertouch, capability_bit(message_of(_aftertouch), capability::receive)));
+    EXPECT_TRUE(_router.route(1, { 0x89, 0x3C, 0x00, 0x3E, 0x00 }));
+    ASSERT_EQ(_delivered.get_future().wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    const std::vector<std::vector<std::uint8_t>> _expected = { _note_on, { 0x89, 0x3C, 0x00 }, { 0x89, 0x3E, 0x00 } };
+    EXPECT_EQ(_received, _expected);
+    EXPECT_EQ(_router.statistics(1).rejected, 1u);
+
+    const midi_router_statistics _blocked = _router.statistics(0);
+    EXPECT_EQ(_blocked.depth, 2u);
+    EXPECT_EQ(_blocked.depth_max, 2u);
+    EXPECT_EQ(_blocked.dropped, 1u);
+    EXPECT_EQ(_blocked.sent, 0u);
+    _release.set_value();
+}
+
+TEST(gtest_novation_launchpads_codec, led_framebuffer_changes)
+{
+    novation_launchpads::led_framebuffer _framebuffer {};
+    std::vector<std::uint8_t> _encoded;
+    novation_launchpads::encode_led_framebuffer(_encoded, _framebuffer);
+    EXPECT_TRUE(_encoded.empty());
+
+    // only changed LEDs are sent, in rapid update order whatever order they were drawn in
+    _framebuffer.back.top[2] = 0x3C;
+    _framebuffer.back.side[1] = 0x0F;
+    _framebuffer.back.grid[3][4] = 0x30;
+    novation_launchpads::encode_led_framebuffer(_encoded, _framebuffer);
+    std::vector<std::uint8_t> _expected = { 0x90, 0x34, 0x30, 0x90, 0x18, 0x0F, 0xB0, 0x6A, 0x3C };
+    EXPECT_EQ(_encoded, _expected);
+    EXPECT_EQ(_framebuffer.front.grid[3][4], 0x30);
+
+    _encoded.clear();
+    novation_launchpads::encode_led_framebuffer(_encoded, _framebuffer);
+    EXPECT_TRUE(_encoded.empty());
+
+    // beyond 41 changed LEDs a rapid update of the whole frame is shorter
+    for (std::size_t _index = 0; _index < 42; ++_index) {
+        _framebuffer.back.grid[_index / 8][_index % 8] = 0x33;
+    }
+    novation_launchpads::encode_led_framebuffer(_encoded, _framebuffer);
+    ASSERT_EQ(_encoded.size(), 3u + 40u * 3u);
+    _expected = { 0xB0, 0x00, 0x01, 0x92, 0x33, 0x33 };
+    EXPECT_TRUE(std::equal(_expected.begin(), _expected.end(), _encoded.begin()));
+}
+
+TEST(gtest_novation_launchpads_codec, led_framebuffer_double_buffered)
+{
+    novation_launchpads::led_framebuffer _framebuffer {};
+    _framebuffer.double_buffered = 1;
+    std::vector<std::uint8_t> _encoded;
+
+    // the copy and clear flags are cleared so that only the hidden buffer is written, then the buffers are swapped with copy
+    _framebuffer.back.grid[0][0] = 0x3F;
+    novation_launchpads::encode_led_framebuffer(_encoded, _framebuffer);
+    std::vector<std::uint8_t> _expected = { 0x90, 0x00, 0x33, 0xB0, 0x00, 0x31 };
+    EXPECT_EQ(_encoded, _expected);
+    EXPECT_EQ(_framebuffer.displayed_buffer, 1);
+
+    // flags alone are not a change
+    _encoded.clear();
+    _framebuffer.back.grid[0][0] = 0x33;
+    novation_launchpads::encode_led_framebuffer(_encoded, _framebuffer);
+    EXPECT_TRUE(_encoded.empty());
+    EXPECT_EQ(_framebuffer.displayed_buffer, 1);
+
+    // the displayed buffer flips on every flush
+    _framebuffer.back.grid[0][1] = 0x01;
+    novation_launchpads::encode_led_framebuffer(_encoded, _framebuffer);
+    _expected = { 0x90, 0x01, 0x01, 0xB0, 0x00, 0x34 };
+    EXPECT_EQ(_encoded, _expected);
+    EXPECT_EQ(_framebuffer.displayed_buffer, 0);
+}
+
+TEST(gtest_novation_launchpads_codec, rapid_led_update_order)
+{
+    novation_launchpads::led_frame _frame {};
+    for (std::size_t _index = 0; _index < 64; ++_index) {
+        _frame.grid[_index / 8][_index % 8] = static_cast<std::uint8_t>(_index);
+    }
+    for (std::size_t _index = 0; _index < 8; ++_index) {
+        _frame.side[_index] = static_cast<std::uint8_t>(0x30 + _index);
+        _frame.top[_index] = static_cast<std::uint8_t>(0x20 + _index);
+    }
+    std::vector<std::uint8_t> _encoded;
+    novation_launchpads::encode_rapid_led_update(_encoded, _frame);
+
+    // the X-Y layout resets the cursor, then grid rows, side buttons from top to bottom and top buttons from left to right
+    ASSERT_EQ(_encoded.size(), 3u + 40u * 3u);
+    std::vector<std::uint8_t> _expected = { 0xB0, 0x00, 0x01 };
+    for (std::size_t _index = 0; _index < 64; _index += 2) {
+        _expected.insert(_expected.end(), { 0x92, static_cast<std::uint8_t>(_index), static_cast<std::uint8_t>(_index + 1) });
+    }
+    _expected.insert(_expected.end(), { 0x92, 0x30, 0x31, 0x92, 0x32, 0x33, 0x92, 0x34, 0x35, 0x92, 0x36, 0x37 });
+    _expected.insert(_expected.end(), { 0x92, 0x20, 0x21, 0x92, 0x22, 0x23, 0x92, 0x24, 0x25, 0x92, 0x26, 0x27 });
+    EXPECT_EQ(_encoded, _expected);
+}
+
+TEST(gtest_novation_launchpads_codec, quantize_frames)
+{
+    // one greyscale image and a trailing partial image that is ignored
+    std::vector<std::uint8_t> _grey(64 + 10, 0);
+    _grey[1] = 85;
+    _grey[2] = 128;
+    _grey[3] = 255;
+    std::vector<novation_launchpads::led_frame> _frames;
+    novation_launchpads::quantize_greyscale_frames(_grey, novation_launchpads::led_dithering::none, _frames);
+    ASSERT_EQ(_frames.size(), 1u);
+    EXPECT_EQ(_frames[0].grid[0][0], 0x00);
+    EXPECT_EQ(_frames[0].grid[0][1], 0x11);
+    EXPECT_EQ(_frames[0].grid[0][2], 0x22);
+    EXPECT_EQ(_frames[0].grid[0][3], 0x33);
+    EXPECT_EQ(_frames[0].side[0], 0);
+    EXPECT_EQ(_frames[0].top[0], 0);
+
+    // red and green drive their own LEDs, blue is ignored, frames are appended
+    std::vector<float> _rgb(64 * 3, 0.f);
+    _rgb[0] = 1.f;
+    _rgb[4] = 1.f;
+    _rgb[8] = 1.f;
+    novation_launchpads::quantize_rgb_frames(_rgb, novation_launchpads::led_dithering::none, _frames);
+    ASSERT_EQ(_frames.size(), 2u);
+    EXPECT_EQ(_frames[1].grid[0][0], 0x03);
+    EXPECT_EQ(_frames[1].grid[0][1], 0x30);
+    EXPECT_EQ(_frames[1].grid[0][2], 0x00);
+
+    // half of the Bayer thresholds round a level of 1.5 up
+    _frames.clear();
+    const std::vector<float> _half(64, 0.5f);
+    novation_launchpads::quantize_greyscale_frames(_half, novation_launchpads::led_dithering::ordered, _frames);
+    novation_launchpads::quantize_greyscale_frames(_half, novation_launchpads::led_dithering::error_diffusion, _frames);
+    ASSERT_EQ(_frames.size(), 2u);
+    for (const novation_launchpads::led_frame& _frame : _frames) {
+        std::size_t _total = 0;
+        for (std::size_t _index = 0; _index < 64; ++_index) {
+            const std::uint8_t _color = _frame.grid[_index / 8][_index % 8].value();
+            EXPECT_EQ(_color & 0x0F, _color >> 4);
+            EXPECT_TRUE((_color & 0x0F) == 1 || (_color & 0x0F) == 2);
+            _total += _color & 0x0F;
+        }
+        EXPECT_NEAR(static_cast<double>(_total), 96, 2);
+    }
+}
+
+TEST(gtest_novation_launchpads_codec, quantize_out_of_range)
+{
+    // pixels beyond [0, 1] are clamped, including values too large for an int and NaN
+    const std::vector<float> _pixels = { -1.f, 2.f, 1e30f, -1e30f, std::numeric_limits<float>::infinity(), std::numeric_limits<float>::quiet_NaN() };
+    std::vector<float> _grey(64, 0.f);
+    std::copy(_pixels.begin(), _pixels.end(), _grey.begin());
+    for (const novation_launchpads::led_dithering _dithering : { novation_launchpads::led_dithering::none, novation_launchpads::led_dithering::ordered }) {
+        std::vector<novation_launchpads::led_frame> _frames;
+        novation_launchpads::quantize_greyscale_frames(_grey, _dithering, _frames);
+        ASSERT_EQ(_frames.size(), 1u);
+        const std::uint8_t _expected[] = { 0x00, 0x33, 0x33, 0x00, 0x33, 0x00 };
+        for (std::size_t _index = 0; _index < _pixels.size(); ++_index) {
+            EXPECT_EQ(_frames[0].grid[0][_index], _expected[_index]) << _index;
+        }
+    }
+}
 }
 
 int main(int argc, char** argv)
@@ -1,4 +1,7 @@
+#include <algorithm>
+
 #include <midispec/core/hardware.hpp>
+#include <midispec/core/state_mirror.hpp>
 #include <midispec/yamaha_dx7.hpp>
 
 namespace midispec {
@@ -1484,6 +1487,91 @@ TEST_F(gtest_yamaha_dx7, voice_patch_bank)
     transmit_bank_read_voice(_device, _voice, _voice_data);
     EXPECT_EQ(_data[_voice.value()].voice_name, _voice_data.voice_name);
 }
+
+// codec tests run without hardware
+
+TEST(gtest_yamaha_dx7_codec, state_mirror_sync)
+{
+    state_mirror<yamaha_dx7> _mirror;
+    std::vector<std::vector<std::uint8_t>> _messages;
+    const auto _send = [&_messages](const std::vector<std::uint8_t>& message) { _messages.push_back(message); };
+    EXPECT_FALSE(_mirror.dirty(5));
+    EXPECT_EQ(_mirror.sync(_send), 0u);
+
+    // the hardware state is unknown so the first sync sends a single voice dump
+    _mirror.edit(5, [](yamaha_dx7::voice_patch& data) { data.voice_name = { 'M', 'I', 'R', 'R', 'O', 'R', ' ', ' ', ' ', ' ' }; });
+    EXPECT_TRUE(_mirror.dirty(5));
+    EXPECT_FALSE(_mirror.dirty(4));
+    EXPECT_EQ(_mirror.sync(_send), 163u);
+    EXPECT_FALSE(_mirror.dirty(5));
+    ASSERT_EQ(_messages.size(), 1u);
+    const std::vector<std::uint8_t> _header = { 0xF0, 0x43, 0x05, 0x00, 0x01, 0x1B };
+    EXPECT_TRUE(std::equal(_header.begin(), _header.end(), _messages[0].begin()));
+    EXPECT_EQ(_messages[0].back(), 0xF7);
+    EXPECT_EQ(_mirror.sync(_send), 0u);
+
+    // a single edit is sent as one voice parameter change, parameter 134 spanning the group byte
+    _messages.clear();
+    _mirror.edit(5, [](yamaha_dx7::voice_patch& data) { data.algorithm_mode = 21; });
+    EXPECT_EQ(_mirror.sync(_send), 7u);
+    const std::vector<std::vector<std::uint8_t>> _expected = { { 0xF0, 0x43, 0x15, 0x01, 0x06, 21, 0xF7 } };
+    EXPECT_EQ(_messages, _expected);
+
+    // 24 changes cost more than a dump, so the full voice is sent instead
+    _messages.clear();
+    _mirror.edit(5, [](yamaha_dx7::voice_patch& data) {
+        for (std::size_t _op = 0; _op < 6; ++_op) {
+            data.op_envelope_generator_rate_1[_op] = 10;
+            data.op_envelope_generator_rate_2[_op] = 20;
+            data.op_envelope_generator_rate_3[_op] = 30;
+            data.op_envelope_generator_rate_4[_op] = 40;
+        }
+    });
+    EXPECT_EQ(_mirror.sync(_send), 163u);
+    EXPECT_EQ(_messages.size(), 1u);
+
+    const state_mirror_statistics _statistics = _mirror.statistics();
+    EXPECT_EQ(_statistics.syncs, 3u);
+    EXPECT_EQ(_statistics.full_dumps, 2u);
+    EXPECT_EQ(_statistics.parameter_changes, 1u);
+    EXPECT_EQ(_statistics.bytes_sent, 163u + 7u + 163u);
+}
+
+TEST(gtest_yamaha_dx7_codec, state_mirror_assume)
+{
+    state_mirror<yamaha_dx7> _mirror;
+    std::vector<std::vector<std::uint8_t>> _messages;
+    const auto _send = [&_messages](const std::vector<std::uint8_t>& message) { _messages.push_back(message); };
+
+    // the DX7 only transmits banks, so single voice dumps are never merged
+    std::vector<std::uint8_t> _encoded;
+    yamaha_dx7::voice_patch _voice = {};
+    yamaha_dx7::encode_voice_patch(_encoded, 2, _voice);
+    EXPECT_FALSE(_mirror.receive(_encoded));
+    EXPECT_EQ(_mirror.statistics().dumps_received, 0u);
+
+    // a patch decoded from a bank becomes the known state, and edits made before it are kept
+    _mirror.edit(2, [](yamaha_dx7::voice_patch& data) { data.lfo_speed = 42; });
+    _voice.lfo_speed = 7;
+    _voice.lfo_delay = 8;
+    _mirror.assume(2, _voice);
+    EXPECT_TRUE(_mirror.dirty(2));
+    EXPECT_EQ(_mirror.get(2).lfo_speed, 42);
+    EXPECT_EQ(_mirror.get(2).lfo_delay, 0);
+    EXPECT_EQ(_mirror.sync(_send), 14u);
+    const std::vector<std::vector<std::uint8_t>> _expected = {
+        { 0xF0, 0x43, 0x12, 0x01, 0x09, 42, 0xF7 },
+        { 0xF0, 0x43, 0x12, 0x01, 0x0A, 0, 0xF7 },
+    };
+    EXPECT_EQ(_messages, _expected);
+
+    // without pending edits the known state replaces the edit buffer
+    _voice.lfo_speed = 42;
+    _mirror.assume(2, _voice);
+    EXPECT_FALSE(_mirror.dirty(2));
+    EXPECT_EQ(_mirror.get(2).lfo_delay, 8);
+    EXPECT_EQ(_mirror.statistics().full_dumps, 0u);
+}
 }
 
 int main(int argc, char** argv)
@@ -1,4 +1,13 @@
+#include <cmath>
+#include <random>
+#include <thread>
+
 #include <midispec/core/hardware.hpp>
+#include <midispec/core/microtuning.hpp>
+#include <midispec/core/state_mirror.hpp>
+#include <midispec/core/sysex_archive.hpp>
+#include <midispec/core/voice_allocator.hpp>
+#include <midispec/core/yamaha_tx81z_backup.hpp>
 #include <midispec/yamaha_tx81z.hpp>
 
 namespace midispec {
@@ -8,6 +17,729 @@ struct gtest_yamaha_tx81z : public gtest_hardware {};
 TEST_F(gtest_yamaha_tx81z, no_test_to_run)
 {
 }
+
+// codec tests run without hardware
+
+namespace {
+
+    // op_enable_mask is not part of the voice formats and keeps its default
+    yamaha_tx81z::voice_patch random_voice_patch(std::mt19937& random)
+    {
+        yamaha_tx81z::voice_patch _data;
+        for (std::size_t _op = 0; _op < 4; ++_op) {
+            _data.op_attack_rate[_op] = integral<std::uint8_t, 0, 31>::from_random(random);
+            _data.op_decay_rate_1[_op] = integral<std::uint8_t, 0, 31>::from_random(random);
+            _data.op_decay_rate_2[_op] = integral<std::uint8_t, 0, 31>::from_random(random);
+            _data.op_release_rate[_op] = integral<std::uint8_t, 0, 14>::from_random(random);
+            _data.op_decay_level_1[_op] = integral<std::uint8_t, 0, 15>::from_random(random);
+            _data.op_level_scaling[_op] = integral<std::uint8_t, 0, 99>::from_random(random);
+            _data.op_rate_scaling[_op] = integral<std::uint8_t, 0, 3>::from_random(random);
+            _data.op_envelope_generator_bias_sensitivity[_op] = integral<std::uint8_t, 0, 7>::from_random(random);
+            _data.op_amplitude_modulation_enable[_op] = integral<std::uint8_t, 0, 1>::from_random(random);
+            _data.op_key_velocity_sensitivity[_op] = integral<std::uint8_t, 0, 7>::from_random(random);
+            _data.op_output_level[_op] = integral<std::uint8_t, 0, 99>::from_random(random);
+            _data.op_frequency[_op] = integral<std::uint8_t, 0, 63>::from_random(random);
+            _data.op_detune[_op] = integral<std::uint8_t, 0, 6, 3>::from_random(random);
+            _data.op_fixed_frequency[_op] = integral<std::uint8_t, 0, 1>::from_random(random);
+            _data.op_fixed_frequency_range[_op] = integral<std::uint8_t, 0, 7>::from_random(random);
+            _data.op_frequency_range_fine[_op] = integral<std::uint8_t, 0, 15>::from_random(random);
+            _data.op_waveform[_op] = integral<std::uint8_t, 0, 7>::from_random(random);
+            _data.op_envelope_generator_shift[_op] = integral<std::uint8_t, 0, 3>::from_random(random);
+        }
+        _data.algorithm_mode = integral<std::uint8_t, 0, 7>::from_random(random);
+        _data.algorithm_feedback = integral<std::uint8_t, 0, 7>::from_random(random);
+        _data.lfo_speed = integral<std::uint8_t, 0, 99>::from_random(random);
+        _data.lfo_delay = integral<std::uint8_t, 0, 99>::from_random(random);
+        _data.pitch_modulation_depth = integral<std::uint8_t, 0, 99>::from_random(random);
+        _data.amplitude_modulation_depth = integral<std::uint8_t, 0, 99>::from_random(random);
+        _data.lfo_sync = integral<std::uint8_t, 0, 1>::from_random(random);
+        _data.lfo_wave = integral<std::uint8_t, 0, 3>::from_random(random);
+        _data.pitch_modulation_sensitivity = integral<std::uint8_t, 0, 7>::from_random(random);
+        _data.amplitude_modulation_sensitivity = integral<std::uint8_t, 0, 3>::from_random(random);
+        _data.transpose = integral<std::uint8_t, 0, 48, 24>::from_random(random);
+        _data.poly_mono = integral<std::uint8_t, 0, 1>::from_random(random);
+        _data.pitchbend_range = integral<std::uint8_t, 0, 12>::from_random(random);
+        _data.portamento_mode = integral<std::uint8_t, 0, 1>::from_random(random);
+        _data.portamento_time = integral<std::uint8_t, 0, 99>::from_random(random);
+        _data.foot_controller_volume = integral<std::uint8_t, 0, 99>::from_random(random);
+        _data.sustain = integral<std::uint8_t, 0, 1>::from_random(random);
+        _data.portamento = integral<std::uint8_t, 0, 1>::from_random(random);
+        _data.chorus = integral<std::uint8_t, 0, 1>::from_random(random);
+        _data.modulation_wheel_pitch = integral<std::uint8_t, 0, 99>::from_random(random);
+        _data.modulation_wheel_amplitude = integral<std::uint8_t, 0, 99>::from_random(random);
+        _data.breath_controller_pitch = integral<std::uint8_t, 0, 99>::from_random(random);
+        _data.breath_controller_amplitude = integral<std::uint8_t, 0, 99>::from_random(random);
+        _data.breath_controller_pitch_bias = integral<std::uint8_t, 0, 99, 50>::from_random(random);
+        _data.breath_controller_envelope_generator_bias = integral<std::uint8_t, 0, 99>::from_random(random);
+        _data.reverb_rate = integral<std::uint8_t, 0, 7>::from_random(random);
+        _data.foot_controller_pitch = integral<std::uint8_t, 0, 99>::from_random(random);
+        _data.foot_controller_amplitude = integral<std::uint8_t, 0, 99>::from_random(random);
+        for (std::size_t _char_index = 0; _char_index < _data.voice_name.size(); ++_char_index) {
+            _data.voice_name[_char_index] = static_cast<char>(std::uniform_int_distribution<int>(' ', '~')(random));
+        }
+        return _data;
+    }
+
+    void expect_voice_patch_eq(const yamaha_tx81z::voice_patch& decoded, const yamaha_tx81z::voice_patch& expected)
+    {
+        for (std::size_t _op = 0; _op < 4; ++_op) {
+            EXPECT_EQ(decoded.op_attack_rate[_op], expected.op_attack_rate[_op]);
+            EXPECT_EQ(decoded.op_decay_rate_1[_op], expected.op_decay_rate_1[_op]);
+            EXPECT_EQ(decoded.op_decay_rate_2[_op], expected.op_decay_rate_2[_op]);
+            EXPECT_EQ(decoded.op_release_rate[_op], expected.op_release_rate[_op]);
+            EXPECT_EQ(decoded.op_decay_level_1[_op], expected.op_decay_level_1[_op]);
+            EXPECT_EQ(decoded.op_level_scaling[_op], expected.op_level_scaling[_op]);
+            EXPECT_EQ(decoded.op_rate_scaling[_op], expected.op_rate_scaling[_op]);
+            EXPECT_EQ(decoded.op_envelope_generator_bias_sensitivity[_op], expected.op_envelope_generator_bias_sensitivity[_op]);
+            EXPECT_EQ(decoded.op_amplitude_modulation_enable[_op], expected.op_amplitude_modulation_enable[_op]);
+            EXPECT_EQ(decoded.op_key_velocity_sensitivity[_op], expected.op_key_velocity_sensitivity[_op]);
+            EXPECT_EQ(decoded.op_output_level[_op], expected.op_output_level[_op]);
+            EXPECT_EQ(decoded.op_frequency[_op], expected.op_frequency[_op]);
+            EXPECT_EQ(decoded.op_detune[_op], expected.op_detune[_op]);
+            EXPECT_EQ(decoded.op_fixed_frequency[_op], expected.op_fixed_frequency[_op]);
+            EXPECT_EQ(decoded.op_fixed_frequency_range[_op], expected.op_fixed_frequency_range[_op]);
+            EXPECT_EQ(decoded.op_frequency_range_fine[_op], expected.op_frequency_range_fine[_op]);
+            EXPECT_EQ(decoded.op_waveform[_op], expected.op_waveform[_op]);
+            EXPECT_EQ(decoded.op_envelope_generator_shift[_op], expected.op_envelope_generator_shift[_op]);
+        }
+        EXPECT_EQ(decoded.algorithm_mode, expected.algorithm_mode);
+        EXPECT_EQ(decoded.algorithm_feedback, expected.algorithm_feedback);
+        EXPECT_EQ(decoded.lfo_speed, expected.lfo_speed);
+        EXPECT_EQ(decoded.lfo_delay, expected.lfo_delay);
+        EXPECT_EQ(decoded.pitch_modulation_depth, expected.pitch_modulation_depth);
+        EXPECT_EQ(decoded.amplitude_modulation_depth, expected.amplitude_modulation_depth);
+        EXPECT_EQ(decoded.lfo_sync, expected.lfo_sync);
+        EXPECT_EQ(decoded.lfo_wave, expected.lfo_wave);
+        EXPECT_EQ(decoded.pitch_modulation_sensitivity, expected.pitch_modulation_sensitivity);
+        EXPECT_EQ(decoded.amplitude_modulation_sensitivity, expected.amplitude_modulation_sensitivity);
+        EXPECT_EQ(decoded.transpose, expected.transpose);
+        EXPECT_EQ(decoded.poly_mono, expected.poly_mono);
+        EXPECT_EQ(decoded.pitchbend_range, expected.pitchbend_range);
+        EXPECT_EQ(decoded.portamento_mode, expected.portamento_mode);
+        EXPECT_EQ(decoded.portamento_time, expected.portamento_time);
+        EXPECT_EQ(decoded.foot_controller_volume, expected.foot_controller_volume);
+        EXPECT_EQ(decoded.sustain, expected.sustain);
+        EXPECT_EQ(decoded.portamento, expected.portamento);
+        EXPECT_EQ(decoded.chorus, expected.chorus);
+        EXPECT_EQ(decoded.modulation_wheel_pitch, expected.modulation_wheel_pitch);
+        EXPECT_EQ(decoded.modulation_wheel_amplitude, expected.modulation_wheel_amplitude);
+        EXPECT_EQ(decoded.breath_controller_pitch, expected.breath_controller_pitch);
+        EXPECT_EQ(decoded.breath_controller_amplitude, expected.breath_controller_amplitude);
+        EXPECT_EQ(decoded.breath_controller_pitch_bias, expected.breath_controller_pitch_bias);
+        EXPECT_EQ(decoded.breath_controller_envelope_generator_bias, expected.breath_controller_envelope_generator_bias);
+        EXPECT_EQ(decoded.reverb_rate, expected.reverb_rate);
+        EXPECT_EQ(decoded.foot_controller_pitch, expected.foot_controller_pitch);
+        EXPECT_EQ(decoded.foot_controller_amplitude, expected.foot_controller_amplitude);
+        EXPECT_EQ(decoded.voice_name, expected.voice_name);
+    }
+
+    // recomputes the checksum of a bulk dump frame after a data byte was modified
+    void reseal(std::vector<std::uint8_t>& encoded, const std::size_t data_start, const std::size_t data_size)
+    {
+        std::uint32_t _sum = 0;
+        for (std::size_t _index = 0; _index < data_size; ++_index) {
+            _sum += encoded[data_start + _index];
+        }
+        encoded[data_start + data_size] = (128 - (_sum & 0x7F)) & 0x7F;
+    }
+
+    // performance with every instrument disabled but the ones set up by the test
+    yamaha_tx81z::performance_patch instrument_performance()
+    {
+        yamaha_tx81z::performance_patch _performance = {};
+        for (std::size_t _index = 0; _index < voice_allocator::instruments; ++_index) {
+            _performance.inst_maximum_notes[_index] = 0;
+            _performance.inst_low_note_limit[_index] = 0;
+            _performance.inst_high_note_limit[_index] = 127;
+        }
+        return _performance;
+    }
+
+    // builds a dump frame in the ACED format with a header and zeroed parameters, for the sections without an encoder yet
+    std::vector<std::uint8_t> header_frame(const std::uint8_t device, const char* header, const std::size_t parameters)
+    {
+        const std::size_t _size = 10 + parameters;
+        std::vector<std::uint8_t> _encoded = { 0xF0, 0x43, device, 0x7E, static_cast<std::uint8_t>(_size >> 7), static_cast<std::uint8_t>(_size & 0x7F) };
+        _encoded.insert(_encoded.end(), header, header + 10);
+        _encoded.resize(6 + _size + 2, 0x00);
+        _encoded.back() = 0xF7;
+        reseal(_encoded, 6, _size);
+        return _encoded;
+    }
+}
+
+TEST(gtest_yamaha_tx81z_codec, voice_patch_round_trip)
+{
+    std::mt19937 _random(81);
+    for (int _iteration = 0; _iteration < 64; ++_iteration) {
+        const yamaha_tx81z::voice_patch _voice = random_voice_patch(_random);
+        std::vector<std::uint8_t> _encoded;
+        yamaha_tx81z::encode_voice_patch(_encoded, 5, _voice);
+        // ACED frame followed by the VCED frame
+        ASSERT_EQ(_encoded.size(), (6 + 10 + 23 + 2) + (6 + 93 + 2));
+
+        integral<std::uint8_t, 0, 15> _device;
+        yamaha_tx81z::voice_patch _decoded;
+        EXPECT_TRUE(yamaha_tx81z::decode_voice_patch(_encoded, _device, _decoded));
+        EXPECT_EQ(_device, 5);
+        expect_voice_patch_eq(_decoded, _voice);
+    }
+}
+
+TEST(gtest_yamaha_tx81z_codec, voice_patch_rejections)
+{
+    std::mt19937 _random(82);
+    const yamaha_tx81z::voice_patch _voice = random_voice_patch(_random);
+    std::vector<std::uint8_t> _encoded;
+    yamaha_tx81z::encode_voice_patch(_encoded, 0, _voice);
+    integral<std::uint8_t, 0, 15> _device;
+    yamaha_tx81z::voice_patch _decoded = _voice;
+
+    std::vector<std::uint8_t> _corrupted = _encoded;
+    _corrupted[41 + 6 + 20] ^= 0x01;
+    EXPECT_EQ(yamaha_tx81z::decode_voice_patch(_corrupted, _device, _decoded).error(), decode_error::checksum);
+    _corrupted = _encoded;
+    _corrupted[6 + 10 + 3] ^= 0x01;
+    EXPECT_EQ(yamaha_tx81z::decode_voice_patch(_corrupted, _device, _decoded).error(), decode_error::checksum);
+
+    // output level of the first VCED operator above its range of [0, 99]
+    _corrupted = _encoded;
+    _corrupted[41 + 6 + 10] = 120;
+    reseal(_corrupted, 41 + 6, 93);
+    EXPECT_EQ(yamaha_tx81z::decode_voice_patch(_corrupted, _device, _decoded).error(), decode_error::range);
+    expect_voice_patch_eq(_decoded, _voice);
+
+    _corrupted.assign(_encoded.begin(), _encoded.end() - 1);
+    EXPECT_EQ(yamaha_tx81z::decode_voice_patch(_corrupted, _device, _decoded).error(), decode_error::size);
+}
+
+TEST(gtest_yamaha_tx81z_codec, bank_round_trip)
+{
+    std::mt19937 _random(83);
+    std::array<yamaha_tx81z::voice_patch, 32> _bank;
+    for (yamaha_tx81z::voice_patch& _voice : _bank) {
+        _voice = random_voice_patch(_random);
+    }
+    std::vector<std::uint8_t> _encoded;
+    yamaha_tx81z::encode_bank(_encoded, 3, _bank);
+    ASSERT_EQ(_encoded.size(), 6 + 4096 + 2);
+
+    integral<std::uint8_t, 0, 15> _device;
+    std::array<yamaha_tx81z::voice_patch, 32> _decoded;
+    EXPECT_TRUE(yamaha_tx81z::decode_bank(_encoded, _device, _decoded));
+    EXPECT_EQ(_device, 3);
+    for (std::size_t _voice_index = 0; _voice_index < 32; ++_voice_index) {
+        expect_voice_patch_eq(_decoded[_voice_index], _bank[_voice_index]);
+    }
+
+    _encoded[6 + 17 * 128 + 41] ^= 0x01;
+    EXPECT_EQ(yamaha_tx81z::decode_bank(_encoded, _device, _decoded).error(), decode_error::checksum);
+}
+
+TEST(gtest_yamaha_tx81z_codec, microtune_round_trip)
+{
+    std::mt19937 _random(84);
+    yamaha_tx81z::microtune_octave_patch _octave;
+    for (std::size_t _key = 0; _key < 12; ++_key) {
+        _octave.key_note[_key] = integral<std::uint8_t, 13, 108>::from_random(_random);
+        _octave.key_fine[_key] = integral<std::uint8_t, 0, 63>::from_random(_random);
+    }
+    yamaha_tx81z::microtune_patch _keyboard;
+    for (std::size_t _key = 0; _key < 128; ++_key) {
+        _keyboard.key_note[_key] = integral<std::uint8_t, 13, 108>::from_random(_random);
+        _keyboard.key_fine[_key] = integral<std::uint8_t, 0, 63>::from_random(_random);
+    }
+    integral<std::uint8_t, 0, 15> _device;
+
+    std::vector<std::uint8_t> _encoded;
+    yamaha_tx81z::encode_microtune_octave_patch(_encoded, 7, _octave);
+    ASSERT_EQ(_encoded.size(), 42);
+    yamaha_tx81z::microtune_octave_patch _decoded_octave;
+    EXPECT_TRUE(yamaha_tx81z::decode_microtune_octave_patch(_encoded, _device, _decoded_octave));
+    EXPECT_EQ(_device, 7);
+    EXPECT_EQ(_decoded_octave.key_note, _octave.key_note);
+    EXPECT_EQ(_decoded_octave.key_fine, _octave.key_fine);
+    _encoded[6 + 10 + 5] ^= 0x01;
+    EXPECT_EQ(yamaha_tx81z::decode_microtune_octave_patch(_encoded, _device, _decoded_octave).error(), decode_error::checksum);
+
+    _encoded.clear();
+    yamaha_tx81z::encode_microtune_patch(_encoded, 2, _keyboard);
+    ASSERT_EQ(_encoded.size(), 274);
+    yamaha_tx81z::microtune_patch _decoded_keyboard;
+    EXPECT_TRUE(yamaha_tx81z::decode_microtune_patch(_encoded, _device, _decoded_keyboard));
+    EXPECT_EQ(_device, 2);
+    EXPECT_EQ(_decoded_keyboard.key_note, _keyboard.key_note);
+    EXPECT_EQ(_decoded_keyboard.key_fine, _keyboard.key_fine);
+    EXPECT_EQ(yamaha_tx81z::decode_microtune_octave_patch(_encoded, _device, _decoded_octave).error(), decode_error::header);
+
+    // note below the lowest key of the hardware
+    _encoded[6 + 10] = 12;
+    reseal(_encoded, 6, 10 + 256);
+    EXPECT_EQ(yamaha_tx81z::decode_microtune_patch(_encoded, _device, _decoded_keyboard).error(), decode_error::range);
+    EXPECT_EQ(_decoded_keyboard.key_note, _keyboard.key_note);
+}
+
+TEST(gtest_yamaha_tx81z_codec, backup_pipeline)
+{
+    std::mt19937 _random(126);
+    yamaha_tx81z::voice_patch _voice = random_voice_patch(_random);
+    std::array<yamaha_tx81z::voice_patch, 32> _bank;
+    for (yamaha_tx81z::voice_patch& _patch : _bank) {
+        _patch = random_voice_patch(_random);
+    }
+    yamaha_tx81z::microtune_patch _keyboard;
+    for (std::size_t _key = 0; _key < 128; ++_key) {
+        _keyboard.key_note[_key] = integral<std::uint8_t, 13, 108>::from_random(_random);
+        _keyboard.key_fine[_key] = integral<std::uint8_t, 0, 63>::from_random(_random);
+    }
+
+    dump_pipeline _pipeline;
+    yamaha_tx81z_backup _backup;
+    add_backup_requests(_pipeline, 3, _backup);
+    std::size_t _requests = 0;
+    _pipeline.start([&_requests](const std::vector<std::uint8_t>& encoded) {
+        EXPECT_EQ(encoded.front(), 0xF0);
+        EXPECT_EQ(encoded[2], 0x23);
+        EXPECT_EQ(encoded.back(), 0xF7);
+        ++_requests;
+    });
+    EXPECT_EQ(_requests, 7);
+
+    // answers arrive in any order, a frame from another device matches nothing
+    std::vector<std::uint8_t> _encoded;
+    yamaha_tx81z::encode_bank(_encoded, 3, _bank);
+    EXPECT_TRUE(_pipeline.receive(_encoded));
+    _encoded.clear();
+    yamaha_tx81z::encode_voice_patch(_encoded, 4, _voice);
+    EXPECT_FALSE(_pipeline.receive(_encoded));
+    _encoded.clear();
+    yamaha_tx81z::encode_microtune_patch(_encoded, 3, _keyboard);
+    EXPECT_TRUE(_pipeline.receive(_encoded));
+    const std::vector<std::uint8_t> _effect = header_frame(3, "LM  8976S2", 24);
+    EXPECT_TRUE(_pipeline.receive(_effect));
+    const std::vector<std::uint8_t> _performance = header_frame(3, "LM  8976PE", 110);
+    EXPECT_TRUE(_pipeline.receive(_performance));
+    _encoded.clear();
+    yamaha_tx81z::encode_voice_patch(_encoded, 3, _voice);
+    EXPECT_TRUE(_pipeline.receive(std::vector<std::uint8_t>(_encoded.begin(), _encoded.begin() + 41)));
+    EXPECT_TRUE(_pipeline.receive(std::vector<std::uint8_t>(_encoded.begin() + 41, _encoded.end())));
+    const std::vector<std::uint8_t> _system = header_frame(3, "LM  8976S0", 27);
+    EXPECT_TRUE(_pipeline.receive(_system));
+    const std::vector<std::uint8_t> _program_change = header_frame(3, "LM  8976S1", 256);
+    EXPECT_TRUE(_pipeline.receive(_program_change));
+
+    ASSERT_TRUE(_pipeline.wait(std::chrono::milliseconds(1000)));
+    _pipeline.stop();
+    const dump_pipeline_statistics _statistics = _pipeline.statistics();
+    EXPECT_EQ(_statistics.frames_matched, 8);
+    EXPECT_EQ(_statistics.frames_unmatched, 1);
+    EXPECT_EQ(_statistics.dumps_decoded, 7);
+    expect_voice_patch_eq(_backup.voice, _voice);
+    for (std::size_t _voice_index = 0; _voice_index < 32; ++_voice_index) {
+        expect_voice_patch_eq(_backup.bank[_voice_index], _bank[_voice_index]);
+    }
+    EXPECT_EQ(_backup.microtune.key_note, _keyboard.key_note);
+    EXPECT_EQ(_backup.microtune.key_fine, _keyboard.key_fine);
+    EXPECT_EQ(_backup.performance_frame, _performance);
+    EXPECT_EQ(_backup.system_frame, _system);
+    EXPECT_EQ(_backup.effect_frame, _effect);
+    EXPECT_EQ(_backup.program_change_frame, _program_change);
+}
+
+TEST(gtest_yamaha_tx81z_codec, archive_interleaved_realtime)
+{
+    std::mt19937 _random(35);
+    yamaha_tx81z::microtune_patch _keyboard;
+    for (std::size_t _key = 0; _key < 128; ++_key) {
+        _keyboard.key_note[_key] = integral<std::uint8_t, 13, 108>::from_random(_random);
+        _keyboard.key_fine[_key] = integral<std::uint8_t, 0, 63>::from_random(_random);
+    }
+    const yamaha_tx81z::voice_patch _voice = random_voice_patch(_random);
+
+    // a capture with clock bytes interleaved in the header and in the data of the microtune dump
+    std::vector<std::uint8_t> _capture;
+    yamaha_tx81z::encode_microtune_patch(_capture, 5, _keyboard);
+    _capture.insert(_capture.begin() + 100, 0xF8);
+    _capture.insert(_capture.begin() + 1, 0xF8);
+    _capture.push_back(0xFE);
+    yamaha_tx81z::encode_voice_patch(_capture, 5, _voice);
+
+    sysex_archive _archive;
+    _archive.open(_capture.data(), _capture.size());
+    ASSERT_EQ(_archive.frames().size(), 3);
+    EXPECT_EQ(_archive.skipped(), 0);
+    const sysex_frame& _microtune = _archive.frames()[0];
+    EXPECT_TRUE(_microtune.interleaved);
+    EXPECT_EQ(_microtune.size, 276);
+    EXPECT_EQ(_microtune.manufacturer, 0x43);
+    EXPECT_EQ(_microtune.device, 0x05);
+    EXPECT_EQ(_microtune.format, 0x7E);
+    EXPECT_FALSE(_archive.frames()[1].interleaved);
+    EXPECT_FALSE(_archive.frames()[2].interleaved);
+
+    std::vector<std::uint8_t> _encoded;
+    _microtune.copy(_encoded);
+    ASSERT_EQ(_encoded.size(), 274);
+    integral<std::uint8_t, 0, 15> _device;
+    yamaha_tx81z::microtune_patch _decoded;
+    EXPECT_TRUE(yamaha_tx81z::decode_microtune_patch(_encoded, _device, _decoded));
+    EXPECT_EQ(_device, 5);
+    EXPECT_EQ(_decoded.key_note, _keyboard.key_note);
+    EXPECT_EQ(_decoded.key_fine, _keyboard.key_fine);
+
+    // the voice dump spans two frames that decode once concatenated
+    std::vector<std::uint8_t> _frame;
+    _archive.frames()[1].copy(_encoded);
+    _archive.frames()[2].copy(_frame);
+    _encoded.insert(_encoded.end(), _frame.begin(), _frame.end());
+    yamaha_tx81z::voice_patch _decoded_voice;
+    EXPECT_TRUE(yamaha_tx81z::decode_voice_patch(_encoded, _device, _decoded_voice));
+    expect_voice_patch_eq(_decoded_voice, _voice);
+}
+
+TEST(gtest_yamaha_tx81z_codec, state_mirror_sync)
+{
+    std::mt19937 _random(39);
+    state_mirror<yamaha_tx81z> _mirror;
+    std::vector<std::vector<std::uint8_t>> _messages;
+    const auto _send = [&_messages](const std::vector<std::uint8_t>& message) { _messages.push_back(message); };
+    EXPECT_FALSE(_mirror.dirty(5));
+    EXPECT_EQ(_mirror.sync(_send), 0u);
+    EXPECT_TRUE(_messages.empty());
+
+    // the hardware state is unknown so the first sync sends the ACED and VCED frames
+    const yamaha_tx81z::voice_patch _voice = random_voice_patch(_random);
+    _mirror.edit(5, [&_voice](yamaha_tx81z::voice_patch& data) { data = _voice; });
+    EXPECT_TRUE(_mirror.dirty(5));
+    EXPECT_FALSE(_mirror.dirty(4));
+    EXPECT_EQ(_mirror.sync(_send), 142u);
+    EXPECT_FALSE(_mirror.dirty(5));
+    ASSERT_EQ(_messages.size(), 2u);
+    EXPECT_EQ(_messages[0].size(), 41u);
+    EXPECT_EQ(_messages[1].size(), 101u);
+    std::vector<std::uint8_t> _encoded = _messages[0];
+    _encoded.insert(_encoded.end(), _messages[1].begin(), _messages[1].end());
+    integral<std::uint8_t, 0, 15> _device;
+    yamaha_tx81z::voice_patch _decoded;
+    EXPECT_TRUE(yamaha_tx81z::decode_voice_patch(_encoded, _device, _decoded));
+    EXPECT_EQ(_device, 5);
+    expect_voice_patch_eq(_decoded, _voice);
+    EXPECT_EQ(_mirror.sync(_send), 0u);
+
+    // a single edit is sent as one VCED parameter change
+    _messages.clear();
+    _mirror.edit(5, [](yamaha_tx81z::voice_patch& data) { data.algorithm_mode = data.algorithm_mode.value() == 0 ? 1 : 0; });
+    EXPECT_EQ(_mirror.sync(_send), 7u);
+    ASSERT_EQ(_messages.size(), 1u);
+    const std::vector<std::uint8_t> _expected = { 0xF0, 0x43, 0x15, 0x12, 52, _mirror.get(5).algorithm_mode.value(), 0xF7 };
+    EXPECT_EQ(_messages[0], _expected);
+
+    // an edit of an ACED parameter is sent in its own group
+    _messages.clear();
+    _mirror.edit(5, [](yamaha_tx81z::voice_patch& data) { data.reverb_rate = data.reverb_rate.value() == 0 ? 1 : 0; });
+    EXPECT_EQ(_mirror.sync(_send), 7u);
+    ASSERT_EQ(_messages.size(), 1u);
+    EXPECT_EQ(_messages[0][3], 0x13);
+
+    // changing most parameters costs more than a dump, so the full voice is sent instead
+    _messages.clear();
+    yamaha_tx81z::voice_patch _other = _voice;
+    for (std::size_t _op = 0; _op < 4; ++_op) {
+        _other.op_output_level[_op] = _voice.op_output_level[_op].value() == 0 ? 1 : 0;
+        _other.op_attack_rate[_op] = _voice.op_attack_rate[_op].value() == 0 ? 1 : 0;
+        _other.op_decay_rate_1[_op] = _voice.op_decay_rate_1[_op].value() == 0 ? 1 : 0;
+        _other.op_decay_rate_2[_op] = _voice.op_decay_rate_2[_op].value() == 0 ? 1 : 0;
+        _other.op_frequency[_op] = _voice.op_frequency[_op].value() == 0 ? 1 : 0;
+        _other.op_level_scaling[_op] = _voice.op_level_scaling[_op].value() == 0 ? 1 : 0;
+    }
+    _mirror.edit(5, [&_other](yamaha_tx81z::voice_patch& data) { data = _other; });
+    EXPECT_EQ(_mirror.sync(_send), 142u);
+    EXPECT_EQ(_messages.size(), 2u);
+
+    const state_mirror_statistics _statistics = _mirror.statistics();
+    EXPECT_EQ(_statistics.syncs, 4u);
+    EXPECT_EQ(_statistics.full_dumps, 2u);
+    EXPECT_EQ(_statistics.parameter_changes, 2u);
+    EXPECT_EQ(_statistics.bytes_sent, 142u + 7u + 7u + 142u);
+}
+
+TEST(gtest_yamaha_tx81z_codec, state_mirror_receive)
+{
+    std::mt19937 _random(139);
+    state_mirror<yamaha_tx81z> _mirror;
+    std::vector<std::vector<std::uint8_t>> _messages;
+    const auto _send = [&_messages](const std::vector<std::uint8_t>& message) { _messages.push_back(message); };
+    const yamaha_tx81z::voice_patch _known = random_voice_patch(_random);
+    const yamaha_tx81z::voice_patch _dumped = random_voice_patch(_random);
+    std::vector<std::uint8_t> _encoded;
+    EXPECT_FALSE(_mirror.receive(_encoded));
+
+    // a full dump replaces the known state and leaves the device clean
+    yamaha_tx81z::encode_voice_patch(_encoded, 3, _known);
+    EXPECT_TRUE(_mirror.receive(_encoded));
+    EXPECT_FALSE(_mirror.dirty(3));
+    expect_voice_patch_eq(_mirror.get(3), _known);
+    EXPECT_EQ(_mirror.sync(_send), 0u);
+
+    // a VCED dump alone keeps the ACED parameters known for the device
+    _encoded.clear();
+    yamaha_tx81z::encode_voice_patch(_encoded, 3, _dumped);
+    _encoded.erase(_encoded.begin(), _encoded.begin() + 41);
+    EXPECT_TRUE(_mirror.receive(_encoded));
+    yamaha_tx81z::voice_patch _merged = _dumped;
+    _merged.op_fixed_frequency = _known.op_fixed_frequency;
+    _merged.op_fixed_frequency_range = _known.op_fixed_frequency_range;
+    _merged.op_frequency_range_fine = _known.op_frequency_range_fine;
+    _merged.op_waveform = _known.op_waveform;
+    _merged.op_envelope_generator_shift = _known.op_envelope_generator_shift;
+    _merged.reverb_rate = _known.reverb_rate;
+    _merged.foot_controller_pitch = _known.foot_controller_pitch;
+    _merged.foot_controller_amplitude = _known.foot_controller_amplitude;
+    expect_voice_patch_eq(_mirror.get(3), _merged);
+
+    // pending edits survive a dump and are sent as changes against it
+    _mirror.edit(3, [](yamaha_tx81z::voice_patch& data) { data.lfo_speed = data.lfo_speed.value() == 0 ? 1 : 0; });
+    const std::uint8_t _lfo_speed = _mirror.get(3).lfo_speed.value();
+    _encoded.clear();
+    yamaha_tx81z::encode_voice_patch(_encoded, 3, _merged);
+    EXPECT_TRUE(_mirror.receive(_encoded));
+    EXPECT_TRUE(_mirror.dirty(3));
+    EXPECT_EQ(_mirror.get(3).lfo_speed, _lfo_speed);
+    EXPECT_EQ(_mirror.sync(_send), 7u);
+    ASSERT_EQ(_messages.size(), 1u);
+    EXPECT_EQ(_messages[0][3], 0x12);
+    EXPECT_EQ(_messages[0][5], _lfo_speed);
+    EXPECT_EQ(_mirror.statistics().dumps_received, 3u);
+}
+
+TEST(gtest_yamaha_tx81z_codec, state_mirror_concurrent_sync)
+{
+    state_mirror<yamaha_tx81z> _mirror;
+    std::mutex _messages_mutex;
+    std::vector<std::vector<std::uint8_t>> _messages;
+    const auto _send = [&](const std::vector<std::uint8_t>& message) {
+        // a slow output widens the window where another sync could reuse the buffers being sent
+        std::this_thread::yield();
+        std::lock_guard<std::mutex> _lock(_messages_mutex);
+        _messages.push_back(message);
+    };
+    std::vector<std::thread> _threads;
+    for (std::uint8_t _device = 0; _device < 4; ++_device) {
+        _threads.emplace_back([&, _device]() {
+            for (std::uint8_t _value = 0; _value < 100; ++_value) {
+                _mirror.edit(_device, [_value](yamaha_tx81z::voice_patch& data) { data.lfo_speed = _value; });
+                _mirror.sync(_send);
+            }
+        });
+    }
+    for (std::thread& _thread : _threads) {
+        _thread.join();
+    }
+
+    // every message is sent whole, and the last value of every device reaches the hardware last
+    std::array<std::uint8_t, 4> _last = {};
+    for (const std::vector<std::uint8_t>& _message : _messages) {
+        ASSERT_GE(_message.size(), 7u);
+        EXPECT_EQ(_message.front(), 0xF0);
+        EXPECT_EQ(_message.back(), 0xF7);
+        if (_message.size() == 7) {
+            EXPECT_EQ(_message[4], 54);
+            _last[_message[2] & 0x0F] = _message[5];
+        }
+    }
+    for (std::uint8_t _device = 0; _device < 4; ++_device) {
+        EXPECT_EQ(_last[_device], 99);
+    }
+}
+
+TEST(gtest_yamaha_tx81z_codec, voice_allocator_stealing)
+{
+    yamaha_tx81z::performance_patch _performance = instrument_performance();
+    _performance.inst_maximum_notes[0] = 2;
+    _performance.inst_receive_channel[0] = 0;
+    voice_allocator _allocator(_performance);
+    std::vector<std::uint8_t> _encoded;
+
+    // the oldest note is released before the note that does not fit
+    EXPECT_TRUE(_allocator.note_on(_encoded, 0, 60, 100));
+    EXPECT_TRUE(_allocator.note_on(_encoded, 0, 62, 100));
+    EXPECT_TRUE(_allocator.note_on(_encoded, 0, 64, 100));
+    std::vector<std::uint8_t> _expected = { 0x90, 0x3C, 0x64, 0x90, 0x3E, 0x64, 0x80, 0x3C, 0x00, 0x90, 0x40, 0x64 };
+    EXPECT_EQ(_encoded, _expected);
+    EXPECT_EQ(_allocator.sounding(0), 2u);
+
+    // the note off of the stolen note is suppressed, so that it cannot cut a later note on the same key
+    _encoded.clear();
+    EXPECT_FALSE(_allocator.note_off(_encoded, 0, 60));
+    EXPECT_TRUE(_encoded.empty());
+    EXPECT_TRUE(_allocator.note_off(_encoded, 0, 62));
+    _expected = { 0x80, 0x3E, 0x00 };
+    EXPECT_EQ(_encoded, _expected);
+
+    // a note already sounding is released and retriggered without stealing
+    _encoded.clear();
+    EXPECT_TRUE(_allocator.note_on(_encoded, 0, 64, 90));
+    _expected = { 0x80, 0x40, 0x00, 0x90, 0x40, 0x5A };
+    EXPECT_EQ(_encoded, _expected);
+    EXPECT_EQ(_allocator.sounding(0), 1u);
+
+    const voice_allocator_statistics _statistics = _allocator.statistics();
+    EXPECT_EQ(_statistics.note_ons, 4u);
+    EXPECT_EQ(_statistics.note_offs, 3u);
+    EXPECT_EQ(_statistics.stolen, 1u);
+    EXPECT_EQ(_statistics.orphans, 1u);
+    EXPECT_EQ(_statistics.unrouted, 0u);
+}
+
+TEST(gtest_yamaha_tx81z_codec, voice_allocator_omni)
+{
+    yamaha_tx81z::performance_patch _performance = instrument_performance();
+    _performance.inst_maximum_notes[0] = 4;
+    _performance.inst_receive_channel[0] = 2;
+    _performance.inst_maximum_notes[1] = 1;
+    _performance.inst_receive_channel[1] = voice_allocator::omni;
+    voice_allocator _allocator(_performance);
+    std::vector<std::uint8_t> _encoded;
+
+    // the omni instrument plays every channel, the other one its own channel only
+    EXPECT_TRUE(_allocator.note_on(_encoded, 5, 60, 100));
+    EXPECT_EQ(_allocator.sounding(0), 0u);
+    EXPECT_EQ(_allocator.sounding(1), 1u);
+    EXPECT_TRUE(_allocator.note_on(_encoded, 2, 62, 100));
+    EXPECT_EQ(_allocator.sounding(0), 1u);
+    EXPECT_EQ(_allocator.sounding(1), 1u);
+    std::vector<std::uint8_t> _expected = { 0x95, 0x3C, 0x64, 0x85, 0x3C, 0x00, 0x92, 0x3E, 0x64 };
+    EXPECT_EQ(_encoded, _expected);
+
+    _encoded.clear();
+    _allocator.release(_encoded);
+    _expected = { 0x82, 0x3E, 0x00 };
+    EXPECT_EQ(_encoded, _expected);
+    EXPECT_EQ(_allocator.sounding(0), 0u);
+    EXPECT_EQ(_allocator.sounding(1), 0u);
+    EXPECT_EQ(_allocator.statistics().stolen, 1u);
+}
+
+TEST(gtest_yamaha_tx81z_codec, voice_allocator_note_limits)
+{
+    yamaha_tx81z::performance_patch _performance = instrument_performance();
+    _performance.inst_maximum_notes[0] = 4;
+    _performance.inst_receive_channel[0] = 0;
+    _performance.inst_high_note_limit[0] = 59;
+    _performance.inst_maximum_notes[1] = 1;
+    _performance.inst_receive_channel[1] = 0;
+    _performance.inst_low_note_limit[1] = 60;
+    voice_allocator _allocator(_performance);
+    std::vector<std::uint8_t> _encoded;
+
+    // a keyboard split, stealing only happens in the upper instrument
+    EXPECT_TRUE(_allocator.note_on(_encoded, 0, 48, 100));
+    EXPECT_TRUE(_allocator.note_on(_encoded, 0, 50, 100));
+    EXPECT_TRUE(_allocator.note_on(_encoded, 0, 72, 100));
+    EXPECT_TRUE(_allocator.note_on(_encoded, 0, 74, 100));
+    const std::vector<std::uint8_t> _expected = { 0x90, 0x30, 0x64, 0x90, 0x32, 0x64, 0x90, 0x48, 0x64, 0x80, 0x48, 0x00, 0x90, 0x4A, 0x64 };
+    EXPECT_EQ(_encoded, _expected);
+    EXPECT_EQ(_allocator.sounding(0), 2u);
+    EXPECT_EQ(_allocator.sounding(1), 1u);
+
+    // no instrument receives channel 3, and disabled instruments play nothing
+    _encoded.clear();
+    EXPECT_FALSE(_allocator.note_on(_encoded, 3, 60, 100));
+    EXPECT_TRUE(_encoded.empty());
+    _allocator.configure(instrument_performance());
+    EXPECT_EQ(_allocator.sounding(0), 0u);
+    EXPECT_FALSE(_allocator.note_on(_encoded, 0, 60, 100));
+    EXPECT_TRUE(_encoded.empty());
+    EXPECT_EQ(_allocator.statistics().unrouted, 2u);
+}
+
+TEST(gtest_yamaha_tx81z_codec, microtuning_parse_scala)
+{
+    const std::string _equal = "! 12tet.scl\n!\n12 tone equal temperament\n 12\n!\n"
+                               " 100.0\n 200.0\n 300.0\n 400.0\n 500.0\n 600.0\n 700.0\n 800.0\n 900.0\n 1000.0\n 1100.0\n 2/1\n";
+    std::vector<double> _degrees;
+    ASSERT_TRUE(microtuning::parse_scala(_equal, _degrees));
+    ASSERT_EQ(_degrees.size(), 12u);
+    EXPECT_DOUBLE_EQ(_degrees.back(), 1200);
+
+    // a 12 tone equal temperament scale gives the same table as equal_temperament()
+    const microtuning::table _tuned = microtuning::tune(_degrees);
+    const microtuning::table _expected = microtuning::equal_temperament();
+    EXPECT_EQ(_tuned.key_note, _expected.key_note);
+    EXPECT_EQ(_tuned.key_fine, _expected.key_fine);
+
+    ASSERT_TRUE(microtuning::parse_scala("fifth\n2\n3/2\n2\n", _degrees));
+    ASSERT_EQ(_degrees.size(), 2u);
+    EXPECT_NEAR(_degrees[0], 701.955, 0.001);
+    EXPECT_DOUBLE_EQ(_degrees[1], 1200);
+
+    EXPECT_FALSE(microtuning::parse_scala("", _degrees));
+    EXPECT_FALSE(microtuning::parse_scala("empty\n0\n", _degrees));
+    EXPECT_FALSE(microtuning::parse_scala("short\n3\n100.0\n200.0\n", _degrees));
+    EXPECT_FALSE(microtuning::parse_scala("negative\n1\n-3/2\n", _degrees));
+    EXPECT_FALSE(microtuning::parse_scala("huge\n4294967295\n100.0\n", _degrees));
+    EXPECT_EQ(_degrees.size(), 2u);
+}
+
+TEST(gtest_yamaha_tx81z_codec, microtuning_frequency)
+{
+    const microtuning::table _equal = microtuning::equal_temperament();
+    EXPECT_DOUBLE_EQ(microtuning::frequency(_equal, 69), 440);
+    EXPECT_NEAR(microtuning::frequency(_equal, 60), 261.6256, 0.0001);
+
+    // keys beyond the range of the hardware are clamped to its lowest and highest pitch
+    EXPECT_EQ(_equal.key_note[0], 13);
+    EXPECT_EQ(_equal.key_fine[0], 0);
+    EXPECT_EQ(_equal.key_note[127], 108);
+    EXPECT_EQ(_equal.key_fine[127], 63);
+
+    // a quarter tone scale spreads an octave over 24 keys above the reference
+    std::vector<double> _quarter_tones;
+    for (int _degree = 1; _degree <= 24; ++_degree) {
+        _quarter_tones.push_back(_degree * 50.0);
+    }
+    const microtuning::table _tuned = microtuning::tune(_quarter_tones, 60, 440);
+    EXPECT_DOUBLE_EQ(microtuning::frequency(_tuned, 60), 440);
+    EXPECT_NEAR(microtuning::frequency(_tuned, 84), 880, 0.001);
+    EXPECT_NEAR(microtuning::frequency(_tuned, 61), 440 * std::exp2(1 / 24.0), 0.001);
+    EXPECT_NEAR(microtuning::frequency(_tuned, 36), 220, 0.001);
+}
+
+TEST(gtest_yamaha_tx81z_codec, microtuning_retune)
+{
+    microtuning _tuning;
+    std::vector<double> _degrees = { 90.0, 1200.0 };
+    const std::size_t _equal = _tuning.prepare(5, microtuning::equal_temperament());
+    const std::size_t _copy = _tuning.prepare(5, microtuning::equal_temperament());
+    const std::size_t _other = _tuning.prepare(5, microtuning::tune(_degrees));
+    EXPECT_EQ(_tuning.current(), microtuning::none);
+
+    std::vector<std::uint8_t> _encoded;
+    EXPECT_TRUE(_tuning.retune(_encoded, _equal));
+    ASSERT_EQ(_encoded.size(), 274u);
+    integral<std::uint8_t, 0, 15> _device;
+    microtuning::table _decoded;
+    EXPECT_TRUE(yamaha_tx81z::decode_microtune_patch(_encoded, _device, _decoded));
+    EXPECT_EQ(_device, 5);
+    EXPECT_EQ(_decoded.key_note, microtuning::equal_temperament().key_note);
+
+    // the hardware already holds the table, or an identical one
+    _encoded.clear();
+    EXPECT_FALSE(_tuning.retune(_encoded, _equal));
+    EXPECT_FALSE(_tuning.retune(_encoded, _copy));
+    EXPECT_EQ(_tuning.current(), _copy);
+    EXPECT_TRUE(_encoded.empty());
+
+    EXPECT_TRUE(_tuning.retune(_encoded, _other));
+    EXPECT_EQ(_encoded.size(), 274u);
+    EXPECT_FALSE(_tuning.retune(_encoded, 3));
+    EXPECT_EQ(_tuning.current(), _other);
+
+    // once the held table is unknown the next retune always sends
+    _tuning.assume(microtuning::none);
+    EXPECT_TRUE(_tuning.retune(_encoded, _other));
+    EXPECT_EQ(_encoded.size(), 548u);
+}
 }
 
 int main(int argc, char** argv)
@@ -0,0 +1,43 @@
+#include <cstdio>
+
+#include <midispec/akai_lpk25.hpp>
+#include <midispec/akai_mpx8.hpp>
+#include <midispec/akai_rythmwolf.hpp>
+#include <midispec/core/capability_matrix.hpp>
+#include <midispec/novation_launchpad.hpp>
+#include <midispec/novation_launchpads.hpp>
+#include <midispec/yamaha_dx7.hpp>
+#include <midispec/yamaha_spx90.hpp>
+#include <midispec/yamaha_tx81z.hpp>
+
+namespace {
+
+template <typename Hardware>
+void report(const char* name)
+{
+    constexpr midispec::capability_mask _mask = midispec::capability_matrix_v<Hardware>;
+    std::printf("%s (0x%012llx)\n", name, static_cast<unsigned long long>(_mask));
+    for (std::uint8_t _row = 0; _row < static_cast<std::uint8_t>(midispec::message::system_exclusive); ++_row) {
+        const midispec::message _message = static_cast<midispec::message>(_row);
+        std::printf("    %-20s %-8s %-8s %-8s\n",
+            midispec::message_name(_message),
+            midispec::has_capability(_mask, _message, midispec::capability::receive) ? "receive" : "-",
+            midispec::has_capability(_mask, _message, midispec::capability::request) ? "request" : "-",
+            midispec::has_capability(_mask, _message, midispec::capability::transmit) ? "transmit" : "-");
+    }
+}
+
+}
+
+int main()
+{
+    report<midispec::akai_lpk25>("Akai LPK25");
+    report<midispec::akai_mpx8>("Akai MPX8");
+    report<midispec::akai_rythmwolf>("Akai RythmWolf");
+    report<midispec::novation_launchpad>("Novation Launchpad");
+    report<midispec::novation_launchpads>("Novation Launchpad S");
+    report<midispec::yamaha_dx7>("Yamaha DX7");
+    report<midispec::yamaha_spx90>("Yamaha SPX90");
+    report<midispec::yamaha_tx81z>("Yamaha TX81Z");
+    return 0;
+}
@@ -0,0 +1,273 @@
+#include <RtMidi.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <midispec/akai_mpx8.hpp>
+#include <midispec/core/metrics.hpp>
+#include <midispec/novation_launchpads.hpp>
+
+/// Round trip latency probe. Sends universal inquiry requests one at a time, timestamps the send and the reply with a monotonic clock,
+/// and reports percentiles and histograms of the round trip and of the jitter between consecutive round trips.
+/// With --loopback the requests are answered by an in-process thread instead of a device, measuring host side overhead only
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+struct options {
+    bool loopback = false;
+    unsigned input = 0;
+    unsigned output = 0;
+    std::size_t count = 1000;
+    std::chrono::milliseconds interval = std::chrono::milliseconds(5);
+    std::chrono::milliseconds timeout = std::chrono::milliseconds(1000);
+    std::string hardware = "mpx8";
+};
+
+/// reply slot shared between the input callback and the probing thread
+struct reply {
+    std::mutex mutex;
+    std::condition_variable condition_variable;
+    std::vector<std::uint8_t> accumulated;
+    clock_type::time_point received;
+    bool armed = false;
+    bool ready = false;
+
+    void receive(const std::vector<std::uint8_t>& message)
+    {
+        const clock_type::time_point _now = clock_type::now();
+        {
+            std::lock_guard<std::mutex> _lock(mutex);
+            for (const std::uint8_t _byte : message) {
+                if (_byte == 0xF0) {
+                    accumulated.clear();
+                }
+                if (_byte >= 0xF8) {
+                    continue;
+                }
+                accumulated.push_back(_byte);
+                // universal inquiry replies are F0 7E <device> 06 02 ... F7, only the first one answering the pending request counts
+                if (_byte == 0xF7 && armed && accumulated.size() > 5 && accumulated[1] == 0x7E && accumulated[3] == 0x06 && accumulated[4] == 0x02) {
+                    received = _now;
+                    armed = false;
+                    ready = true;
+                }
+            }
+        }
+        condition_variable.notify_one();
+    }
+};
+
+/// in-process device answering every universal inquiry request from its own thread
+struct loopback {
+    std::function<void(const std::vector<std::uint8_t>&)> output;
+    std::mutex mutex;
+    std::condition_variable condition_variable;
+    std::deque<std::vector<std::uint8_t>> queue;
+    bool stop = false;
+    std::thread thread;
+
+    void open()
+    {
+        thread = std::thread([this] {
+            const std::vector<std::uint8_t> _reply = { 0xF0, 0x7E, 0x00, 0x06, 0x02, 0x47, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF7 };
+            std::unique_lock<std::mutex> _lock(mutex);
+            while (true) {
+                condition_variable.wait(_lock, [this] { return stop || !queue.empty(); });
+                if (stop) {
+                    break;
+                }
+                queue.pop_front();
+                _lock.unlock();
+                output(_reply);
+                _lock.lock();
+            }
+        });
+    }
+
+    void send(const std::vector<std::uint8_t>& encoded)
+    {
+        {
+            std::lock_guard<std::mutex> _lock(mutex);
+            queue.push_back(encoded);
+        }
+        condition_variable.notify_one();
+    }
+
+    void close()
+    {
+        {
+            std::lock_guard<std::mutex> _lock(mutex);
+            stop = true;
+        }
+        condition_variable.notify_one();
+        thread.join();
+    }
+};
+
+bool parse(const int argc, char** argv, options& parsed)
+{
+    for (int _index = 1; _index < argc; ++_index) {
+        const char* _argument = argv[_index];
+        const char* _value = _index + 1 < argc ? argv[_index + 1] : nullptr;
+        if (std::strcmp(_argument, "--loopback") == 0) {
+            parsed.loopback = true;
+            continue;
+        }
+        if (_value == nullptr) {
+            return false;
+        }
+        if (std::strcmp(_argument, "--in") == 0) {
+            parsed.input = static_cast<unsigned>(std::strtoul(_value, nullptr, 10));
+        } else if (std::strcmp(_argument, "--out") == 0) {
+            parsed.output = static_cast<unsigned>(std::strtoul(_value, nullptr, 10));
+        } else if (std::strcmp(_argument, "--count") == 0) {
+            parsed.count = std::strtoul(_value, nullptr, 10);
+        } else if (std::strcmp(_argument, "--interval") == 0) {
+            parsed.interval = std::chrono::milliseconds(std::strtoul(_value, nullptr, 10));
+        } else if (std::strcmp(_argument, "--timeout") == 0) {
+            parsed.timeout = std::chrono::milliseconds(std::strtoul(_value, nullptr, 10));
+        } else if (std::strcmp(_argument, "--hardware") == 0) {
+            parsed.hardware = _value;
+        } else {
+            return false;
+        }
+        ++_index;
+    }
+    return parsed.count > 0 && (parsed.hardware == "mpx8" || parsed.hardware == "launchpads");
+}
+
+/// percentiles are bucket upper bounds, clamped to the largest sample so that they never exceed it
+void print(const char* name, const midispec::metrics_histogram& histogram, const std::uint64_t maximum)
+{
+    std::printf("%s: p50 %.6f ms, p99 %.6f ms, max %.6f ms, mean %.6f ms\n",
+        name,
+        std::min(histogram.percentile(0.5), maximum) / 1e6,
+        std::min(histogram.percentile(0.99), maximum) / 1e6,
+        maximum / 1e6,
+        histogram.count > 0 ? histogram.total / 1e6 / histogram.count : 0.0);
+    std::uint64_t _largest = 0;
+    for (const std::uint64_t _bucket : histogram.buckets) {
+        _largest = std::max(_largest, _bucket);
+    }
+    for (std::size_t _index = 0; _index < midispec::metrics_histogram::size; ++_index) {
+        if (histogram.buckets[_index] == 0) {
+            continue;
+        }
+        const int _width = static_cast<int>(40 * histogram.buckets[_index] / _largest);
+        // bucket bounds are whole nanoseconds, printed exactly so that adjacent buckets never share a label
+        std::printf("    <= %14.6f ms %8llu %.*s\n",
+            midispec::metrics_histogram::highest(_index) / 1e6,
+            static_cast<unsigned long long>(histogram.buckets[_index]),
+            _width > 0 ? _width : 1,
+            "########################################");
+    }
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    options _options;
+    if (!parse(argc, argv, _options)) {
+        std::printf("usage: %s [--loopback] [--in index] [--out index] [--count n] [--interval ms] [--timeout ms] [--hardware mpx8|launchpads]\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<std::uint8_t> _request;
+    if (_options.hardware == "mpx8") {
+        midispec::akai_mpx8::encode_universal_inquiry_request(_request, 0x7F);
+    } else {
+        midispec::novation_launchpads::encode_universal_inquiry_request(_request, 0x7F);
+    }
+
+    reply _reply;
+    loopback _loopback;
+    std::unique_ptr<RtMidiIn> _midi_in;
+    std::unique_ptr<RtMidiOut> _midi_out;
+    std::function<void(const std::vector<std::uint8_t>&)> _send;
+    if (_options.loopback) {
+        _loopback.output = [&_reply](const std::vector<std::uint8_t>& encoded) { _reply.receive(encoded); };
+        _loopback.open();
+        _send = [&_loopback](const std::vector<std::uint8_t>& encoded) { _loopback.send(encoded); };
+        std::printf("Probing in-process loopback\n");
+    } else {
+        _midi_in = std::make_unique<RtMidiIn>();
+        _midi_out = std::make_unique<RtMidiOut>();
+        if (_options.input >= _midi_in->getPortCount() || _options.output >= _midi_out->getPortCount()) {
+            std::printf("Port index out of range, %u inputs and %u outputs available\n", _midi_in->getPortCount(), _midi_out->getPortCount());
+            return 1;
+        }
+        _midi_in->openPort(_options.input);
+        _midi_in->ignoreTypes(false, true, true);
+        _midi_in->setCallback(
+            [](double, std::vector<std::uint8_t>* message, void* user) { static_cast<reply*>(user)->receive(*message); },
+            &_reply);
+        _midi_out->openPort(_options.output);
+        _send = [&_midi_out](const std::vector<std::uint8_t>& encoded) { _midi_out->sendMessage(&encoded); };
+        std::printf("Probing %s through %s -> %s\n", _options.hardware.c_str(), _midi_out->getPortName(_options.output).c_str(), _midi_in->getPortName(_options.input).c_str());
+    }
+
+    midispec::metrics_histogram _round_trip;
+    midispec::metrics_histogram _jitter;
+    std::uint64_t _round_trip_max = 0;
+    std::uint64_t _jitter_max = 0;
+    std::uint64_t _previous = 0;
+    std::size_t _timeouts = 0;
+    for (std::size_t _probe = 0; _probe < _options.count; ++_probe) {
+        {
+            std::lock_guard<std::mutex> _lock(_reply.mutex);
+            _reply.armed = true;
+            _reply.ready = false;
+            _reply.accumulated.clear();
+        }
+        const clock_type::time_point _sent = clock_type::now();
+        _send(_request);
+        std::unique_lock<std::mutex> _lock(_reply.mutex);
+        if (!_reply.condition_variable.wait_for(_lock, _options.timeout, [&_reply] { return _reply.ready; })) {
+            // a late reply is ignored rather than counted for the next probe, and another timeout window is waited out for it
+            _reply.armed = false;
+            _lock.unlock();
+            ++_timeouts;
+            std::this_thread::sleep_for(_options.timeout);
+            continue;
+        }
+        const std::uint64_t _elapsed = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(_reply.received - _sent).count());
+        _lock.unlock();
+
+        ++_round_trip.buckets[midispec::metrics_histogram::bucket(_elapsed)];
+        ++_round_trip.count;
+        _round_trip.total += _elapsed;
+        _round_trip_max = std::max(_round_trip_max, _elapsed);
+        if (_round_trip.count > 1) {
+            const std::uint64_t _difference = _elapsed > _previous ? _elapsed - _previous : _previous - _elapsed;
+            ++_jitter.buckets[midispec::metrics_histogram::bucket(_difference)];
+            ++_jitter.count;
+            _jitter.total += _difference;
+            _jitter_max = std::max(_jitter_max, _difference);
+        }
+        _previous = _elapsed;
+        std::this_thread::sleep_for(_options.interval);
+    }
+
+    if (_options.loopback) {
+        _loopback.close();
+    }
+
+    std::printf("%llu replies, %zu timeouts\n", static_cast<unsigned long long>(_round_trip.count), _timeouts);
+    print("Round trip", _round_trip, _round_trip_max);
+    print("Jitter", _jitter, _jitter_max);
+    return _round_trip.count > 0 ? 0 : 1;
+}